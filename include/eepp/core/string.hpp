@@ -32,11 +32,29 @@ class EE_API String {
 
 	static const std::size_t InvalidPos; ///< Represents an invalid position in the string
 
-	/** Boyer–Moore–Horspool fast string search. */
+	/** Boyer–Moore–Horspool fast string search.
+	 * When the CPU supports it the searches use SIMD kernels (SSE2 or AVX2, selected at runtime)
+	 * that filter the candidate positions by the first and last bytes of the needle. The scalar
+	 * Boyer–Moore–Horspool implementation is used as fallback. */
 	class EE_API BMH {
 	  public:
 		typedef std::vector<size_t> OccTable;
 
+		enum class Kernel { Scalar, SSE2, AVX2 };
+
+		/** @return The kernel used by the searches. */
+		static Kernel getKernel();
+
+		/** Forces the kernel used by the searches (useful for benchmarking). If the kernel is not
+		 * supported by the CPU the best supported kernel is used instead.
+		 * @return The kernel that will be used. */
+		static Kernel setKernel( Kernel kernel );
+
+		/** @return The best kernel supported by the CPU. */
+		static Kernel getBestKernel();
+
+		static const char* getKernelName( Kernel kernel );
+
 		static const OccTable createOccTable( const unsigned char* needle, size_t needleLength );
 
 		/** @returns haystackLength if not found, otherwise the position */
@@ -44,6 +62,19 @@ class EE_API String {
 							  const unsigned char* needle, const size_t needleLength,
 							  const OccTable& occ );
 
+		/** Creates the occurrence table for a case insensitive search (ASCII case folding).
+		 * The needle must be lowercase. */
+		static const OccTable createCaseInsensitiveOccTable( const unsigned char* needle,
+															 size_t needleLength );
+
+		/** Case insensitive search (ASCII case folding) that does not need to copy nor lowercase
+		 * the haystack. The needle must be lowercase and the occurrence table created with
+		 * createCaseInsensitiveOccTable.
+		 * @returns haystackLength if not found, otherwise the position */
+		static size_t searchCaseInsensitive( const unsigned char* haystack, size_t haystackLength,
+											 const unsigned char* needle,
+											 const size_t needleLength, const OccTable& occ );
+
 		/** @returns -1 if not found otherwise the position */
 		static Int64 find( const std::string& haystack, const std::string& needle,
 						   const size_t& haystackOffset, const OccTable& occ );
@@ -24,6 +24,44 @@ struct VertexData {
 /** @brief A batch rendering class. */
 class EE_API BatchRenderer {
   public:
+	/** The reason that made a batch to be rendered. */
+	enum class FlushReason : Uint32 {
+		Draw,			/// draw() was called
+		ForceRendering, /// Batch force rendering is enabled
+		Texture,		/// The texture or its coordinate type changed
+		BlendMode,		/// The blend mode changed
+		DrawMode,		/// The primitive type changed
+		Batcher,		/// Another batch renderer was flushed and the global batch went first
+		Count
+	};
+
+	/** The batching statistics of all the batch renderers during a frame. They are shared by all
+	 * the batch renderers and not synchronized, so they must only be used from the thread that
+	 * owns the GL context (as the batch renderers themselves). */
+	struct FlushStats {
+		Uint32 flushes{ 0 };
+		Uint64 vertexs{ 0 };
+		/** Batches recorded by the deferred global batch renderer before being merged. */
+		Uint32 deferredCommands{ 0 };
+		Uint32 reasons[static_cast<Uint32>( FlushReason::Count )]{};
+
+		Uint32 getFlushes( const FlushReason& reason ) const {
+			return reasons[static_cast<Uint32>( reason )];
+		}
+	};
+
+	static const char* flushReasonToString( const FlushReason& reason );
+
+	/** @return The batching statistics of the last displayed frame. */
+	static const FlushStats& getLastFrameStats();
+
+	/** @return The batching statistics of the current frame so far. */
+	static const FlushStats& getFrameStats();
+
+	/** Closes the statistics of the current frame (called by the window when a frame is
+	 * displayed). */
+	static void endFrameStats();
+
 	static BatchRenderer* New();
 
 	static BatchRenderer* New( const unsigned int& Prealloc );
@@ -326,7 +364,13 @@ class EE_API BatchRenderer {
 	bool mForceRendering{ false };
 	bool mForceBlendMode{ true };
 
-	void flush();
+	static void countFlush( const FlushReason& reason, const Uint32& numVertex,
+							const Uint32& deferredCommands = 0 );
+
+	virtual void flush( const FlushReason& reason = FlushReason::Draw );
+
+	/** Renders the vertexs with the current texture, blend mode, primitive type and transform. */
+	void render( VertexData* vertexs, const Uint32& numVertex );
 
 	void init();
 
@@ -3,6 +3,7 @@
 
 #include <eepp/graphics/base.hpp>
 #include <eepp/graphics/batchrenderer.hpp>
+#include <vector>
 
 #include <eepp/system/singleton.hpp>
 using namespace EE::System;
@@ -15,10 +16,70 @@ class EE_API GlobalBatchRenderer : public BatchRenderer {
 	SINGLETON_DECLARE_HEADERS( GlobalBatchRenderer )
 
   public:
+	/** A run of batched vertexs that share the same render state. */
+	struct DeferredCommand {
+		const Texture* texture{ nullptr };
+		Texture::CoordinateType coordinateType{ Texture::CoordinateType::Normalized };
+		BlendMode blend{ BlendMode::Alpha() };
+		PrimitiveType mode{ PRIMITIVE_QUADS };
+		Float rotation{ 0.f };
+		Vector2f scale{ 1.f, 1.f };
+		Vector2f position{ 0.f, 0.f };
+		Vector2f center{ 0.f, 0.f };
+		/** First vertex of the command. */
+		Uint32 start{ 0 };
+		Uint32 numVertex{ 0 };
+		/** Screen space bounds of the vertexs (after the batch transform). */
+		Rectf bounds;
+
+		/** @return If both commands can be rendered with the same draw call. */
+		bool sameState( const DeferredCommand& other ) const;
+
+		/** @return If the primitive type allows to concatenate commands (quads and triangles).
+		 * Strips, fans, loops, lines and points are never moved. */
+		bool canMerge() const;
+	};
+
+	/** A set of commands rendered with a single draw call. */
+	struct DeferredGroup {
+		/** The commands indexes, in the order they were recorded. */
+		std::vector<Uint32> commands;
+		Uint32 numVertex{ 0 };
+		Rectf bounds;
+	};
+
+	/** Groups the commands to render with the least number of draw calls and the same output.
+	 * A command joins the last group with its same state if it doesn't overlap any group drawn
+	 * after that one, so two overlapping commands are always drawn in the recorded order.
+	 * @param lookBack Maximum number of groups to look back for a match. */
+	static void groupCommands( const std::vector<DeferredCommand>& commands,
+							   std::vector<DeferredGroup>& groups, const Uint32& lookBack = 64 );
+
 	~GlobalBatchRenderer();
 
+	/** Enables the deferred mode (disabled by default). In deferred mode the texture, blend mode
+	 * and primitive type changes don't render the batch, they record it. The recorded batches are
+	 * reordered and merged when the batch is drawn (every state change external to the batch
+	 * renderer draws the batch: clipping, shaders, frame buffers, and the end of the frame).
+	 * The textures used must not be modified before the batch is drawn. */
+	void setDeferred( bool deferred );
+
+	bool isDeferred() const;
+
   protected:
+	bool mDeferred{ false };
+	Uint32 mCommandStart{ 0 };
+	std::vector<DeferredCommand> mCommands;
+	std::vector<DeferredGroup> mGroups;
+	std::vector<VertexData> mGroupVertex;
+
 	GlobalBatchRenderer();
+
+	virtual void flush( const FlushReason& reason = FlushReason::Draw );
+
+	void recordCommand();
+
+	void renderCommands( const FlushReason& reason );
 };
 
 }} // namespace EE::Graphics
@@ -88,7 +88,7 @@ class EE_API Renderer {
 
 	const char* getString( unsigned int name );
 
-	void drawArrays( unsigned int mode, int first, int count );
+	virtual void drawArrays( unsigned int mode, int first, int count );
 
 	void drawElements( unsigned int mode, int count, unsigned int type, const void* indices );
 
@@ -96,7 +96,7 @@ class EE_API Renderer {
 
 	void activeTexture( unsigned int texture );
 
-	void blendFunc( unsigned int sfactor, unsigned int dfactor );
+	virtual void blendFunc( unsigned int sfactor, unsigned int dfactor );
 
 	void blendFuncSeparate( unsigned int sfactorRGB, unsigned int dfactorRGB,
 							unsigned int sfactorAlpha, unsigned int dfactorAlpha );
@@ -182,6 +182,15 @@ class EE_API Renderer {
 	virtual void texCoordPointer( int size, unsigned int type, int stride, const void* pointer,
 								  unsigned int allocate ) = 0;
 
+	/** Uploads interleaved vertexs (two floats position, two floats texture coordinates and four
+	 * bytes color) to the renderer streaming buffer, and points the vertex, color and texture
+	 * coordinate arrays to them.
+	 * @param texCoordOffset Offset of the texture coordinates in the vertex, -1 if not used.
+	 * @return False if the renderer does not stream vertexs, in that case the arrays must be set
+	 * with vertexPointer, colorPointer and texCoordPointer. */
+	virtual bool streamVertexs( const void* data, unsigned int size, int stride, int texCoordOffset,
+								int colorOffset );
+
 	virtual void setShader( ShaderProgram* Shader );
 
 	virtual void clip2DPlaneEnable( const Int32& x, const Int32& y, const Int32& Width,
@@ -2,6 +2,7 @@
 #define EE_GRAPHICS_CRENDERERGL3CP_HPP
 
 #include <eepp/graphics/renderer/rendererglshader.hpp>
+#include <eepp/graphics/renderer/vertexbufferring.hpp>
 
 #ifdef EE_GL3_ENABLED
 
@@ -46,6 +47,9 @@ class EE_API RendererGL3CP : public RendererGLShader {
 	void texCoordPointer( int size, unsigned int type, int stride, const void* pointer,
 						  unsigned int allocate );
 
+	bool streamVertexs( const void* data, unsigned int size, int stride, int texCoordOffset,
+						int colorOffset );
+
 	void clientActiveTexture( unsigned int texture );
 
 	unsigned int baseShaderId();
@@ -88,6 +92,9 @@ class EE_API RendererGL3CP : public RendererGLShader {
 	unsigned int mCurTexCoordArray;
 	Uint32 mVBOSizeAlloc;
 	Uint32 mBiggestAlloc;
+	/** Interleaved vertexs buffer, written as a ring so batches don't wait for previous draws. */
+	unsigned int mStreamVBO;
+	VertexBufferRing mStreamRing;
 	bool mLoaded;
 	std::string mBaseVertexShader;
 
@@ -96,6 +103,9 @@ class EE_API RendererGL3CP : public RendererGLShader {
 	void reloadShader( ShaderProgram* Shader );
 
 	void allocateBuffers( const Uint32& size );
+
+	void streamAttribPointer( const int& index, int& state, int size, unsigned int type,
+							  bool normalized, int stride, const Uint32& offset );
 };
 
 }} // namespace EE::Graphics
@@ -0,0 +1,49 @@
+#ifndef EE_GRAPHICS_VERTEXBUFFERRING_HPP
+#define EE_GRAPHICS_VERTEXBUFFERRING_HPP
+
+#include <eepp/config.hpp>
+
+namespace EE { namespace Graphics {
+
+/** @brief Sub-allocates the slices of a streaming vertex buffer.
+ * Every batch is written after the previous one, so the GPU can keep reading the previous batches
+ * while the next one is uploaded. When the buffer is full its storage must be orphaned and the
+ * writing starts again from the beginning. It only does the bookkeeping, the renderer applies the
+ * result to the GPU buffer. */
+class EE_API VertexBufferRing {
+  public:
+	struct Slice {
+		/** Offset in bytes of the slice in the buffer. */
+		Uint32 offset{ 0 };
+		/** The buffer storage must be (re)allocated with the current capacity before writing. */
+		bool orphan{ false };
+	};
+
+	explicit VertexBufferRing( const Uint32& capacity, const Uint32& alignment = 16 );
+
+	/** @return Where to write the next size bytes. Grows the capacity if size does not fit in the
+	 * whole buffer. */
+	Slice allocate( const Uint32& size );
+
+	/** Starts writing from the beginning, the next allocation orphans the buffer. */
+	void reset();
+
+	const Uint32& getCapacity() const;
+
+	/** @return The offset of the first free byte. */
+	const Uint32& getOffset() const;
+
+	/** @return The number of times the buffer storage was orphaned. */
+	const Uint32& getOrphanCount() const;
+
+  protected:
+	Uint32 mCapacity;
+	Uint32 mAlignment;
+	Uint32 mOffset{ 0 };
+	Uint32 mOrphanCount{ 0 };
+	bool mNeedsOrphan{ true };
+};
+
+}} // namespace EE::Graphics
+
+#endif
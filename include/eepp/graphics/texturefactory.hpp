@@ -3,11 +3,17 @@
 
 #include <eepp/graphics/base.hpp>
 #include <eepp/graphics/texture.hpp>
+#include <atomic>
+#include <deque>
 #include <list>
+#include <map>
+#include <memory>
 
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/pack.hpp>
 #include <eepp/system/singleton.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <eepp/system/time.hpp>
 using namespace EE::System;
 
 namespace EE { namespace Graphics {
@@ -17,6 +23,37 @@ class EE_API TextureFactory : protected Mutex {
 	SINGLETON_DECLARE_HEADERS( TextureFactory )
 
   public:
+	/** Statistics of the asynchronous texture loads. */
+	struct AsyncLoadStats {
+		/** Number of images decoded by the loader threads. */
+		Uint64 decodedCount{ 0 };
+		/** Size of the encoded images decoded (the file size). */
+		Uint64 decodedBytes{ 0 };
+		/** Accumulated time spent decoding (by all the loader threads). */
+		Time decodeTime{ Time::Zero };
+		/** Number of textures uploaded. */
+		Uint64 uploadedCount{ 0 };
+		/** Size of the textures uploaded. */
+		Uint64 uploadedBytes{ 0 };
+		/** Number of images that couldn't be read or decoded, their textures keep the
+		 * placeholder. */
+		Uint64 failedCount{ 0 };
+		/** Accumulated time spent uploading in the render thread. */
+		Time uploadTime{ Time::Zero };
+		/** Accumulated time from the load request to the texture upload. */
+		Time totalLatency{ Time::Zero };
+		/** Longest time from the load request to the texture upload. */
+		Time maxLatency{ Time::Zero };
+		/** Textures waiting to be decoded or uploaded. */
+		Uint32 pending{ 0 };
+
+		/** @return The decoded bytes per second of a single loader thread. */
+		double getDecodeThroughput() const;
+
+		/** @return The average time from the load request to the texture upload. */
+		Time getAverageLatency() const;
+	};
+
 	/** Creates an empty texture
 	 * @param Width Texture Width
 	 * @param Height Texture Height
@@ -128,6 +165,45 @@ class EE_API TextureFactory : protected Mutex {
 		const bool& CompressTexture = false, const bool& KeepLocalCopy = false,
 		const Image::FormatConfiguration& imageformatConfiguration = Image::FormatConfiguration() );
 
+	/** Loads a texture from a file path without blocking. The image is decoded by the loader
+	 * threads and uploaded by the render thread in processAsyncUploads.
+	 * @return The id of a placeholder texture (1x1 transparent) that is replaced by the image when
+	 * it's uploaded (the texture sends a DrawableResource::Change event). If the texture is removed
+	 * before that, the load is canceled.
+	 * @see loadFromFile for the parameters. */
+	Uint32 loadFromFileAsync(
+		const std::string& Filepath, const bool& Mipmap = false,
+		const Texture::ClampMode& ClampMode = Texture::ClampMode::ClampToEdge,
+		const bool& CompressTexture = false, const bool& KeepLocalCopy = false,
+		const Image::FormatConfiguration& imageformatConfiguration = Image::FormatConfiguration() );
+
+	/** Loads a texture from a pack without blocking.
+	 * @return The id of a placeholder texture.
+	 * @see loadFromFileAsync, loadFromPack */
+	Uint32 loadFromPackAsync(
+		Pack* Pack, const std::string& FilePackPath, const bool& Mipmap = false,
+		const Texture::ClampMode& ClampMode = Texture::ClampMode::ClampToEdge,
+		const bool& CompressTexture = false, const bool& KeepLocalCopy = false,
+		const Image::FormatConfiguration& imageformatConfiguration = Image::FormatConfiguration() );
+
+	/** @return True if the texture is a placeholder waiting to be decoded or uploaded. */
+	bool isLoadingAsync( const Uint32& TexId );
+
+	/** Uploads the decoded textures until the upload budget of the frame is consumed (at least one
+	 * texture is uploaded per call). It must be called from the thread of the GL context, the
+	 * window calls it once per frame. */
+	void processAsyncUploads();
+
+	/** Sets the maximum time and bytes to spend uploading textures per frame.
+	 * By default 4 milliseconds and 16 MiB. */
+	void setAsyncUploadBudget( const Time& timeBudget, const Uint64& bytesBudget );
+
+	/** Sets the thread pool used to decode the images. By default a pool is created with the first
+	 * asynchronous load. */
+	void setAsyncLoaderThreadPool( std::shared_ptr<ThreadPool> pool );
+
+	AsyncLoadStats getAsyncLoadStats();
+
 	/** Removes and Unload the Texture Id
 	 * @param TexId
 	 * @return True if was removed
@@ -239,6 +315,15 @@ class EE_API TextureFactory : protected Mutex {
 						const bool& CompressTexture, const bool& LocalCopy = false,
 						const Uint32& MemSize = 0 );
 
+	/** Replaces the GL texture of an existing texture (keeping its id and file path).
+	 * @return The TexId or 0 if the texture doesn't exist (the GL texture is deleted). */
+	Uint32 replaceTexture( const Uint32& TexId, const Uint32& GLTexId, const unsigned int& Width,
+						   const unsigned int& Height, const unsigned int& ImgWidth,
+						   const unsigned int& ImgHeight, const bool& Mipmap,
+						   const unsigned int& Channels, const Texture::ClampMode& ClampMode,
+						   const bool& CompressTexture, const bool& LocalCopy = false,
+						   const Uint32& MemSize = 0 );
+
 	/** Return a texture by it file path name
 	 * @param Name File path name
 	 * @return The texture, NULL if not exists.
@@ -279,6 +364,31 @@ class EE_API TextureFactory : protected Mutex {
 	const bool& isErasing() const;
 
 	void removeReference( Texture* Tex );
+
+	struct AsyncLoad;
+
+	std::shared_ptr<ThreadPool> mAsyncPool;
+	Mutex mAsyncMutex;
+	std::map<Uint32, std::shared_ptr<AsyncLoad>> mAsyncLoads;
+	std::deque<std::shared_ptr<AsyncLoad>> mAsyncDecoded;
+	std::vector<std::vector<Uint8>> mStagingBuffers;
+	std::atomic<Uint32> mAsyncPending{ 0 };
+	/** Decode tasks queued or running in the thread pool, they must end before the factory is
+	 * destroyed. */
+	std::atomic<Uint32> mAsyncTasks{ 0 };
+	Time mUploadTimeBudget{ Milliseconds( 4 ) };
+	Uint64 mUploadBytesBudget{ 16 * 1024 * 1024 };
+	AsyncLoadStats mAsyncStats;
+
+	Uint32 loadAsync( const std::shared_ptr<AsyncLoad>& load );
+
+	void decodeAsync( const std::shared_ptr<AsyncLoad>& load );
+
+	void cancelAsyncLoad( const Uint32& TexId );
+
+	std::vector<Uint8> getStagingBuffer();
+
+	void releaseStagingBuffer( std::vector<Uint8>&& buffer );
 };
 
 }} // namespace EE::Graphics
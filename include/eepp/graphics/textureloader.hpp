@@ -110,6 +110,17 @@ class EE_API TextureLoader {
 	/** Starts loading the texture */
 	void load();
 
+	/** Decodes the image (the first half of load). It doesn't need the GL context, so it can run in
+	 * any thread. */
+	void decode();
+
+	/** Uploads the decoded image to the GPU and creates the texture (the second half of load). */
+	void upload();
+
+	/** Instead of creating a new texture, the loaded image will replace the texture with the given
+	 * id. If the texture doesn't exist anymore when uploaded the image is discarded. */
+	void setTargetTexture( const Uint32& texId );
+
   protected:
 	Uint32 mLoadType; // From memory, from path, from pack
 	Uint8* mPixels;	  // Texture Info
@@ -139,6 +150,7 @@ class EE_API TextureLoader {
   private:
 	bool mLoaded;
 	bool mTexLoaded;
+	Uint32 mTargetTexId{ 0 };
 	bool mDirectUpload;
 	int mImgType;
 	int mIsCompressed;
@@ -167,6 +167,12 @@ class EE_API VertexBuffer {
 	/** @brief Draw the vertex buffer. */
 	virtual void draw() = 0;
 
+	/** @brief Draw a range of vertices of the vertex buffer, the indices are not used.
+	 *	@param firstVertex The first vertex to draw.
+	 *	@param vertexCount The number of vertices to draw.
+	 */
+	virtual void draw( const Uint32& firstVertex, const Uint32& vertexCount ) = 0;
+
 	/** @brief Compile the vertex buffer.
 	 *	After adding all the vertex buffer data Compile() must be called to upload the data to the
 	 *GPU.
@@ -177,6 +183,14 @@ class EE_API VertexBuffer {
 	 * GPU. */
 	virtual void update( const Uint32& types, bool indices ) = 0;
 
+	/** @brief Reuploads to the GPU only a range of the modified vertices.
+	 *	@param types The vertex flags of the data to upload.
+	 *	@param firstVertex The first vertex modified.
+	 *	@param vertexCount The number of vertices modified.
+	 */
+	virtual void update( const Uint32& types, const Uint32& firstVertex,
+						 const Uint32& vertexCount ) = 0;
+
 	/** @brief Reupload all the data to the GPU. */
 	virtual void reload() = 0;
 
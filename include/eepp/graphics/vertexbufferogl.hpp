@@ -20,10 +20,14 @@ class EE_API VertexBufferOGL : public VertexBuffer {
 
 	void draw();
 
+	void draw( const Uint32& firstVertex, const Uint32& vertexCount );
+
 	bool compile();
 
 	void update( const Uint32& types, bool indices );
 
+	void update( const Uint32& types, const Uint32& firstVertex, const Uint32& vertexCount );
+
 	void reload();
 
 	void unbind();
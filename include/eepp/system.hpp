@@ -14,6 +14,7 @@
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/iostreamdeflate.hpp>
 #include <eepp/system/iostreamfile.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
 #include <eepp/system/iostreaminflate.hpp>
 #include <eepp/system/iostreampak.hpp>
 #include <eepp/system/iostreamstring.hpp>
@@ -24,6 +25,7 @@
 #include <eepp/system/md5.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/pack.hpp>
+#include <eepp/system/packindex.hpp>
 #include <eepp/system/packmanager.hpp>
 #include <eepp/system/pak.hpp>
 #include <eepp/system/process.hpp>
@@ -0,0 +1,77 @@
+#ifndef EE_SYSTEMCIOSTREAMMAPPEDFILE_HPP
+#define EE_SYSTEMCIOSTREAMMAPPEDFILE_HPP
+
+#include <eepp/system/iostream.hpp>
+#include <string>
+
+namespace EE { namespace System {
+
+/** @brief A read-only file stream backed by a memory mapping of the file.
+**	The whole file contents are accessible through getData() without copying. If the platform
+**	does not support memory mapped files (or the mapping fails) the file is read into memory
+**	instead (unless the memory fallback is disabled), so the stream is always usable when isOpen()
+**	returns true. */
+class EE_API IOStreamMappedFile : public IOStream {
+  public:
+	static IOStreamMappedFile* New( const std::string& path, bool memoryFallback = true );
+
+	/** @brief Maps a file from the file system
+	**	@param path File to map from path
+	**	@param memoryFallback Read the file into memory if it can't be mapped. If disabled and the
+	**	file can't be mapped the stream is not open.
+	**/
+	IOStreamMappedFile( const std::string& path, bool memoryFallback = true );
+
+	virtual ~IOStreamMappedFile();
+
+	ios_size read( char* data, ios_size size );
+
+	/** Mapped files are read-only, writing is not supported. */
+	ios_size write( const char* data, ios_size size );
+
+	ios_size seek( ios_size position );
+
+	ios_size tell();
+
+	ios_size getSize();
+
+	bool isOpen();
+
+	/** @brief Reads from an absolute position without modifying the stream position.
+	**	It does not mutate the stream state, so it's safe to call it concurrently from several
+	**	threads.
+	**	@return The number of bytes actually read */
+	ios_size readAt( ios_size position, char* data, ios_size size ) const;
+
+	/** @return The file contents. nullptr if the file couldn't be opened. */
+	const char* getData() const;
+
+	/** @return The file size in bytes */
+	const ios_size& getLength() const;
+
+	/** @return True if the contents are actually memory mapped (false if the contents were read
+	 * into a heap buffer as a fallback) */
+	bool isMapped() const;
+
+	void close();
+
+  protected:
+	const char* mData;
+	ios_size mSize;
+	ios_size mPos;
+	bool mMapped;
+	bool mOpen;
+	char* mBuffer;
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	void* mFile;
+	void* mMapping;
+#endif
+
+	bool map( const std::string& path );
+
+	bool readIntoMemory( const std::string& path );
+};
+
+}} // namespace EE::System
+
+#endif
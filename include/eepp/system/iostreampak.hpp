@@ -36,6 +36,10 @@ class EE_API IOStreamPak : public IOStream {
 
   protected:
 	IOStreamFile* mFile;
+	/** The file contents inside the pak mapping, when reading from a memory mapped pak. */
+	const char* mData;
+	/** Keeps the pak mapping alive while the stream is open. */
+	std::shared_ptr<IOStreamMappedFile> mMappedFile;
 	Pak::pakEntry mEntry;
 	Int32 mPos;
 	bool mOpen;
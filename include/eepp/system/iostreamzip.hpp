@@ -37,6 +37,8 @@ class EE_API IOStreamZip : public IOStream {
   protected:
 	std::string mPath;
 	struct zip* mZip;
+	/** Index of the file in the zip, resolved by the pack index as Zip::exists does. */
+	Int32 mIndex;
 	struct zip_file* mFile;
 	ios_size mPos;
 };
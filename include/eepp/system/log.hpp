@@ -5,7 +5,13 @@
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/singleton.hpp>
 #include <eepp/system/sys.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace EE { namespace System {
@@ -86,6 +92,26 @@ class EE_API Log : protected Mutex {
 	/** @returns A copy of the current writed log. */
 	std::string getBuffer() const;
 
+	/** @return The maximum size in bytes of the log kept in memory. */
+	const size_t& getMaxBufferSize() const;
+
+	/** @brief Sets the maximum size in bytes of the log kept in memory (the buffer), the oldest
+	 * lines are discarded. 0 means unlimited. */
+	void setMaxBufferSize( const size_t& maxBufferSize );
+
+	/** @return If the asynchronous mode is enabled. */
+	bool isAsync() const;
+
+	/** @brief Enables or disables the asynchronous mode.
+	 ** In asynchronous mode the messages are queued in a lock-free ring, and a background thread
+	 ** writes them in batches to the buffer, the readers, the terminal and the file. The readers
+	 ** are called from that thread. Disabling it writes the queued messages. */
+	void setAsync( bool async );
+
+	/** @brief Waits until all the messages queued before the call are written (only in
+	 ** asynchronous mode). */
+	void flush();
+
 	/** @returns If the log Writes are outputed to the terminal. */
 	const bool& isConsoleOutput() const;
 
@@ -103,7 +129,8 @@ class EE_API Log : protected Mutex {
 	*/
 	void addLogReader( LogReaderInterface* reader );
 
-	/** @brief Removes the reader interface */
+	/** @brief Removes the reader interface.
+	**	When it returns the reader is not being called from another thread. */
 	void removeLogReader( LogReaderInterface* reader );
 
 	/** @return The log level threshold. */
@@ -113,6 +140,9 @@ class EE_API Log : protected Mutex {
 	 * logged. */
 	void setLogLevelThreshold( const LogLevel& logLevelThreshold );
 
+	/** @return If a message with the log level will be logged. */
+	bool isLoggable( const LogLevel& level ) const { return level >= mLogLevelThreshold; }
+
 	/** @return The file path of the log file (if any). */
 	const std::string& getFilePath() const;
 
@@ -120,62 +150,82 @@ class EE_API Log : protected Mutex {
 	void setFilePath( const std::string& filePath );
 
 	static void debug( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Debug, text );
+		if ( Log::instance()->isLoggable( LogLevel::Debug ) )
+			Log::instance()->writel( LogLevel::Debug, text );
 	}
 
 	static void info( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Info, text );
+		if ( Log::instance()->isLoggable( LogLevel::Info ) )
+			Log::instance()->writel( LogLevel::Info, text );
 	}
 
 	static void notice( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Notice, text );
+		if ( Log::instance()->isLoggable( LogLevel::Notice ) )
+			Log::instance()->writel( LogLevel::Notice, text );
 	}
 
 	static void warning( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Warning, text );
+		if ( Log::instance()->isLoggable( LogLevel::Warning ) )
+			Log::instance()->writel( LogLevel::Warning, text );
 	}
 
 	static void error( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Error, text );
+		if ( Log::instance()->isLoggable( LogLevel::Error ) )
+			Log::instance()->writel( LogLevel::Error, text );
 	}
 
 	static void critical( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Critical, text );
+		if ( Log::instance()->isLoggable( LogLevel::Critical ) )
+			Log::instance()->writel( LogLevel::Critical, text );
 	}
 
 	static void assertLog( const std::string& text ) {
-		Log::instance()->writel( LogLevel::Assert, text );
+		if ( Log::instance()->isLoggable( LogLevel::Assert ) )
+			Log::instance()->writel( LogLevel::Assert, text );
 	}
 
 	template <class... Args> static void debug( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Debug, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Debug ) )
+			Log::instance()->writef( LogLevel::Debug, format, std::forward<Args>( args )... );
 	}
 
 	template <class... Args> static void info( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Info, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Info ) )
+			Log::instance()->writef( LogLevel::Info, format, std::forward<Args>( args )... );
 	}
 
 	template <class... Args> static void notice( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Notice, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Notice ) )
+			Log::instance()->writef( LogLevel::Notice, format, std::forward<Args>( args )... );
 	}
 
 	template <class... Args> static void warning( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Warning, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Warning ) )
+			Log::instance()->writef( LogLevel::Warning, format, std::forward<Args>( args )... );
 	}
 
 	template <class... Args> static void error( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Error, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Error ) )
+			Log::instance()->writef( LogLevel::Error, format, std::forward<Args>( args )... );
 	}
 
 	template <class... Args> static void critical( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Critical, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Critical ) )
+			Log::instance()->writef( LogLevel::Critical, format, std::forward<Args>( args )... );
 	}
 
 	template <class... Args> static void assertLog( const char* format, Args&&... args ) {
-		Log::instance()->writef( LogLevel::Assert, format, std::forward<Args>( args )... );
+		if ( Log::instance()->isLoggable( LogLevel::Assert ) )
+			Log::instance()->writef( LogLevel::Assert, format, std::forward<Args>( args )... );
 	}
 
   protected:
+	/** A message queued in the ring, the sequence tells if the slot is free or published. */
+	struct Record {
+		std::atomic<size_t> sequence{ 0 };
+		std::string text;
+	};
+
 	Log();
 
 	Log( const std::string& logPath, const LogLevel& level, bool consoleOutput, bool liveWrite );
@@ -188,12 +238,55 @@ class EE_API Log : protected Mutex {
 	LogLevel mLogLevelThreshold{ getDefaultLogLevel() };
 	IOStreamFile* mFS;
 	std::list<LogReaderInterface*> mReaders;
+	size_t mMaxBufferSize{ 4 * 1024 * 1024 };
+	std::atomic<bool> mAsync{ false };
+	std::unique_ptr<Record[]> mRing;
+	size_t mRingMask{ 0 };
+	std::atomic<size_t> mRingHead{ 0 };
+	std::atomic<size_t> mRingTail{ 0 };
+	std::thread mWriterThread;
+	std::thread::id mWriterThreadId;
+	/** Number of threads inside dispatch, so the writer is not stopped while they queue records. */
+	std::atomic<int> mDispatching{ 0 };
+	std::mutex mWriterMutex;
+	std::condition_variable mWriterCondition;
+	std::atomic<bool> mWriterRunning{ false };
+	std::atomic<bool> mWriterSleeping{ false };
+	/** Number of records written by the writer thread, flush waits for it to reach the head. */
+	std::atomic<size_t> mRingWritten{ 0 };
+	/** Tail of the ring when the writer was found stalled with the ring full. */
+	std::atomic<size_t> mStalledTail{ std::numeric_limits<size_t>::max() };
+	std::mutex mFlushMutex;
+	std::condition_variable mFlushCondition;
+	/** Guards the readers list, the readers are called from a copy without holding it. */
+	std::mutex mReadersMutex;
+	std::condition_variable mReadersCondition;
+	/** Number of threads calling the readers, removing a reader waits until it's 0. */
+	int mReadersCalling{ 0 };
 
 	void openFS();
 
 	void closeFS();
 
+	/** The readers are called without any log lock held, so they can lock their own mutexes and
+	 * log. In asynchronous mode they are called from the writer thread. */
 	void writeToReaders( const std::string& text );
+
+	/** Writes the text to the buffer, the readers, the terminal and the file. */
+	void writeRecords( const std::string& text );
+
+	void appendToBuffer( const std::string& text );
+
+	/** Queues the text in asynchronous mode, otherwise it's written immediately. */
+	void dispatch( std::string&& text );
+
+	bool pushRecord( std::string& text );
+
+	bool popRecord( std::string& text );
+
+	void wakeWriter();
+
+	void writerLoop();
 };
 
 }} // namespace EE::System
@@ -1,6 +1,7 @@
 #ifndef EE_SYSTEM_LUAPATTERNMATCHER_HPP
 #define EE_SYSTEM_LUAPATTERNMATCHER_HPP
 
+#include <bitset>
 #include <eepp/config.hpp>
 #include <string>
 #include <vector>
@@ -116,6 +117,18 @@ class EE_API LuaPattern {
 
 	const size_t& getNumMatches() const;
 
+	/** Same as matches but it does not store any state in the pattern, so the same pattern can be
+	 * used concurrently from different threads.
+	 * @return The number of matches (0 if no match was found) */
+	size_t countMatches( const char* stringSearch, int stringStartOffset,
+						 LuaPattern::Range* matchList, size_t stringLength ) const;
+
+	/** Computes the set of bytes that can start a match of the pattern (anchored at the search
+	 * position).
+	 * @return False if any byte could start a match (or the pattern can match an empty string),
+	 * in that case the set is not modified. */
+	bool getFirstChars( std::bitset<256>& firstChars ) const;
+
 	bool range( int indexGet, int& startMatch, int& endMatch,
 				LuaPattern::Range* returnedMatched ) const;
 
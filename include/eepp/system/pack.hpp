@@ -3,6 +3,7 @@
 
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/mutex.hpp>
+#include <eepp/system/packindex.hpp>
 #include <eepp/system/scopedbuffer.hpp>
 
 namespace EE { namespace System {
@@ -77,8 +78,13 @@ class EE_API Pack : protected Mutex {
 	/** Open a file stream for reading */
 	virtual IOStream* getFileStream( const std::string& path ) = 0;
 
+	/** @return The index of the files inside the pack. It's built when the pack is opened, packs
+	 * that resolve their files on demand (like DirectoryPack) leave it empty. */
+	const PackIndex& getIndex() const;
+
   protected:
 	bool mIsOpen;
+	PackIndex mIndex;
 
 	void onPackOpened();
 
@@ -0,0 +1,62 @@
+#ifndef EE_SYSTEM_PACKINDEX_HPP
+#define EE_SYSTEM_PACKINDEX_HPP
+
+#include <eepp/config.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace EE { namespace System {
+
+/** @brief Index of the files inside a pack.
+ * Maps the normalized path of every file to its entry number, and keeps a directory tree to list
+ * the files of a directory without scanning all the entries. */
+class EE_API PackIndex {
+  public:
+	/** @return The path with forward slashes, without the leading "./" or "/" and without repeated
+	 * slashes. */
+	static std::string normalizePath( std::string path );
+
+	PackIndex();
+
+	void clear();
+
+	/** Adds (or replaces) the entry number of a file path. */
+	void add( const std::string& path, const Int32& entry );
+
+	void remove( const std::string& path );
+
+	/** @return The entry number of the file path, or -1 if the file is not indexed. */
+	Int32 find( const std::string& path ) const;
+
+	bool exists( const std::string& path ) const;
+
+	size_t size() const;
+
+	bool empty() const;
+
+	/** @return The paths of the files inside the directory (not recursive). */
+	std::vector<std::string> getFilesInDirectory( const std::string& directory ) const;
+
+	/** @return The names of the subdirectories of the directory. */
+	std::vector<std::string> getDirectoriesInDirectory( const std::string& directory ) const;
+
+  protected:
+	struct Directory {
+		std::map<std::string, Directory> directories;
+		std::set<std::string> files;
+	};
+
+	std::unordered_map<std::string, Int32> mEntries;
+	Directory mRoot;
+
+	static bool needsNormalization( const std::string& path );
+
+	const Directory* findDirectory( const std::string& directory ) const;
+};
+
+}} // namespace EE::System
+
+#endif
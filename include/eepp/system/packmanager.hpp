@@ -18,7 +18,9 @@ class EE_API PackManager : protected Container<Pack> {
 
 	/** @brief Searchs for the filepath in the packs, if the file is found it will return the pack
 	 *that belongs to. *	@return The pack where the file exists. If the file is not found,
-	 *returns NULL. *	@param path The file path to search. */
+	 *returns NULL. *	@param path The file path to search.
+	 *	The packs are searched in the order they were registered, the first one that contains the
+	 *file wins. */
 	Pack* exists( std::string& path );
 
 	/** @brief Search for a pack by its path.
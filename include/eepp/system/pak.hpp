@@ -2,11 +2,15 @@
 #define EE_SYSTEMCPAK_HPP
 
 #include <eepp/system/iostreamfile.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
 #include <eepp/system/pack.hpp>
+#include <memory>
 
 namespace EE { namespace System {
 
-/** @brief Quake 2 PAK handler */
+/** @brief Quake 2 PAK handler
+ * The files are read from a read-only memory mapping of the pak (or with positional reads if the
+ * platform can't map it), so several threads can extract files at the same time. */
 class EE_API Pak : public Pack {
   public:
 	static Pak* New();
@@ -76,6 +80,12 @@ class EE_API Pak : public Pack {
 
 	IOStream* getFileStream( const std::string& path );
 
+	/** @return A pointer to the contents of the file inside the memory mapped pak, without
+	 * copying them. It's valid until the pak is closed or modified. Returns NULL if the file does
+	 * not exist or the pak is not memory mapped.
+	 * @param size The size of the file */
+	const char* getFileView( const std::string& path, Uint32& size );
+
   protected:
 	friend class IOStreamPak;
 
@@ -101,8 +111,24 @@ class EE_API Pak : public Pack {
 
 	pakFile mPak;
 	std::vector<pakEntry> mPakFiles;
+	/** Shared with the IOStreamPak streams reading from it, so the mapping outlives the pak
+	 * being closed or mapped again while a stream is open. */
+	std::shared_ptr<IOStreamMappedFile> mMappedFile;
 
 	pakEntry getPackEntry( Uint32 index );
+
+	static std::string getEntryName( const pakEntry& entry );
+
+	/** Maps the pak file for reading, if it can't be mapped the reads fall back to positional
+	 * reads. */
+	void mapPak();
+
+	/** @return The entry contents inside the mapping, NULL if it's not mapped. */
+	const char* getEntryView( const pakEntry& entry ) const;
+
+	/** Reads the entry contents into data (that must be at least file_length bytes). It does
+	 * not use the shared pak stream, so it's safe to call it from several threads. */
+	bool readEntry( const pakEntry& entry, char* data ) const;
 };
 
 }} // namespace EE::System
@@ -30,6 +30,11 @@ class EE_API ThreadPool : NonCopyable {
 	void run(
 		const std::function<void()>& func, const std::function<void()>& doneCallback = []() {} );
 
+	/** Runs task( i ) for every i in [0, count) in the pool threads and in the calling thread,
+	 * and returns once all the tasks finished. The calling thread runs tasks too, so a busy pool
+	 * never blocks the caller, it only makes it run more of the tasks. */
+	void parallelFor( size_t count, const std::function<void( size_t )>& task );
+
 	Uint32 numThreads() const;
 
 	bool terminateOnClose() const;
@@ -9,6 +9,9 @@
 
 namespace EE { namespace System {
 
+/** @brief Merged view of the files of all the open packs.
+ * Every path is resolved through a single index, if several packs contain the same file the last
+ * opened pack wins. */
 class EE_API VirtualFileSystem : protected Container<Pack> {
 	SINGLETON_DECLARE_HEADERS( VirtualFileSystem )
 
@@ -24,23 +27,10 @@ class EE_API VirtualFileSystem : protected Container<Pack> {
   protected:
 	friend class Pack;
 
-	class vfsFile {
-	  public:
-		std::string path;
-		Pack* pack;
-
-		vfsFile() : pack( NULL ) {}
-
-		vfsFile( const std::string& path, Pack* pack ) : path( path ), pack( pack ) {}
-	};
-
-	class vfsDirectory {
-	  public:
-		vfsDirectory() {}
-		std::string path;
-		std::map<std::string, vfsFile> files;
-		std::map<std::string, vfsDirectory> directories;
-	};
+	/** The open packs in the order they were opened. */
+	std::vector<Pack*> mPacks;
+	/** Maps every file path to the position of its pack in mPacks. */
+	PackIndex mIndex;
 
 	VirtualFileSystem();
 
@@ -48,11 +38,7 @@ class EE_API VirtualFileSystem : protected Container<Pack> {
 
 	void onResourceRemove( Pack* resource );
 
-	void addFile( std::string path, Pack* pack );
-
-	void removePackFromDirectory( Pack* resource, vfsDirectory& directory );
-
-	vfsDirectory mRoot;
+	void addPackFiles( Pack* resource, const Int32& packPos );
 };
 
 class EE_API VFS {
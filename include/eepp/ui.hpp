@@ -61,6 +61,7 @@
 #include <eepp/ui/css/propertyidset.hpp>
 #include <eepp/ui/css/propertyspecification.hpp>
 #include <eepp/ui/css/stylesheet.hpp>
+#include <eepp/ui/css/stylesheetancestorfilter.hpp>
 #include <eepp/ui/css/stylesheetparser.hpp>
 #include <eepp/ui/css/stylesheetpropertiesparser.hpp>
 #include <eepp/ui/css/stylesheetproperty.hpp>
@@ -68,6 +69,7 @@
 #include <eepp/ui/css/stylesheetselectorparser.hpp>
 #include <eepp/ui/css/stylesheetstyle.hpp>
 
+#include <eepp/ui/doc/linewidthindex.hpp>
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 
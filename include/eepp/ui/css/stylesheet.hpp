@@ -4,6 +4,7 @@
 #include <eepp/ui/css/elementdefinition.hpp>
 #include <eepp/ui/css/keyframesdefinition.hpp>
 #include <eepp/ui/css/mediaquery.hpp>
+#include <eepp/ui/css/stylesheetancestorfilter.hpp>
 #include <eepp/ui/css/stylesheetstyle.hpp>
 #include <memory>
 #include <unordered_map>
@@ -22,8 +23,22 @@ class EE_API StyleSheet {
 
 	void combineStyleSheet( const StyleSheet& styleSheet );
 
-	std::shared_ptr<ElementDefinition> getElementStyles( UIWidget* element,
-														 const bool& applyPseudo = false ) const;
+	/** @return The definition with all the styles that apply to the element.
+	 * @param ancestorFilter Optional, used to reject the selectors that require ancestors that the
+	 * element does not have. It's ignored if it's not valid for the element. */
+	std::shared_ptr<ElementDefinition>
+	getElementStyles( UIWidget* element, const bool& applyPseudo = false,
+					  const StyleSheetAncestorFilter* ancestorFilter = nullptr ) const;
+
+	/** @return The styles that apply to the element, sorted by specificity and declaration order.
+	 * It does not modify the style sheet, so it can be called from several threads at once. */
+	StyleSheetStyleVector
+	getElementStyleNodes( UIWidget* element, const bool& applyPseudo = false,
+						  const StyleSheetAncestorFilter* ancestorFilter = nullptr ) const;
+
+	/** @return The cached definition of the styles returned by getElementStyleNodes. */
+	std::shared_ptr<ElementDefinition>
+	getElementDefinition( const StyleSheetStyleVector& applicableNodes ) const;
 
 	const std::vector<std::shared_ptr<StyleSheetStyle>>& getStyles() const;
 
@@ -64,6 +79,11 @@ class EE_API StyleSheet {
 	Uint32 mMarker{ 0 };
 	std::vector<std::shared_ptr<StyleSheetStyle>> mNodes;
 	std::unordered_map<size_t, StyleSheetStyleVector> mNodeIndex;
+	/** Styles without id indexed by one of the classes of their rightmost compound selector. */
+	std::unordered_map<std::string, StyleSheetStyleVector> mClassIndex;
+	/** Order in which the styles were added, the last style wins if the specificity is equal. */
+	std::unordered_map<const StyleSheetStyle*, size_t> mStyleOrder;
+	size_t mNextStyleOrder{ 0 };
 	MediaQueryList::vector mMediaQueryList;
 	KeyframesDefinitionMap mKeyframesMap;
 	using ElementDefinitionCache = std::unordered_map<size_t, std::shared_ptr<ElementDefinition>>;
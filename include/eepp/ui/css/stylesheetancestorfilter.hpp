@@ -0,0 +1,69 @@
+#ifndef EE_UI_CSS_STYLESHEETANCESTORFILTER_HPP
+#define EE_UI_CSS_STYLESHEETANCESTORFILTER_HPP
+
+#include <eepp/config.hpp>
+#include <string>
+#include <vector>
+
+namespace EE { namespace UI {
+class UIWidget;
+}} // namespace EE::UI
+
+namespace EE { namespace UI { namespace CSS {
+
+/** @brief Counting bloom filter of the tags, ids and classes of the ancestors of an element.
+**	It's kept up to date while the style of a widget tree is reloaded (the widgets are pushed
+**	before their children are styled and popped after), so the selectors that require an ancestor
+**	that is not present can be rejected without walking the parents of the element. */
+class EE_API StyleSheetAncestorFilter {
+  public:
+	static constexpr Uint32 KeyBits = 12;
+
+	StyleSheetAncestorFilter();
+
+	static Uint32 tagHash( const std::string& tag );
+
+	static Uint32 idHash( const std::string& id );
+
+	static Uint32 classHash( const std::string& cls );
+
+	/** Pushes the element as the parent of the next elements to match. */
+	void pushElement( UIWidget* element );
+
+	void popElement();
+
+	/** Pushes all the ancestors of the element (from the root), so the filter can be used to
+	 * match the element. */
+	void pushAncestors( UIWidget* element );
+
+	void clear();
+
+	bool isEmpty() const { return mElements.empty(); }
+
+	UIWidget* getTop() const { return mElements.empty() ? nullptr : mElements.back(); }
+
+	/** @return True if the filter contains the ancestors of the element. */
+	bool isValidFor( UIWidget* element ) const;
+
+	/** @return False if the hash is not present for sure. */
+	bool mayContain( const Uint32& hash ) const {
+		return mCounters[hash & KeyMask] && mCounters[( hash >> 16 ) & KeyMask];
+	}
+
+  protected:
+	static constexpr Uint32 KeyMask = ( 1 << KeyBits ) - 1;
+
+	std::vector<Uint8> mCounters;
+	std::vector<UIWidget*> mElements;
+	/** The hashes added by every pushed element, to be able to remove them. */
+	std::vector<Uint32> mHashes;
+	std::vector<size_t> mHashesStart;
+
+	void add( const Uint32& hash );
+
+	void remove( const Uint32& hash );
+};
+
+}}} // namespace EE::UI::CSS
+
+#endif
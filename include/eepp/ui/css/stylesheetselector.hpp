@@ -1,6 +1,7 @@
 #ifndef EE_UI_CSS_STYLESHEETSELECTOR_HPP
 #define EE_UI_CSS_STYLESHEETSELECTOR_HPP
 
+#include <eepp/ui/css/stylesheetancestorfilter.hpp>
 #include <eepp/ui/css/stylesheetselectorrule.hpp>
 
 namespace EE { namespace UI {
@@ -36,12 +37,22 @@ class EE_API StyleSheetSelector {
 
 	const std::string& getSelectorTagName() const;
 
+	/** @return The classes required by the rightmost compound selector. */
+	const std::vector<std::string>& getSelectorClasses() const;
+
+	/** @return False if the ancestors required by the selector are not present in the filter,
+	 * which means that the selector can't match the element. The filter must be valid for the
+	 * element. */
+	bool mayMatchAncestors( const StyleSheetAncestorFilter& filter ) const;
+
   protected:
 	std::string mName;
 	Uint32 mSpecificity;
 	std::vector<StyleSheetSelectorRule> mSelectorRules;
 	bool mCacheable;
 	bool mStructurallyVolatile;
+	/** Hashes of the tags, ids and classes that must be present in the element ancestors. */
+	std::vector<Uint32> mAncestorHashes;
 
 	void addSelectorRule( std::string& buffer,
 						  StyleSheetSelectorRule::PatternMatch& curPatternMatch,
@@ -79,6 +79,8 @@ class EE_API StyleSheetSelectorRule {
 
 	const std::string& getId() const;
 
+	const std::vector<std::string>& getClasses() const;
+
   protected:
 	int mSpecificity;
 	PatternMatch mPatternMatch;
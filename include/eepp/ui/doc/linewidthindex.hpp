@@ -0,0 +1,56 @@
+#ifndef EE_UI_DOC_LINEWIDTHINDEX_HPP
+#define EE_UI_DOC_LINEWIDTHINDEX_HPP
+
+#include <eepp/config.hpp>
+#include <map>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** Keeps the width of every line of a document and a count of the lines per width, so the
+ * widest line is known after each edit without measuring all the lines. Changing a width is
+ * O(log n) and getting the widest line is O(1). Inserting or removing lines moves the widths of
+ * the following lines, O(n) like the lines of the document itself, but it's only a move of
+ * floats. The widths are provided by the user (usually the text widths measured by the
+ * editor). */
+class EE_API LineWidthIndex {
+  public:
+	LineWidthIndex();
+
+	/** Resets the index to linesCount lines of zero width. */
+	void reset( const size_t& linesCount );
+
+	void clear();
+
+	size_t size() const;
+
+	bool empty() const;
+
+	void setWidth( const Int64& line, const Float& width );
+
+	Float getWidth( const Int64& line ) const;
+
+	/** @return The width of the widest line. */
+	Float getMaxWidth() const;
+
+	/** @return The number of lines wider than width. */
+	size_t countLinesWiderThan( const Float& width ) const;
+
+	/** Inserts count lines of zero width before line. */
+	void insertLines( const Int64& line, const Int64& count );
+
+	/** Removes count lines starting at line. */
+	void removeLines( const Int64& line, const Int64& count );
+
+  protected:
+	std::vector<Float> mWidths;
+	std::map<Float, size_t> mWidthCount;
+
+	void addWidth( const Float& width );
+
+	void removeWidth( const Float& width );
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif
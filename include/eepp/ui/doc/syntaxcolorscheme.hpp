@@ -4,6 +4,9 @@
 #include <eepp/system/color.hpp>
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/pack.hpp>
+#include <eepp/ui/doc/syntaxstyletype.hpp>
+#include <deque>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -57,6 +60,10 @@ class EE_API SyntaxColorScheme {
 
 	const Style& getSyntaxStyle( const std::string& type ) const;
 
+	/** Same as getSyntaxStyle( const std::string& type ) but resolved by the interned type id,
+	 * without hashing the type name. */
+	const Style& getSyntaxStyle( const SyntaxStyleType& type ) const;
+
 	bool hasSyntaxStyle( const std::string& type ) const;
 
 	void setSyntaxStyles( const std::unordered_map<std::string, Style>& styles );
@@ -80,6 +87,8 @@ class EE_API SyntaxColorScheme {
 	std::unordered_map<std::string, Style> mSyntaxColors;
 	std::unordered_map<std::string, Style> mEditorColors;
 	mutable std::unordered_map<std::string, Style> mStyleCache;
+	// Indexed by SyntaxStyleType. A deque keeps the references valid while it grows.
+	mutable std::deque<std::optional<Style>> mStyleTypeCache;
 };
 
 }}} // namespace EE::UI::Doc
@@ -3,24 +3,76 @@
 
 #include <eepp/config.hpp>
 #include <eepp/core/string.hpp>
+#include <eepp/system/luapattern.hpp>
+#include <eepp/ui/doc/syntaxstyletype.hpp>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+using namespace EE::System;
+
 namespace EE { namespace UI { namespace Doc {
 
+/** The compiled version of the SyntaxPattern patterns used by the tokenizer.
+**	The anchored patterns are built only once, and the set of bytes that can start a match is
+**	precomputed, so the tokenizer can discard the patterns that can't match at the current
+**	position without running them. */
+class EE_API SyntaxPatternMatcher {
+  public:
+	explicit SyntaxPatternMatcher( const std::vector<std::string>& patterns );
+
+	/** @return The start pattern anchored to the search position. */
+	const LuaPattern& getStart() const { return mStart; }
+
+	/** @return The end pattern (only valid for patterns with start and end). */
+	const LuaPattern& getEnd() const { return mEnd; }
+
+	/** @return The end pattern anchored to the search position. */
+	const LuaPattern& getEndAnchored() const { return mEndAnchored; }
+
+	/** @return The escape character string (empty if the pattern has not escape character). */
+	const std::string& getEscape() const { return mEscape; }
+
+	/** @return True if the start pattern only matches at the beginning of the line. */
+	bool isLineStartOnly() const { return mLineStartOnly; }
+
+	/** @return False if the start pattern can't match a string starting with that byte. */
+	bool canStartWith( const char& ch ) const {
+		return mFirstChars[static_cast<unsigned char>( ch )];
+	}
+
+  protected:
+	LuaPattern mStart;
+	LuaPattern mEnd;
+	LuaPattern mEndAnchored;
+	std::string mEscape;
+	std::bitset<256> mFirstChars;
+	bool mLineStartOnly{ false };
+};
+
 struct EE_API SyntaxPattern {
 	std::vector<std::string> patterns;
 	std::vector<std::string> types;
 	std::string syntax{ "" };
+	std::vector<SyntaxStyleType> typeIds;
+	std::shared_ptr<const SyntaxPatternMatcher> matcher;
 
 	SyntaxPattern( std::vector<std::string> _patterns, std::string _type,
 				   std::string _syntax = "" ) :
-		patterns( _patterns ), types( { _type } ), syntax( _syntax ) {}
+		patterns( _patterns ),
+		types( { _type } ),
+		syntax( _syntax ),
+		typeIds( SyntaxStyleTypes::intern( types ) ),
+		matcher( std::make_shared<SyntaxPatternMatcher>( patterns ) ) {}
 
 	SyntaxPattern( std::vector<std::string> _patterns, std::vector<std::string> _types,
 				   std::string _syntax = "" ) :
-		patterns( _patterns ), types( _types ), syntax( _syntax ) {}
+		patterns( _patterns ),
+		types( _types ),
+		syntax( _syntax ),
+		typeIds( SyntaxStyleTypes::intern( types ) ),
+		matcher( std::make_shared<SyntaxPatternMatcher>( patterns ) ) {}
 };
 
 class EE_API SyntaxDefinition {
@@ -50,6 +102,9 @@ class EE_API SyntaxDefinition {
 
 	std::string getSymbol( const std::string& symbol ) const;
 
+	/** @return The style type of the symbol, SyntaxStyleTypes::None if it's not a symbol. */
+	SyntaxStyleType getSymbolType( const std::string& symbol ) const;
+
 	/** Accepts lua patterns and file extensions. */
 	SyntaxDefinition& addFileType( const std::string& fileType );
 
@@ -85,6 +140,7 @@ class EE_API SyntaxDefinition {
 	std::vector<std::string> mFiles;
 	std::vector<SyntaxPattern> mPatterns;
 	std::unordered_map<std::string, std::string> mSymbols;
+	std::unordered_map<std::string, SyntaxStyleType> mSymbolTypes;
 	std::string mComment;
 	std::vector<std::string> mHeaders;
 	std::string mLSPName;
@@ -1,45 +1,117 @@
 #ifndef EE_UI_DOC_SYNTAXHIGHLIGHTER_HPP
 #define EE_UI_DOC_SYNTAXHIGHLIGHTER_HPP
 
+#include <atomic>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/syntaxtokenizer.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
-#include <map>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace EE { namespace UI { namespace Doc {
 
 struct TokenizedLine {
-	Uint64 initState;
-	String::HashType hash;
+	Uint64 initState{ SYNTAX_TOKENIZER_STATE_NONE };
+	String::HashType hash{ 0 };
 	std::vector<SyntaxToken> tokens;
-	Uint64 state;
+	Uint64 state{ SYNTAX_TOKENIZER_STATE_NONE };
+	bool tokenized{ false };
 };
 
+/** @brief Keeps the tokenized lines of a document up to date.
+**	The lines are tokenized incrementally from the first invalidated line. By default the work
+**	is done in the main thread (see updateDirty), optionally it can be done in the background
+**	using a thread pool (see setThreadPool). */
 class EE_API SyntaxHighlighter {
   public:
+	/** The background tokenizer publishes its results and checks for cancellation every
+	 * CheckpointInterval lines. */
+	static constexpr Int64 CheckpointInterval = 256;
+
+	/** Maximum number of lines tokenized by a single background job. */
+	static constexpr Int64 MaxLinesPerJob = 4096;
+
 	SyntaxHighlighter( TextDocument* doc );
 
+	~SyntaxHighlighter();
+
 	void changeDoc( TextDocument* doc );
 
 	void reset();
 
 	void invalidate( Int64 lineIndex );
 
+	/** Moves the tokenized lines after a document modification, so the lines below the
+	 * modification keep their tokens. */
+	void onDocumentTextChanged( const DocumentContentChange& change );
+
+	/** @return The tokens of the document line. The tokens position and length are expressed in
+	 * characters of the document line (not in bytes). */
 	const std::vector<SyntaxToken>& getLine( const size_t& index );
 
 	Int64 getFirstInvalidLine() const;
 
 	Int64 getMaxWantedLine() const;
 
+	/** Tokenizes the next invalid lines. In background mode it publishes the lines tokenized by
+	 * the background job and schedules a new job if needed.
+	 * @return True if any visible line changed. */
 	bool updateDirty( int visibleLinesCount = 40 );
 
 	const SyntaxDefinition& getSyntaxDefinitionFromTextPosition( const TextPosition& position );
 
+	/** Enables the background tokenization using the thread pool (nullptr disables it). */
+	void setThreadPool( std::shared_ptr<ThreadPool> pool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+	/** @return True if the lines are tokenized in the background. */
+	bool isAsync() const;
+
   protected:
+	/** Lines tokenized by a background job. Once published they are never modified by the job. */
+	struct Snapshot {
+		/** Version of the highlighter when the job started, the snapshots of a cancelled job
+		 * (reset, document or syntax change) are dropped. */
+		Uint64 version;
+		Int64 startLine;
+		std::vector<TokenizedLine> lines;
+	};
+
+	/** State shared with the background jobs, it outlives the highlighter if a job is running. */
+	struct AsyncState {
+		Mutex mutex;
+		std::vector<Snapshot> snapshots;
+		std::atomic<Uint64> version{ 0 };
+		/** First line edited while the job runs, the job stops once it gets there. */
+		std::atomic<Int64> editLine{ std::numeric_limits<Int64>::max() };
+		std::atomic<bool> running{ false };
+	};
+
 	TextDocument* mDoc;
-	std::map<size_t, TokenizedLine> mLines;
+	std::vector<TokenizedLine> mLines;
 	Int64 mFirstInvalidLine;
 	Int64 mMaxWantedLine;
+	std::shared_ptr<ThreadPool> mPool;
+	std::shared_ptr<AsyncState> mAsync;
+	Int64 mJobEditLine{ std::numeric_limits<Int64>::max() };
+
 	TokenizedLine tokenizeLine( const size_t& line, const Uint64& state );
+
+	TokenizedLine& getTokenizedLine( const size_t& index );
+
+	Uint64 getLineInitState( const Int64& index ) const;
+
+	bool isLineValid( const Int64& index ) const;
+
+	void skipValidLines();
+
+	bool publishSnapshots();
+
+	void runJob();
+
+	void cancelJob();
 };
 
 }}} // namespace EE::UI::Doc
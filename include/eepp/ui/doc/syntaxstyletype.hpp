@@ -0,0 +1,50 @@
+#ifndef EE_UI_DOC_SYNTAXSTYLETYPE_HPP
+#define EE_UI_DOC_SYNTAXSTYLETYPE_HPP
+
+#include <eepp/config.hpp>
+#include <string>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** An interned syntax style type name ( "normal", "keyword", "string", etc ). */
+typedef Uint32 SyntaxStyleType;
+
+/** @brief Global table of the syntax style type names.
+**	Every style type name used by the syntax definitions is interned once into a small integer,
+**	so tokens don't need to store their type name and color schemes can resolve a style by
+**	index. The table is shared by all the syntax definitions and color schemes and it's
+**	thread-safe. */
+class EE_API SyntaxStyleTypes {
+  public:
+	/** Used to represent the absence of a style type. */
+	static constexpr SyntaxStyleType None = 0xFFFFFFFF;
+
+	static constexpr SyntaxStyleType Normal = 0;
+	static constexpr SyntaxStyleType Symbol = 1;
+	static constexpr SyntaxStyleType Comment = 2;
+	static constexpr SyntaxStyleType Keyword = 3;
+	static constexpr SyntaxStyleType Keyword2 = 4;
+	static constexpr SyntaxStyleType Number = 5;
+	static constexpr SyntaxStyleType Literal = 6;
+	static constexpr SyntaxStyleType String = 7;
+	static constexpr SyntaxStyleType Operator = 8;
+	static constexpr SyntaxStyleType Function = 9;
+	static constexpr SyntaxStyleType Link = 10;
+	static constexpr SyntaxStyleType LinkHover = 11;
+
+	/** @return The type id of the style type name. Registers the name if it's new. */
+	static SyntaxStyleType intern( const std::string& name );
+
+	static std::vector<SyntaxStyleType> intern( const std::vector<std::string>& names );
+
+	/** @return The style type name of the type id (empty string if not registered). */
+	static const std::string& getName( const SyntaxStyleType& type );
+
+	/** @return The number of style types registered. */
+	static size_t count();
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif // EE_UI_DOC_SYNTAXSTYLETYPE_HPP
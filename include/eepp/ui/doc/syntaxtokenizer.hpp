@@ -6,15 +6,21 @@
 #include <eepp/graphics/text.hpp>
 #include <eepp/ui/doc/syntaxcolorscheme.hpp>
 #include <eepp/ui/doc/syntaxdefinition.hpp>
+#include <eepp/ui/doc/syntaxstyletype.hpp>
 #include <string>
 
 using namespace EE::Graphics;
 
 namespace EE { namespace UI { namespace Doc {
 
+/** A span of text of the same style type. The token does not hold the text, it references it
+ * by its position and length in the tokenized text. The unit of the position and length depends
+ * on who produced the token: SyntaxTokenizer::tokenize returns bytes of the UTF-8 text, while
+ * SyntaxHighlighter::getLine returns characters of the document line. */
 struct EE_API SyntaxToken {
-	std::string type;
-	std::string text;
+	SyntaxStyleType type;
+	Uint32 pos; //! Start position of the token in the tokenized text (bytes or characters)
+	Uint32 len; //! Length of the token (bytes or characters)
 };
 
 #define SYNTAX_TOKENIZER_STATE_NONE ( 0 )
@@ -28,6 +34,9 @@ struct SyntaxState {
 
 class EE_API SyntaxTokenizer {
   public:
+	/** Tokenizes a line of UTF-8 text.
+	 * @return The tokens and the state at the end of the line. The tokens position and length are
+	 * expressed in bytes of text. */
 	static std::pair<std::vector<SyntaxToken>, Uint32>
 	tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32& state,
 			  const size_t& startIndex = 0, bool skipSubSyntaxSeparator = false );
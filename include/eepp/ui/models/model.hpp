@@ -1,6 +1,7 @@
 #ifndef EE_UI_MODELS_MODEL_HPP
 #define EE_UI_MODELS_MODEL_HPP
 
+#include <atomic>
 #include <eepp/system/lock.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/ui/models/modelindex.hpp>
@@ -58,6 +59,9 @@ class EE_API Model {
 	enum UpdateFlag {
 		DontInvalidateIndexes = 0,
 		InvalidateAllIndexes = 1 << 0,
+		/** Only new rows were added at the end of their parents, the existing rows didn't
+		 * change. */
+		RowsAppended = 1 << 1,
 	};
 
 	virtual ~Model(){};
@@ -142,6 +146,11 @@ class EE_API Model {
 
 	void releaseResourceMutex();
 
+	/** @return A counter increased every time the rows of the model change. It's increased with the
+	 * resource mutex locked, so a view holding the lock can compare it to know if the indexes it
+	 * keeps still point to valid data. */
+	Uint64 getGeneration() const { return mGeneration; }
+
   protected:
 	Model(){};
 
@@ -149,6 +158,10 @@ class EE_API Model {
 
 	void onModelUpdate( unsigned flags = UpdateFlag::InvalidateAllIndexes );
 
+	/** Must be called with the resource mutex locked when the rows change without a
+	 * begin/end operation. */
+	void increaseGeneration() { ++mGeneration; }
+
 	ModelIndex createIndex( int row, int column, const void* data = nullptr,
 							const Int64& internalId = 0 ) const;
 
@@ -204,6 +217,7 @@ class EE_API Model {
 	std::unordered_set<Client*> mClients;
 	std::function<void()> mOnUpdate;
 	Mutex mResourceLock;
+	std::atomic<Uint64> mGeneration{ 0 };
 };
 
 
@@ -1,9 +1,12 @@
 #ifndef EE_UI_MODELS_SORTINGPROXYMODEL_HPP
 #define EE_UI_MODELS_SORTINGPROXYMODEL_HPP
 
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/models/model.hpp>
 #include <memory>
 
+using namespace EE::System;
+
 namespace EE { namespace UI { namespace Models {
 
 class EE_API SortingProxyModel final : public Model, private Model::Client {
@@ -54,12 +57,28 @@ class EE_API SortingProxyModel final : public Model, private Model::Client {
 
 	std::shared_ptr<Model> getSource() const;
 
+	/** Sets the thread pool used to sort large models in parallel. Without a thread pool the rows
+	 * are sorted in the calling thread. */
+	void setThreadPool( std::shared_ptr<ThreadPool> pool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
   private:
+	/** The value of the sort column of a row, extracted once per sort. The strings are already
+	 * normalized to the sorting case. */
+	struct SortKey {
+		std::string text;
+		double number{ 0 };
+		bool isNumber{ false };
+	};
+
 	// NOTE: The data() of indexes points to the corresponding Mapping object for that index.
 	struct Mapping {
 		std::vector<int> sourceRows;
 		std::vector<int> proxyRows;
 		ModelIndex sourceParent;
+		/** The sort keys of the source rows, kept to merge the rows appended later. */
+		std::vector<SortKey> keys;
 	};
 
 	using InternalMapIterator = std::map<ModelIndex, std::shared_ptr<Mapping>>::iterator;
@@ -74,6 +93,22 @@ class EE_API SortingProxyModel final : public Model, private Model::Client {
 
 	void sortMapping( Mapping&, int column, SortOrder );
 
+	/** Sorts only the rows appended since the last sort and merges them with the sorted ones. */
+	void sortAppendedRows( Mapping& );
+
+	SortKey getSortKey( const ModelIndex& sourceIndex ) const;
+
+	static bool keyLessThan( const SortKey& key1, const SortKey& key2 );
+
+	void extractKeys( Mapping&, int column, int fromRow, int toRow );
+
+	/** Sorts the rows starting at firstRow, and merges them with the already sorted rows before
+	 * it. */
+	void sortRows( std::vector<int>& rows, size_t firstRow, const std::vector<SortKey>& keys,
+				   SortOrder sortOrder );
+
+	void updateSelection( Mapping&, const std::vector<int>& oldSourceRows );
+
 	InternalMapIterator buildMapping( const ModelIndex& proxyIndex );
 
 	void invalidate( unsigned flags = Model::UpdateFlag::DontInvalidateIndexes );
@@ -83,6 +118,7 @@ class EE_API SortingProxyModel final : public Model, private Model::Client {
 	bool isSortingCaseSensitive();
 
 	std::shared_ptr<Model> mSource;
+	std::shared_ptr<ThreadPool> mThreadPool;
 	std::map<ModelIndex, std::shared_ptr<Mapping>> mMappings;
 	int mKeyColumn{ -1 };
 	SortOrder mSortOrder{ SortOrder::Ascending };
@@ -2,6 +2,7 @@
 #define EE_UI_UICODEEDIT_HPP
 
 #include <eepp/graphics/text.hpp>
+#include <eepp/ui/doc/linewidthindex.hpp>
 #include <eepp/ui/doc/syntaxcolorscheme.hpp>
 #include <eepp/ui/doc/syntaxhighlighter.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
@@ -373,6 +374,11 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	const SyntaxDefinition& getSyntaxDefinition() const;
 
+	/** Enables the background syntax highlighting using the thread pool (nullptr to disable it). */
+	void setSyntaxHighlighterThreadPool( std::shared_ptr<ThreadPool> pool );
+
+	const std::shared_ptr<ThreadPool>& getSyntaxHighlighterThreadPool() const;
+
 	const bool& getHorizontalScrollBarEnabled() const;
 
 	void setHorizontalScrollBarEnabled( const bool& horizontalScrollBarEnabled );
@@ -385,6 +391,10 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	void setFindLongestLineWidthUpdateFrequency( const Time& findLongestLineWidthUpdateFrequency );
 
+	/** @return The measured width of each line of the document, kept up to date with the document
+	 * changes while the horizontal scroll bar is enabled. */
+	const LineWidthIndex& getLineWidthIndex() const;
+
 	/** Doc commands executed in this editor. */
 	TextPosition moveToLineOffset( const TextPosition& position, int offset,
 								   const size_t& cursorIdx = 0 );
@@ -657,6 +667,7 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	Uint32 mLineBreakingColumn{ 100 };
 	TextRange mMatchingBrackets;
 	Float mLongestLineWidth{ 0 };
+	LineWidthIndex mLineWidthIndex;
 	Time mFindLongestLineWidthUpdateFrequency;
 	Clock mLongestLineWidthLastUpdate;
 	String mHighlightWord;
@@ -675,6 +686,37 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 		String::HashType hash;
 	};
 	mutable std::map<Int64, TextLine> mTextCache;
+	/** Everything that changes how a line is rendered. */
+	struct LineRenderKey {
+		String::HashType hash;
+		Uint64 tokensHash;
+		Float fontSize;
+		Float alpha;
+		Float screenOffset;
+		Float scrollX;
+		Float width;
+
+		bool operator==( const LineRenderKey& other ) const {
+			return hash == other.hash && tokensHash == other.tokensHash &&
+				   fontSize == other.fontSize && alpha == other.alpha &&
+				   screenOffset == other.screenOffset && scrollX == other.scrollX &&
+				   width == other.width;
+		}
+	};
+	struct LineRenderRun {
+		Text text;
+		Float textOffset;
+		Color background;
+		Float backgroundOffset;
+		Float backgroundWidth;
+	};
+	struct LineRender {
+		LineRenderKey key;
+		std::vector<LineRenderRun> runs;
+	};
+	/** The text runs of the last drawn lines, their geometry is reused while the line does not
+	 * change. */
+	std::unordered_map<Int64, LineRender> mLineRenderCache;
 	Tools::UIDocFindReplace* mFindReplace{ nullptr };
 	struct PluginRequestedSpace {
 		UICodeEditorPlugin* plugin;
@@ -704,6 +746,9 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	virtual void findLongestLine();
 
+	/** Updates the width of the lines affected by the change, instead of measuring all of them. */
+	void updateLineWidthIndex( const DocumentContentChange& change );
+
 	virtual Uint32 onFocus();
 
 	virtual Uint32 onFocusLoss();
@@ -772,6 +817,13 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	virtual void drawLineText( const Int64& line, Vector2f position, const Float& fontSize,
 							   const Float& lineHeight );
 
+	void drawLineRuns( std::vector<LineRenderRun>& runs, const Vector2f& position,
+					   const Float& lineHeight );
+
+	void buildLineRuns( const Int64& line, const std::vector<SyntaxToken>& tokens,
+						Vector2f position, const Float& fontSize,
+						std::vector<LineRenderRun>& runs );
+
 	virtual void drawSelectionMatch( const std::pair<int, int>& lineRange,
 									 const Vector2f& startScroll, const Float& lineHeight );
 
@@ -2,6 +2,7 @@
 #define EE_UISCENENODE_HPP
 
 #include <eepp/scene/scenenode.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/system/translator.hpp>
 #include <eepp/ui/css/stylesheet.hpp>
 #include <eepp/ui/keyboardshortcut.hpp>
@@ -26,6 +27,9 @@ enum class ColorSchemePreference { Light, Dark };
 
 class EE_API UISceneNode : public SceneNode {
   public:
+	/** Number of widgets matched by each task of the parallel style pass. */
+	static constexpr size_t StyleMatchChunkSize = 256;
+
 	static UISceneNode* New( EE::Window::Window* window = NULL );
 
 	explicit UISceneNode( EE::Window::Window* window = NULL );
@@ -87,6 +91,9 @@ class EE_API UISceneNode : public SceneNode {
 
 	CSS::StyleSheet& getStyleSheet();
 
+	/** The ancestors of the widgets being styled by the current style pass. */
+	CSS::StyleSheetAncestorFilter& getStyleSheetAncestorFilter();
+
 	bool hasStyleSheet();
 
 	const bool& isLoading() const;
@@ -156,6 +163,16 @@ class EE_API UISceneNode : public SceneNode {
 
 	void nodeToWorldTranslation( Vector2f& Pos ) const;
 
+	/** Sets the thread pool used to match the styles of big widget trees in parallel.
+	 * The properties are always applied in the main thread. */
+	void setThreadPool( std::shared_ptr<ThreadPool> pool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+	/** @return The global styles of the widget matched by the current style pass, null if the
+	 * widget was not matched in advance. */
+	const CSS::StyleSheetStyleVector* getStyleMatch( UIWidget* widget ) const;
+
   protected:
 	friend class EE::UI::UIWindow;
 	friend class EE::UI::UIWidget;
@@ -165,6 +182,7 @@ class EE_API UISceneNode : public SceneNode {
 	Translator mTranslator;
 	std::list<UIWindow*> mWindowsList;
 	CSS::StyleSheet mStyleSheet;
+	CSS::StyleSheetAncestorFilter mStyleSheetAncestorFilter;
 	bool mIsLoading;
 	bool mVerbose;
 	bool mUpdatingLayouts;
@@ -177,6 +195,11 @@ class EE_API UISceneNode : public SceneNode {
 	std::unordered_set<UIWidget*> mDirtyStyleState;
 	std::unordered_map<UIWidget*, bool> mDirtyStyleStateCSSAnimations;
 	std::unordered_set<UILayout*> mDirtyLayouts;
+	std::shared_ptr<ThreadPool> mThreadPool;
+	/** The global styles matched in advance by the current style pass, and the widget of each
+	 * match. */
+	std::vector<CSS::StyleSheetStyleVector> mStyleMatches;
+	std::vector<UIWidget*> mStyleMatchWidgets;
 	std::vector<std::pair<Float, std::string>> mTimes;
 	ColorSchemePreference mColorSchemePreference{ ColorSchemePreference::Dark };
 	Uint32 mMaxInvalidationDepth{ 2 };
@@ -193,6 +216,19 @@ class EE_API UISceneNode : public SceneNode {
 
 	void setInternalPixelsSize( const Sizef& size );
 
+	/** @return The dirty widgets that don't have a dirty ancestor. */
+	std::vector<UIWidget*> getDirtyRoots( const std::unordered_set<UIWidget*>& dirty ) const;
+
+	/** Matches the global styles of the widget trees in parallel (if a thread pool is set), so
+	 * the style pass only needs to apply them. */
+	void matchStyles( const std::vector<UIWidget*>& roots );
+
+	void clearStyleMatches();
+
+	/** Discards the styles matched in advance that depend on the id, classes or tag of the
+	 * widget, called when they change during the style pass. */
+	void invalidateStyleMatch( UIWidget* widget );
+
 	void setActiveWindow( UIWindow* window );
 
 	void setFocusLastWindow( UIWindow* window );
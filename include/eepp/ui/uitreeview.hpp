@@ -1,6 +1,7 @@
 #ifndef EE_UI_UITREEVIEW_HPP
 #define EE_UI_UITREEVIEW_HPP
 
+#include <atomic>
 #include <eepp/ui/abstract/uiabstracttableview.hpp>
 #include <eepp/ui/uiicon.hpp>
 #include <eepp/ui/uitablerow.hpp>
@@ -172,12 +173,54 @@ class EE_API UITreeView : public UIAbstractTableView {
 											 const Float& )>
 		TreeViewCallback;
 
+	struct VisibleRow {
+		ModelIndex index;
+		size_t indentLevel;
+	};
+
+	typedef std::function<IterationDecision( const ModelIndex&, const size_t&, const Float& )>
+		VisibleRowCallback;
+
+	/** Iterates the visible rows, in display order. */
 	void traverseTree( TreeViewCallback ) const;
 
-	mutable std::map<void*, MetadataForIndex> mViewMetadata;
+	/** Iterates only the rows inside the visible area. */
+	void traverseVisibleArea( VisibleRowCallback ) const;
+
+	mutable std::unordered_map<void*, MetadataForIndex> mViewMetadata;
+	/** The flattened rows of the tree that are currently expanded. It's rebuilt when the model
+	 * generation changes, and patched when a row is expanded or collapsed. The rows share the same
+	 * height, so the position of a row is derived from its position in the list. */
+	mutable std::vector<VisibleRow> mVisibleRows;
+	mutable std::atomic<bool> mVisibleRowsDirty{ true };
+	/** Generation of the model when the rows were built, the rows keep indexes to the model data
+	 * so they can only be used while it doesn't change. */
+	mutable Uint64 mVisibleRowsGeneration{ 0 };
 
 	virtual size_t getItemCount() const;
 
+	virtual void onModelUpdate( unsigned flags );
+
+	/** The rows must be used with the model resource mutex locked, they are valid until it's
+	 * released. */
+	const std::vector<VisibleRow>& getVisibleRows() const;
+
+	void invalidateVisibleRows();
+
+	/** Inserts or removes the children rows of the index after it was expanded or collapsed. */
+	void updateVisibleRows( const ModelIndex& index );
+
+	void appendVisibleRows( std::vector<VisibleRow>& rows, const ModelIndex& parent,
+							const size_t& indentLevel ) const;
+
+	/** @return The position of the index in the visible rows, or -1 if it's not visible. */
+	Int64 getVisibleRowIndex( const ModelIndex& index ) const;
+
+	/** @return The first row that is not above the visible area. */
+	size_t getFirstVisibleRow() const;
+
+	Float getRowOffset( const size_t& rowIndex ) const;
+
 	UITreeView::MetadataForIndex& getIndexMetadata( const ModelIndex& index ) const;
 
 	virtual void onColumnSizeChange( const size_t& colIndex, bool fromUserInteraction = false );
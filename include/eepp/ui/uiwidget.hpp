@@ -248,6 +248,9 @@ class EE_API UIWidget : public UINode {
 	PositionPolicy mLayoutPositionPolicy;
 	UIWidget* mLayoutPositionPolicyWidget;
 	int mAttributesTransactionCount;
+	/** Index of the style matched in advance by the current style pass, see
+	 * UISceneNode::getStyleMatch. */
+	Uint32 mStyleMatchIndex;
 	std::string mSkinName;
 	std::vector<std::string> mClasses;
 	std::vector<std::string> mPseudoClasses;
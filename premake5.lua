@@ -1081,6 +1081,83 @@ workspace "eepp"
 		includedirs { "src/thirdparty" }
 		build_link_configuration( "eepp-ui-perf-test", true )
 
+	project "eepp-string-search-perf-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/string_search_perf_test/*.cpp" }
+		build_link_configuration( "eepp-string-search-perf-test", true )
+
+	project "eepp-syntax-highlighter-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/syntax_highlighter_test/*.cpp" }
+		build_link_configuration( "eepp-syntax-highlighter-test", true )
+
+	project "eepp-syntax-tokenizer-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/syntax_tokenizer_test/*.cpp" }
+		build_link_configuration( "eepp-syntax-tokenizer-test", true )
+
+	project "eepp-line-width-index-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/line_width_index_test/*.cpp" }
+		build_link_configuration( "eepp-line-width-index-test", true )
+
+	project "eepp-syntax-tokenizer-perf-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/syntax_tokenizer_perf_test/*.cpp" }
+		build_link_configuration( "eepp-syntax-tokenizer-perf-test", true )
+
+	project "eepp-textdocument-perf-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/textdocument_perf_test/*.cpp" }
+		build_link_configuration( "eepp-textdocument-perf-test", true )
+
+	project "eepp-pak-perf-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/pak_perf_test/*.cpp" }
+		build_link_configuration( "eepp-pak-perf-test", true )
+
+	project "eepp-project-search-index-test"
+		kind "ConsoleApp"
+		language "C++"
+		includedirs { "src/tools/ecode" }
+		files { "src/tests/project_search_index_test/*.cpp", "src/tools/ecode/projectsearchindex.cpp" }
+		build_link_configuration( "eepp-project-search-index-test", true )
+
+	project "eepp-batch-reorder-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/batch_reorder_test/*.cpp" }
+		build_link_configuration( "eepp-batch-reorder-test", true )
+
+	project "eepp-batch-renderer-test"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/batch_renderer_test/*.cpp" }
+		build_link_configuration( "eepp-batch-renderer-test", true )
+
+	project "eepp-eterm-perf-test"
+		kind "ConsoleApp"
+		language "C++"
+		incdirs { "src/modules/eterm/include/", "src/thirdparty" }
+		files { "src/tests/eterm_perf_test/*.cpp" }
+		links { "eterm-static" }
+		build_link_configuration( "eepp-eterm-perf-test", true )
+
+	project "eepp-terminal-history-test"
+		kind "ConsoleApp"
+		language "C++"
+		incdirs { "src/modules/eterm/include/", "src/thirdparty" }
+		files { "src/tests/terminal_history_test/*.cpp" }
+		links { "eterm-static" }
+		build_link_configuration( "eepp-terminal-history-test", true )
+
 if os.isfile("external_projects.lua") then
 	dofile("external_projects.lua")
 end
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <climits>
 #include <cstdarg>
@@ -10,6 +11,20 @@
 #include <random>
 #include <thirdparty/utf8cpp/utf8.h>
 
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __SSE2__ ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define EE_STRING_SEARCH_SSE2
+#include <emmintrin.h>
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && !defined( __EMSCRIPTEN__ )
+#define EE_STRING_SEARCH_AVX2
+#define EE_STRING_SEARCH_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#include <immintrin.h>
+#endif
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#endif
+
 namespace EE {
 
 const std::size_t String::InvalidPos = StringType::npos;
@@ -40,6 +55,177 @@ const std::size_t String::InvalidPos = StringType::npos;
  * THE SOFTWARE.
  */
 
+static inline unsigned char asciiToLower( unsigned char c ) {
+	return c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c;
+}
+
+static inline bool equalsCaseInsensitive( const unsigned char* haystack,
+										  const unsigned char* needle, size_t length ) {
+	for ( size_t i = 0; i < length; ++i )
+		if ( asciiToLower( haystack[i] ) != needle[i] )
+			return false;
+	return true;
+}
+
+/* SIMD kernels: the first and the last byte of the needle are compared against a whole block of
+ * haystack positions at once, and only the positions where both bytes match are verified. For
+ * the case insensitive search the letters are folded by setting the 0x20 bit of the haystack
+ * bytes, which maps 'A'-'Z' to 'a'-'z' and can't turn any other byte into a lowercase letter. */
+
+#ifdef EE_STRING_SEARCH_SSE2
+
+static inline unsigned int countTrailingZeros( Uint32 mask ) {
+#if defined( _MSC_VER ) && !defined( __clang__ )
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return index;
+#else
+	return __builtin_ctz( mask );
+#endif
+}
+
+static inline unsigned char caseFoldMask( unsigned char c ) {
+	return c >= 'a' && c <= 'z' ? 0x20 : 0;
+}
+
+template <bool CaseInsensitive>
+static size_t searchSSE2( const unsigned char* haystack, size_t haystackLength,
+						  const unsigned char* needle, size_t needleLength ) {
+	const size_t last = needleLength - 1;
+	const __m128i first = _mm_set1_epi8( (char)needle[0] );
+	const __m128i lastChar = _mm_set1_epi8( (char)needle[last] );
+	const __m128i firstFold = _mm_set1_epi8( (char)caseFoldMask( needle[0] ) );
+	const __m128i lastFold = _mm_set1_epi8( (char)caseFoldMask( needle[last] ) );
+	size_t pos = 0;
+
+	for ( ; pos + last + 16 <= haystackLength; pos += 16 ) {
+		__m128i blockFirst = _mm_loadu_si128( (const __m128i*)( haystack + pos ) );
+		__m128i blockLast = _mm_loadu_si128( (const __m128i*)( haystack + pos + last ) );
+		if ( CaseInsensitive ) {
+			blockFirst = _mm_or_si128( blockFirst, firstFold );
+			blockLast = _mm_or_si128( blockLast, lastFold );
+		}
+		Uint32 mask = _mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( blockFirst, first ),
+														 _mm_cmpeq_epi8( blockLast, lastChar ) ) );
+		while ( mask ) {
+			size_t candidate = pos + countTrailingZeros( mask );
+			if ( CaseInsensitive ? equalsCaseInsensitive( haystack + candidate + 1, needle + 1,
+														  needleLength - 2 )
+								 : std::memcmp( haystack + candidate + 1, needle + 1,
+												needleLength - 2 ) == 0 )
+				return candidate;
+			mask &= mask - 1;
+		}
+	}
+
+	for ( ; pos + last < haystackLength; ++pos ) {
+		if ( CaseInsensitive
+				 ? equalsCaseInsensitive( haystack + pos, needle, needleLength )
+				 : std::memcmp( haystack + pos, needle, needleLength ) == 0 )
+			return pos;
+	}
+
+	return haystackLength;
+}
+
+#endif
+
+#ifdef EE_STRING_SEARCH_AVX2
+
+template <bool CaseInsensitive>
+EE_STRING_SEARCH_TARGET_AVX2 static size_t searchAVX2( const unsigned char* haystack,
+													   size_t haystackLength,
+													   const unsigned char* needle,
+													   size_t needleLength ) {
+	const size_t last = needleLength - 1;
+	const __m256i first = _mm256_set1_epi8( (char)needle[0] );
+	const __m256i lastChar = _mm256_set1_epi8( (char)needle[last] );
+	const __m256i firstFold = _mm256_set1_epi8( (char)caseFoldMask( needle[0] ) );
+	const __m256i lastFold = _mm256_set1_epi8( (char)caseFoldMask( needle[last] ) );
+	size_t pos = 0;
+
+	for ( ; pos + last + 32 <= haystackLength; pos += 32 ) {
+		__m256i blockFirst = _mm256_loadu_si256( (const __m256i*)( haystack + pos ) );
+		__m256i blockLast = _mm256_loadu_si256( (const __m256i*)( haystack + pos + last ) );
+		if ( CaseInsensitive ) {
+			blockFirst = _mm256_or_si256( blockFirst, firstFold );
+			blockLast = _mm256_or_si256( blockLast, lastFold );
+		}
+		Uint32 mask = (Uint32)_mm256_movemask_epi8( _mm256_and_si256(
+			_mm256_cmpeq_epi8( blockFirst, first ), _mm256_cmpeq_epi8( blockLast, lastChar ) ) );
+		while ( mask ) {
+			size_t candidate = pos + countTrailingZeros( mask );
+			if ( CaseInsensitive ? equalsCaseInsensitive( haystack + candidate + 1, needle + 1,
+														  needleLength - 2 )
+								 : std::memcmp( haystack + candidate + 1, needle + 1,
+												needleLength - 2 ) == 0 )
+				return candidate;
+			mask &= mask - 1;
+		}
+	}
+
+	if ( pos + last < haystackLength ) {
+		size_t res = searchSSE2<CaseInsensitive>( haystack + pos, haystackLength - pos, needle,
+												  needleLength );
+		return res == haystackLength - pos ? haystackLength : pos + res;
+	}
+
+	return haystackLength;
+}
+
+#endif
+
+static String::BMH::Kernel detectBestKernel() {
+#if defined( EE_STRING_SEARCH_AVX2 )
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports( "avx2" ) )
+		return String::BMH::Kernel::AVX2;
+#endif
+#if defined( EE_STRING_SEARCH_SSE2 )
+	return String::BMH::Kernel::SSE2;
+#else
+	return String::BMH::Kernel::Scalar;
+#endif
+}
+
+/* The kernel forced by setKernel, -1 uses the best kernel. It's constant initialized, so it's
+ * valid even for the searches done by the static initializers of other translation units. */
+static std::atomic<int> sForcedKernel{ -1 };
+
+static String::BMH::Kernel currentKernel() {
+	int kernel = sForcedKernel.load( std::memory_order_relaxed );
+	return kernel < 0 ? String::BMH::getBestKernel() : (String::BMH::Kernel)kernel;
+}
+
+String::BMH::Kernel String::BMH::getKernel() {
+	return currentKernel();
+}
+
+String::BMH::Kernel String::BMH::setKernel( Kernel kernel ) {
+	if ( (int)kernel > (int)getBestKernel() )
+		kernel = getBestKernel();
+	sForcedKernel.store( (int)kernel, std::memory_order_relaxed );
+	return kernel;
+}
+
+String::BMH::Kernel String::BMH::getBestKernel() {
+	/* Detected once, the initialization of a local static is thread-safe */
+	static const Kernel bestKernel = detectBestKernel();
+	return bestKernel;
+}
+
+const char* String::BMH::getKernelName( Kernel kernel ) {
+	switch ( kernel ) {
+		case Kernel::AVX2:
+			return "AVX2";
+		case Kernel::SSE2:
+			return "SSE2";
+		case Kernel::Scalar:
+		default:
+			return "Scalar";
+	}
+}
+
 /* This function creates an occ table to be used by the search algorithms. */
 /* It only needs to be created once per a needle to search. */
 const String::BMH::OccTable String::BMH::createOccTable( const unsigned char* needle,
@@ -73,6 +259,19 @@ size_t String::BMH::search( const unsigned char* haystack, size_t haystackLength
 		return result ? size_t( result - haystack ) : haystackLength;
 	}
 
+	switch ( currentKernel() ) {
+#ifdef EE_STRING_SEARCH_AVX2
+		case Kernel::AVX2:
+			return searchAVX2<false>( haystack, haystackLength, needle, needleLength );
+#endif
+#ifdef EE_STRING_SEARCH_SSE2
+		case Kernel::SSE2:
+			return searchSSE2<false>( haystack, haystackLength, needle, needleLength );
+#endif
+		default:
+			break;
+	}
+
 	const size_t needleLengthMinus1 = needleLength - 1;
 
 	const unsigned char lastNeedleChar = needle[needleLengthMinus1];
@@ -96,6 +295,58 @@ size_t String::BMH::search( const unsigned char* haystack, size_t haystackLength
 	return haystackLength;
 }
 
+const String::BMH::OccTable String::BMH::createCaseInsensitiveOccTable( const unsigned char* needle,
+																	   size_t needleLength ) {
+	OccTable occ( UCHAR_MAX + 1, needleLength );
+	if ( needleLength >= 1 ) {
+		const size_t needleLengthMinus1 = needleLength - 1;
+		for ( size_t a = 0; a < needleLengthMinus1; ++a ) {
+			occ[needle[a]] = needleLengthMinus1 - a;
+			// The shift must be the same for both cases of the haystack character.
+			if ( needle[a] >= 'a' && needle[a] <= 'z' )
+				occ[needle[a] - ( 'a' - 'A' )] = needleLengthMinus1 - a;
+		}
+	}
+	return occ;
+}
+
+size_t String::BMH::searchCaseInsensitive( const unsigned char* haystack, size_t haystackLength,
+										   const unsigned char* needle, const size_t needleLength,
+										   const OccTable& occ ) {
+	if ( needleLength > haystackLength || needleLength == 0 )
+		return haystackLength;
+
+	if ( needleLength > 1 ) {
+		switch ( currentKernel() ) {
+#ifdef EE_STRING_SEARCH_AVX2
+			case Kernel::AVX2:
+				return searchAVX2<true>( haystack, haystackLength, needle, needleLength );
+#endif
+#ifdef EE_STRING_SEARCH_SSE2
+			case Kernel::SSE2:
+				return searchSSE2<true>( haystack, haystackLength, needle, needleLength );
+#endif
+			default:
+				break;
+		}
+	}
+
+	const size_t needleLengthMinus1 = needleLength - 1;
+	const unsigned char lastNeedleChar = needle[needleLengthMinus1];
+
+	size_t haystackPosition = 0;
+	while ( haystackPosition <= haystackLength - needleLength ) {
+		const unsigned char occChar = haystack[haystackPosition + needleLengthMinus1];
+
+		if ( lastNeedleChar == asciiToLower( occChar ) &&
+			 equalsCaseInsensitive( haystack + haystackPosition, needle, needleLengthMinus1 ) )
+			return haystackPosition;
+
+		haystackPosition += occ[occChar];
+	}
+	return haystackLength;
+}
+
 Int64 String::BMH::find( const std::string& haystack, const std::string& needle,
 						 const size_t& haystackOffset, const OccTable& occ ) {
 	size_t result = search( (const unsigned char*)haystack.c_str() + haystackOffset,
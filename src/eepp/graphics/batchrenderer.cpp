@@ -6,6 +6,50 @@
 
 namespace EE { namespace Graphics {
 
+// Only touched from the GL context thread, as every draw call.
+static BatchRenderer::FlushStats sFrameStats;
+static BatchRenderer::FlushStats sLastFrameStats;
+
+const char* BatchRenderer::flushReasonToString( const FlushReason& reason ) {
+	switch ( reason ) {
+		case FlushReason::Draw:
+			return "draw";
+		case FlushReason::ForceRendering:
+			return "force rendering";
+		case FlushReason::Texture:
+			return "texture";
+		case FlushReason::BlendMode:
+			return "blend mode";
+		case FlushReason::DrawMode:
+			return "draw mode";
+		case FlushReason::Batcher:
+			return "batcher";
+		default:
+			return "unknown";
+	}
+}
+
+const BatchRenderer::FlushStats& BatchRenderer::getLastFrameStats() {
+	return sLastFrameStats;
+}
+
+const BatchRenderer::FlushStats& BatchRenderer::getFrameStats() {
+	return sFrameStats;
+}
+
+void BatchRenderer::endFrameStats() {
+	sLastFrameStats = sFrameStats;
+	sFrameStats = FlushStats();
+}
+
+void BatchRenderer::countFlush( const FlushReason& reason, const Uint32& numVertex,
+								const Uint32& deferredCommands ) {
+	sFrameStats.flushes++;
+	sFrameStats.vertexs += numVertex;
+	sFrameStats.deferredCommands += deferredCommands;
+	sFrameStats.reasons[static_cast<Uint32>( reason )]++;
+}
+
 BatchRenderer* BatchRenderer::New() {
 	return eeNew( BatchRenderer, () );
 }
@@ -25,7 +69,8 @@ BatchRenderer::BatchRenderer( const unsigned int& Prealloc ) {
 }
 
 BatchRenderer::~BatchRenderer() {
-	eeSAFE_DELETE_ARRAY( mVertex );
+	if ( NULL != mVertex )
+		eeFree( mVertex );
 }
 
 void BatchRenderer::init() {
@@ -33,15 +78,17 @@ void BatchRenderer::init() {
 }
 
 void BatchRenderer::allocVertexs( const unsigned int& size ) {
-	eeSAFE_DELETE_ARRAY( mVertex );
-	mVertex = eeNewArray( VertexData, size );
+	if ( NULL != mVertex )
+		eeFree( mVertex );
+
+	mVertex = static_cast<VertexData*>( eeMalloc( sizeof( VertexData ) * size ) );
 	mVertexSize = size;
 	mNumVertex = 0;
 }
 
 void BatchRenderer::drawOpt() {
 	if ( mForceRendering )
-		flush();
+		flush( FlushReason::ForceRendering );
 }
 
 void BatchRenderer::draw() {
@@ -50,7 +97,7 @@ void BatchRenderer::draw() {
 
 void BatchRenderer::setTexture( const Texture* texture, Texture::CoordinateType coordinateType ) {
 	if ( mTexture != texture || mCoordinateType != coordinateType )
-		flush();
+		flush( FlushReason::Texture );
 
 	mTexture = texture;
 	mCoordinateType = coordinateType;
@@ -58,7 +105,7 @@ void BatchRenderer::setTexture( const Texture* texture, Texture::CoordinateType
 
 void BatchRenderer::setBlendMode( const BlendMode& blend ) {
 	if ( blend != mBlend )
-		flush();
+		flush( FlushReason::BlendMode );
 
 	if ( mBlend != blend )
 		mBlend = blend;
@@ -68,34 +115,42 @@ void BatchRenderer::addVertexs( const unsigned int& num ) {
 	mNumVertex += num;
 
 	if ( ( mNumVertex + num ) >= mVertexSize ) {
-		VertexData* newVertex = eeNewArray( VertexData, mVertexSize * 2 );
+		unsigned int newSize = eemax( 1u, mVertexSize * 2 );
 
-		for ( Uint32 i = 0; i < mVertexSize; i++ )
-			newVertex[i] = mVertex[i];
+		while ( newSize <= mNumVertex + num )
+			newSize *= 2;
 
-		eeSAFE_DELETE_ARRAY( mVertex );
-		mVertex = newVertex;
-		mVertexSize = mVertexSize * 2;
+		// VertexData only holds plain values, so the vertexs can be moved by realloc.
+		mVertex = static_cast<VertexData*>(
+			eeRealloc( static_cast<void*>( mVertex ), sizeof( VertexData ) * newSize ) );
+		mVertexSize = newSize;
 	}
 }
 
 void BatchRenderer::setDrawMode( const PrimitiveType& Mode, const bool& Force ) {
 	if ( Force && mCurrentMode != Mode ) {
-		flush();
+		flush( FlushReason::DrawMode );
 		mCurrentMode = Mode;
 	}
 }
 
-void BatchRenderer::flush() {
+void BatchRenderer::flush( const FlushReason& reason ) {
 	if ( mNumVertex == 0 )
 		return;
 
 	if ( GlobalBatchRenderer::instance() != this )
-		GlobalBatchRenderer::instance()->draw();
+		static_cast<BatchRenderer*>( GlobalBatchRenderer::instance() )
+			->flush( FlushReason::Batcher );
 
 	Uint32 NumVertex = mNumVertex;
 	mNumVertex = 0;
 
+	countFlush( reason, NumVertex );
+
+	render( mVertex, NumVertex );
+}
+
+void BatchRenderer::render( VertexData* vertexs, const Uint32& NumVertex ) {
 	bool createMatrix = ( mRotation || mScale != 1.0f || mPosition.x || mPosition.y );
 
 	BlendMode::setMode( mBlend );
@@ -119,18 +174,28 @@ void BatchRenderer::flush() {
 
 	if ( NULL != mTexture ) {
 		const_cast<Texture*>( mTexture )->bind( mCoordinateType );
-		GLi->texCoordPointer( 2, GL_FP, sizeof( VertexData ),
-							  reinterpret_cast<char*>( &mVertex[0] ) + sizeof( Vector2f ), alloc );
 	} else {
 		GLi->disable( GL_TEXTURE_2D );
 		GLi->disableClientState( GL_TEXTURE_COORD_ARRAY );
 	}
 
-	GLi->vertexPointer( 2, GL_FP, sizeof( VertexData ), reinterpret_cast<char*>( &mVertex[0] ),
-						alloc );
-	GLi->colorPointer(
-		4, GL_UNSIGNED_BYTE, sizeof( VertexData ),
-		reinterpret_cast<char*>( &mVertex[0] ) + sizeof( Vector2f ) + sizeof( Vector2f ), alloc );
+	// Renderers with a streaming buffer get all the batches of the frame in one vertex buffer,
+	// the others use the client-side arrays.
+	if ( !GLi->streamVertexs( vertexs, alloc, sizeof( VertexData ),
+							  NULL != mTexture ? sizeof( Vector2f ) : -1,
+							  sizeof( Vector2f ) + sizeof( Vector2f ) ) ) {
+		if ( NULL != mTexture )
+			GLi->texCoordPointer( 2, GL_FP, sizeof( VertexData ),
+								  reinterpret_cast<char*>( &vertexs[0] ) + sizeof( Vector2f ),
+								  alloc );
+
+		GLi->vertexPointer( 2, GL_FP, sizeof( VertexData ), reinterpret_cast<char*>( &vertexs[0] ),
+							alloc );
+		GLi->colorPointer( 4, GL_UNSIGNED_BYTE, sizeof( VertexData ),
+						   reinterpret_cast<char*>( &vertexs[0] ) + sizeof( Vector2f ) +
+							   sizeof( Vector2f ),
+						   alloc );
+	}
 
 	if ( !GLi->quadsSupported() ) {
 		if ( PRIMITIVE_QUADS == mCurrentMode ) {
@@ -1,13 +1,214 @@
 #include <eepp/graphics/globalbatchrenderer.hpp>
+#include <cstring>
+#include <eepp/math/math.hpp>
 
 namespace EE { namespace Graphics {
 
 SINGLETON_DECLARE_IMPLEMENTATION( GlobalBatchRenderer )
 
+bool GlobalBatchRenderer::DeferredCommand::sameState( const DeferredCommand& other ) const {
+	return texture == other.texture && coordinateType == other.coordinateType &&
+		   blend == other.blend && mode == other.mode && rotation == other.rotation &&
+		   scale == other.scale && position == other.position && center == other.center;
+}
+
+bool GlobalBatchRenderer::DeferredCommand::canMerge() const {
+	return mode == PRIMITIVE_QUADS || mode == PRIMITIVE_TRIANGLES;
+}
+
+void GlobalBatchRenderer::groupCommands( const std::vector<DeferredCommand>& commands,
+										 std::vector<DeferredGroup>& groups,
+										 const Uint32& lookBack ) {
+	groups.clear();
+
+	for ( Uint32 i = 0; i < commands.size(); i++ ) {
+		const DeferredCommand& command = commands[i];
+		DeferredGroup* target = NULL;
+
+		if ( command.canMerge() ) {
+			Uint32 checked = 0;
+
+			for ( size_t g = groups.size(); g > 0 && checked < lookBack; g--, checked++ ) {
+				DeferredGroup& group = groups[g - 1];
+				const DeferredCommand& first = commands[group.commands.front()];
+
+				if ( first.sameState( command ) ) {
+					target = &group;
+					break;
+				}
+
+				// Lines and points bounds don't include the line width or point size, so they are
+				// never skipped.
+				if ( !first.canMerge() || group.bounds.overlap( command.bounds ) )
+					break;
+			}
+		}
+
+		if ( NULL == target ) {
+			groups.emplace_back();
+			target = &groups.back();
+			target->bounds = command.bounds;
+		} else {
+			target->bounds.expand( command.bounds );
+		}
+
+		target->commands.push_back( i );
+		target->numVertex += command.numVertex;
+	}
+}
+
 GlobalBatchRenderer::GlobalBatchRenderer() {
 	allocVertexs( 4096 );
 }
 
 GlobalBatchRenderer::~GlobalBatchRenderer() {}
 
+void GlobalBatchRenderer::setDeferred( bool deferred ) {
+	if ( mDeferred == deferred )
+		return;
+
+	flush();
+
+	mDeferred = deferred;
+}
+
+bool GlobalBatchRenderer::isDeferred() const {
+	return mDeferred;
+}
+
+void GlobalBatchRenderer::flush( const FlushReason& reason ) {
+	if ( !mDeferred ) {
+		BatchRenderer::flush( reason );
+		return;
+	}
+
+	recordCommand();
+
+	switch ( reason ) {
+		case FlushReason::Texture:
+		case FlushReason::BlendMode:
+		case FlushReason::DrawMode:
+			break;
+		default:
+			renderCommands( reason );
+	}
+}
+
+void GlobalBatchRenderer::recordCommand() {
+	if ( mNumVertex == mCommandStart )
+		return;
+
+	DeferredCommand command;
+	command.texture = mTexture;
+	command.coordinateType = mCoordinateType;
+	command.blend = mBlend;
+	command.mode = mCurrentMode;
+	command.rotation = mRotation;
+	command.scale = mScale;
+	command.position = mPosition;
+	command.center = mCenter;
+	command.start = mCommandStart;
+	command.numVertex = mNumVertex - mCommandStart;
+
+	Rectf bounds( mVertex[mCommandStart].pos.x, mVertex[mCommandStart].pos.y,
+				  mVertex[mCommandStart].pos.x, mVertex[mCommandStart].pos.y );
+
+	for ( Uint32 i = mCommandStart + 1; i < mNumVertex; i++ )
+		bounds.expand( mVertex[i].pos );
+
+	if ( mRotation || mScale != 1.0f || mPosition.x || mPosition.y ) {
+		// Same transform than the one applied by BatchRenderer::render, expanded one pixel to
+		// absorb the rounding errors.
+		Float cosA = Math::cosAng( mRotation );
+		Float sinA = Math::sinAng( mRotation );
+		Vector2f corners[4] = { { bounds.Left, bounds.Top },
+								{ bounds.Right, bounds.Top },
+								{ bounds.Right, bounds.Bottom },
+								{ bounds.Left, bounds.Bottom } };
+
+		for ( int i = 0; i < 4; i++ ) {
+			Vector2f p( ( corners[i].x - mCenter.x ) * mScale.x,
+						( corners[i].y - mCenter.y ) * mScale.y );
+			corners[i] = Vector2f( mPosition.x + mCenter.x + p.x * cosA - p.y * sinA,
+								   mPosition.y + mCenter.y + p.x * sinA + p.y * cosA );
+		}
+
+		bounds = Rectf( corners[0].x, corners[0].y, corners[0].x, corners[0].y );
+
+		for ( int i = 1; i < 4; i++ )
+			bounds.expand( corners[i] );
+
+		bounds = Rectf( bounds.Left - 1, bounds.Top - 1, bounds.Right + 1, bounds.Bottom + 1 );
+	}
+
+	command.bounds = bounds;
+
+	mCommands.push_back( command );
+	mCommandStart = mNumVertex;
+}
+
+void GlobalBatchRenderer::renderCommands( const FlushReason& reason ) {
+	if ( mCommands.empty() )
+		return;
+
+	groupCommands( mCommands, mGroups );
+
+	mGroupVertex.resize( mNumVertex );
+
+	VertexData* vertexs = mGroupVertex.data();
+
+	for ( const auto& group : mGroups ) {
+		for ( const auto& index : group.commands ) {
+			const DeferredCommand& command = mCommands[index];
+			memcpy( static_cast<void*>( vertexs ), static_cast<void*>( &mVertex[command.start] ),
+					sizeof( VertexData ) * command.numVertex );
+			vertexs += command.numVertex;
+		}
+	}
+
+	const Texture* texture = mTexture;
+	Texture::CoordinateType coordinateType = mCoordinateType;
+	BlendMode blend = mBlend;
+	PrimitiveType mode = mCurrentMode;
+	Float rotation = mRotation;
+	Vector2f scale = mScale;
+	Vector2f position = mPosition;
+	Vector2f center = mCenter;
+
+	vertexs = mGroupVertex.data();
+
+	for ( size_t i = 0; i < mGroups.size(); i++ ) {
+		const DeferredGroup& group = mGroups[i];
+		const DeferredCommand& state = mCommands[group.commands.front()];
+
+		mTexture = state.texture;
+		mCoordinateType = state.coordinateType;
+		mBlend = state.blend;
+		mCurrentMode = state.mode;
+		mRotation = state.rotation;
+		mScale = state.scale;
+		mPosition = state.position;
+		mCenter = state.center;
+
+		countFlush( reason, group.numVertex, i == 0 ? mCommands.size() : 0 );
+
+		render( vertexs, group.numVertex );
+
+		vertexs += group.numVertex;
+	}
+
+	mTexture = texture;
+	mCoordinateType = coordinateType;
+	mBlend = blend;
+	mCurrentMode = mode;
+	mRotation = rotation;
+	mScale = scale;
+	mPosition = position;
+	mCenter = center;
+
+	mCommands.clear();
+	mNumVertex = 0;
+	mCommandStart = 0;
+}
+
 }} // namespace EE::Graphics
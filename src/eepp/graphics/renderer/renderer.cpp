@@ -506,6 +506,10 @@ void Renderer::blitFrameBuffer( int srcX0, int srcY0, int srcX1, int srcY1, int
 								filter );
 }
 
+bool Renderer::streamVertexs( const void*, unsigned int, int, int, int ) {
+	return false;
+}
+
 void Renderer::setShader( ShaderProgram* Shader ) {
 #ifdef EE_SHADERS_SUPPORTED
 	if ( NULL != Shader ) {
@@ -51,6 +51,8 @@ RendererGL3CP::RendererGL3CP() :
 	mCurTexCoordArray( 0 ),
 	mVBOSizeAlloc( 1024 * 1024 ),
 	mBiggestAlloc( 0 ),
+	mStreamVBO( 0 ),
+	mStreamRing( 4 * 1024 * 1024 ),
 	mLoaded( false ) {
 	mQuadsSupported = false;
 	mQuadVertexs = 6;
@@ -63,6 +65,9 @@ RendererGL3CP::~RendererGL3CP() {
 		}
 	}
 
+	if ( 0 != mStreamVBO )
+		glDeleteBuffersARB( 1, &mStreamVBO );
+
 	deleteVertexArrays( 1, &mVAO );
 
 #ifdef EE_DEBUG
@@ -132,6 +137,9 @@ void RendererGL3CP::init() {
 
 	allocateBuffers( mVBOSizeAlloc );
 
+	glGenBuffersARB( 1, &mStreamVBO );
+	mStreamRing.reset();
+
 	clientActiveTexture( GL_TEXTURE0 );
 
 	setShader( mShaders[EEGL3CP_SHADER_BASE] );
@@ -442,6 +450,55 @@ void RendererGL3CP::texCoordPointer( int size, unsigned int type, int stride, co
 	}
 }
 
+bool RendererGL3CP::streamVertexs( const void* data, unsigned int size, int stride,
+								   int texCoordOffset, int colorOffset ) {
+	if ( 0 == mStreamVBO )
+		return false;
+
+#ifdef EE_DEBUG
+	mBiggestAlloc = eemax( mBiggestAlloc, size );
+#endif
+
+	bindVertexArray( mVAO );
+
+	VertexBufferRing::Slice slice = mStreamRing.allocate( size );
+
+	glBindBufferARB( GL_ARRAY_BUFFER, mStreamVBO );
+
+	// Orphaning gives the buffer new storage, the draws still using the old one are not waited.
+	if ( slice.orphan )
+		glBufferDataARB( GL_ARRAY_BUFFER, mStreamRing.getCapacity(), NULL, GL_STREAM_DRAW );
+
+	glBufferSubDataARB( GL_ARRAY_BUFFER, slice.offset, size, data );
+
+	streamAttribPointer( mAttribsLoc[EEGL_VERTEX_ARRAY], mAttribsLocStates[EEGL_VERTEX_ARRAY], 2,
+						 GL_FP, false, stride, slice.offset );
+
+	streamAttribPointer( mAttribsLoc[EEGL_COLOR_ARRAY], mAttribsLocStates[EEGL_COLOR_ARRAY], 4,
+						 GL_UNSIGNED_BYTE, true, stride, slice.offset + colorOffset );
+
+	if ( -1 != texCoordOffset )
+		streamAttribPointer( mTextureUnits[mCurActiveTex], mTextureUnitsStates[mCurActiveTex], 2,
+							 GL_FP, false, stride, slice.offset + texCoordOffset );
+
+	return true;
+}
+
+void RendererGL3CP::streamAttribPointer( const int& index, int& state, int size, unsigned int type,
+										 bool normalized, int stride, const Uint32& offset ) {
+	if ( -1 == index )
+		return;
+
+	if ( 0 == state ) {
+		state = 1;
+
+		glEnableVertexAttribArray( index );
+	}
+
+	glVertexAttribPointerARB( index, size, type, normalized ? GL_TRUE : GL_FALSE, stride,
+							  reinterpret_cast<const void*>( static_cast<uintptr_t>( offset ) ) );
+}
+
 int RendererGL3CP::getStateIndex( const Uint32& State ) {
 	eeASSERT( State < EEGL_ARRAY_STATES_COUNT );
 
@@ -0,0 +1,49 @@
+#include <eepp/core/core.hpp>
+#include <eepp/graphics/renderer/vertexbufferring.hpp>
+
+namespace EE { namespace Graphics {
+
+VertexBufferRing::VertexBufferRing( const Uint32& capacity, const Uint32& alignment ) :
+	mCapacity( eemax<Uint32>( 1, capacity ) ), mAlignment( eemax<Uint32>( 1, alignment ) ) {}
+
+VertexBufferRing::Slice VertexBufferRing::allocate( const Uint32& size ) {
+	Slice slice;
+	Uint32 offset = ( ( mOffset + mAlignment - 1 ) / mAlignment ) * mAlignment;
+
+	if ( size > mCapacity ) {
+		while ( mCapacity < size )
+			mCapacity *= 2;
+		mNeedsOrphan = true;
+	}
+
+	if ( mNeedsOrphan || offset + size > mCapacity ) {
+		offset = 0;
+		slice.orphan = true;
+		mNeedsOrphan = false;
+		mOrphanCount++;
+	}
+
+	slice.offset = offset;
+	mOffset = offset + size;
+
+	return slice;
+}
+
+void VertexBufferRing::reset() {
+	mOffset = 0;
+	mNeedsOrphan = true;
+}
+
+const Uint32& VertexBufferRing::getCapacity() const {
+	return mCapacity;
+}
+
+const Uint32& VertexBufferRing::getOffset() const {
+	return mOffset;
+}
+
+const Uint32& VertexBufferRing::getOrphanCount() const {
+	return mOrphanCount;
+}
+
+}} // namespace EE::Graphics
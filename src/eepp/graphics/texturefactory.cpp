@@ -6,14 +6,41 @@
 #include <eepp/graphics/texture.hpp>
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/graphics/textureloader.hpp>
+#include <eepp/system/clock.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/lock.hpp>
 #include <eepp/system/log.hpp>
+#include <eepp/system/packmanager.hpp>
+#include <eepp/system/sys.hpp>
 #include <jpeg-compressor/jpge.h>
 
 namespace EE { namespace Graphics {
 
 SINGLETON_DECLARE_IMPLEMENTATION( TextureFactory )
 
+struct TextureFactory::AsyncLoad {
+	Uint32 texId{ 0 };
+	std::string filepath;
+	Pack* pack{ NULL };
+	bool mipmap{ false };
+	Texture::ClampMode clampMode{ Texture::ClampMode::ClampToEdge };
+	bool compressTexture{ false };
+	bool keepLocalCopy{ false };
+	Image::FormatConfiguration formatConfiguration;
+	std::unique_ptr<TextureLoader> loader;
+	Clock requested;
+	std::atomic<bool> canceled{ false };
+};
+
+double TextureFactory::AsyncLoadStats::getDecodeThroughput() const {
+	return decodeTime > Time::Zero ? decodedBytes / decodeTime.asSeconds() : 0;
+}
+
+Time TextureFactory::AsyncLoadStats::getAverageLatency() const {
+	return uploadedCount > 0 ? Microseconds( totalLatency.asMicroseconds() / uploadedCount )
+							 : Time::Zero;
+}
+
 TextureFactory::TextureFactory() :
 	mCurrentTexture( EE_MAX_TEXTURE_UNITS ),
 	mMemSize( 0 ),
@@ -28,6 +55,23 @@ const Texture::CoordinateType& TextureFactory::getLastCoordinateType() const {
 }
 
 TextureFactory::~TextureFactory() {
+	{
+		Lock l( mAsyncMutex );
+
+		for ( auto& load : mAsyncLoads )
+			load.second->canceled = true;
+
+		mAsyncLoads.clear();
+		mAsyncDecoded.clear();
+	}
+
+	// The decode tasks use the factory, the canceled ones return as soon as they start. The pool
+	// can be shared, so releasing it doesn't wait for them.
+	while ( mAsyncTasks > 0 )
+		Sys::sleep( Milliseconds( 1 ) );
+
+	mAsyncPool.reset();
+
 	unloadTextures();
 }
 
@@ -94,6 +138,275 @@ Uint32 TextureFactory::loadFromFile( const std::string& Filepath, const bool& Mi
 	return myTex.getId();
 }
 
+Uint32 TextureFactory::loadFromFileAsync( const std::string& Filepath, const bool& Mipmap,
+										  const Texture::ClampMode& ClampMode,
+										  const bool& CompressTexture, const bool& KeepLocalCopy,
+										  const Image::FormatConfiguration& imageformatConfiguration ) {
+	std::shared_ptr<AsyncLoad> load( std::make_shared<AsyncLoad>() );
+	load->filepath = Filepath;
+	load->mipmap = Mipmap;
+	load->clampMode = ClampMode;
+	load->compressTexture = CompressTexture;
+	load->keepLocalCopy = KeepLocalCopy;
+	load->formatConfiguration = imageformatConfiguration;
+	return loadAsync( load );
+}
+
+Uint32 TextureFactory::loadFromPackAsync( Pack* Pack, const std::string& FilePackPath,
+										  const bool& Mipmap, const Texture::ClampMode& ClampMode,
+										  const bool& CompressTexture, const bool& KeepLocalCopy,
+										  const Image::FormatConfiguration& imageformatConfiguration ) {
+	std::shared_ptr<AsyncLoad> load( std::make_shared<AsyncLoad>() );
+	load->filepath = FilePackPath;
+	load->pack = Pack;
+	load->mipmap = Mipmap;
+	load->clampMode = ClampMode;
+	load->compressTexture = CompressTexture;
+	load->keepLocalCopy = KeepLocalCopy;
+	load->formatConfiguration = imageformatConfiguration;
+	return loadAsync( load );
+}
+
+Uint32 TextureFactory::loadAsync( const std::shared_ptr<AsyncLoad>& load ) {
+	static const Uint8 placeholder[4] = { 0, 0, 0, 0 };
+
+	load->texId =
+		loadFromPixels( placeholder, 1, 1, 4, false, load->clampMode, false, false, load->filepath );
+
+	if ( 0 == load->texId )
+		return 0;
+
+	{
+		Lock l( mAsyncMutex );
+
+		mAsyncLoads[load->texId] = load;
+		mAsyncPending++;
+
+		if ( !mAsyncPool )
+			mAsyncPool = ThreadPool::createShared( eeclamp( Sys::getCPUCount() - 1, 1, 4 ) );
+	}
+
+	mAsyncTasks++;
+	mAsyncPool->run( [this, load] {
+		decodeAsync( load );
+		mAsyncTasks--;
+	} );
+
+	return load->texId;
+}
+
+void TextureFactory::decodeAsync( const std::shared_ptr<AsyncLoad>& load ) {
+	if ( load->canceled )
+		return;
+
+	Clock clock;
+	std::vector<Uint8> buffer( getStagingBuffer() );
+	Pack* pack = load->pack;
+	bool read = false;
+
+	if ( NULL == pack && !FileSystem::fileExists( load->filepath ) &&
+		 PackManager::instance()->isFallbackToPacksActive() )
+		pack = PackManager::instance()->exists( load->filepath );
+
+	if ( NULL != pack ) {
+		read = pack->isOpen() && pack->extractFileToMemory( load->filepath, buffer );
+	} else {
+		read = FileSystem::fileGet( load->filepath, buffer );
+	}
+
+	if ( read && !buffer.empty() ) {
+		load->loader.reset( eeNew( TextureLoader, ( buffer.data(), buffer.size(), load->mipmap,
+													load->clampMode, load->compressTexture,
+													load->keepLocalCopy ) ) );
+		load->loader->setFormatConfiguration( load->formatConfiguration );
+		load->loader->setTargetTexture( load->texId );
+		load->loader->decode();
+	} else {
+		Log::warning( "Texture %s failed to load.", load->filepath.c_str() );
+	}
+
+	Uint64 size = buffer.size();
+
+	releaseStagingBuffer( std::move( buffer ) );
+
+	Lock l( mAsyncMutex );
+
+	mAsyncStats.decodedCount++;
+	mAsyncStats.decodedBytes += size;
+	mAsyncStats.decodeTime += clock.getElapsedTime();
+
+	if ( !load->canceled )
+		mAsyncDecoded.push_back( load );
+}
+
+void TextureFactory::processAsyncUploads() {
+	if ( 0 == mAsyncPending )
+		return;
+
+	Clock clock;
+	Uint64 bytes = 0;
+	Uint32 uploaded = 0;
+
+	while ( 0 == uploaded ||
+			( clock.getElapsedTime() < mUploadTimeBudget && bytes < mUploadBytesBudget ) ) {
+		std::shared_ptr<AsyncLoad> load;
+
+		{
+			Lock l( mAsyncMutex );
+
+			if ( mAsyncDecoded.empty() )
+				break;
+
+			load = mAsyncDecoded.front();
+			mAsyncDecoded.pop_front();
+
+			// Canceled loads were already removed from the pending loads.
+			if ( load->canceled )
+				continue;
+
+			mAsyncLoads.erase( load->texId );
+			mAsyncPending--;
+		}
+
+		Clock uploadClock;
+		Uint32 memSize = 0;
+		Texture* texture = NULL;
+
+		if ( load->loader ) {
+			load->loader->upload();
+
+			texture = load->loader->getTexture();
+
+			if ( NULL != texture )
+				memSize = texture->getMemSize();
+		}
+
+		bytes += memSize;
+		uploaded++;
+
+		Lock l( mAsyncMutex );
+
+		if ( NULL == texture ) {
+			mAsyncStats.failedCount++;
+			continue;
+		}
+
+		Time latency = load->requested.getElapsedTime();
+		mAsyncStats.uploadedCount++;
+		mAsyncStats.uploadedBytes += memSize;
+		mAsyncStats.uploadTime += uploadClock.getElapsedTime();
+		mAsyncStats.totalLatency += latency;
+		mAsyncStats.maxLatency = eemax( mAsyncStats.maxLatency, latency );
+	}
+}
+
+bool TextureFactory::isLoadingAsync( const Uint32& TexId ) {
+	if ( 0 == mAsyncPending )
+		return false;
+
+	Lock l( mAsyncMutex );
+	return mAsyncLoads.find( TexId ) != mAsyncLoads.end();
+}
+
+void TextureFactory::cancelAsyncLoad( const Uint32& TexId ) {
+	if ( 0 == mAsyncPending )
+		return;
+
+	Lock l( mAsyncMutex );
+	auto it = mAsyncLoads.find( TexId );
+
+	if ( it == mAsyncLoads.end() )
+		return;
+
+	it->second->canceled = true;
+	mAsyncLoads.erase( it );
+	mAsyncPending--;
+}
+
+void TextureFactory::setAsyncUploadBudget( const Time& timeBudget, const Uint64& bytesBudget ) {
+	mUploadTimeBudget = timeBudget;
+	mUploadBytesBudget = bytesBudget;
+}
+
+void TextureFactory::setAsyncLoaderThreadPool( std::shared_ptr<ThreadPool> pool ) {
+	Lock l( mAsyncMutex );
+	mAsyncPool = pool;
+}
+
+TextureFactory::AsyncLoadStats TextureFactory::getAsyncLoadStats() {
+	Lock l( mAsyncMutex );
+	AsyncLoadStats stats( mAsyncStats );
+	stats.pending = mAsyncPending;
+	return stats;
+}
+
+std::vector<Uint8> TextureFactory::getStagingBuffer() {
+	Lock l( mAsyncMutex );
+
+	if ( mStagingBuffers.empty() )
+		return {};
+
+	std::vector<Uint8> buffer( std::move( mStagingBuffers.back() ) );
+	mStagingBuffers.pop_back();
+	return buffer;
+}
+
+void TextureFactory::releaseStagingBuffer( std::vector<Uint8>&& buffer ) {
+	// Keeps a few buffers to read the next images without allocating, but not the big ones.
+	if ( buffer.capacity() > 16 * 1024 * 1024 )
+		return;
+
+	buffer.clear();
+
+	Lock l( mAsyncMutex );
+
+	if ( mStagingBuffers.size() < 8 )
+		mStagingBuffers.emplace_back( std::move( buffer ) );
+}
+
+Uint32 TextureFactory::replaceTexture( const Uint32& TexId, const Uint32& GLTexId,
+									   const unsigned int& Width, const unsigned int& Height,
+									   const unsigned int& ImgWidth, const unsigned int& ImgHeight,
+									   const bool& Mipmap, const unsigned int& Channels,
+									   const Texture::ClampMode& ClampMode,
+									   const bool& CompressTexture, const bool& LocalCopy,
+									   const Uint32& MemSize ) {
+	lock();
+
+	Texture* Tex = existsId( TexId ) ? mTextures[TexId] : NULL;
+
+	if ( NULL == Tex ) {
+		unlock();
+
+		GLuint glTexId = GLTexId;
+		glDeleteTextures( 1, &glTexId );
+
+		return 0;
+	}
+
+	for ( Uint32 i = 0; i < EE_MAX_TEXTURE_UNITS; i++ ) {
+		if ( mCurrentTexture[i] == Tex->getHandle() )
+			mCurrentTexture[i] = 0;
+	}
+
+	mMemSize -= Tex->getMemSize();
+	mMemSize += MemSize;
+
+	unlock();
+
+	// The texture sends the change event on create, so it's done without holding the lock.
+	Tex->deleteTexture();
+	Tex->create( GLTexId, Width, Height, ImgWidth, ImgHeight, Mipmap, Channels, Tex->getFilepath(),
+				 ClampMode, CompressTexture, MemSize );
+
+	if ( LocalCopy ) {
+		Tex->lock();
+		Tex->unlock( true, false );
+	}
+
+	return TexId;
+}
+
 Uint32 TextureFactory::pushTexture( const std::string& Filepath, const Uint32& TexId,
 									const unsigned int& Width, const unsigned int& Height,
 									const unsigned int& ImgWidth, const unsigned int& ImgHeight,
@@ -229,6 +542,8 @@ bool TextureFactory::remove( Texture* texture ) {
 }
 
 void TextureFactory::removeReference( Texture* Tex ) {
+	cancelAsyncLoad( Tex->getTextureId() );
+
 	mMemSize -= Tex->getMemSize();
 
 	int glTexId = Tex->getHandle();
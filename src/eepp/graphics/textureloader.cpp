@@ -168,6 +168,11 @@ TextureLoader::~TextureLoader() {
 }
 
 void TextureLoader::load() {
+	decode();
+	upload();
+}
+
+void TextureLoader::decode() {
 	mTE.restart();
 
 	if ( TEX_LT_PATH == mLoadType )
@@ -180,10 +185,16 @@ void TextureLoader::load() {
 		loadFromStream();
 
 	mTexLoaded = true;
+}
 
+void TextureLoader::upload() {
 	loadFromPixels();
 }
 
+void TextureLoader::setTargetTexture( const Uint32& texId ) {
+	mTargetTexId = texId;
+}
+
 void TextureLoader::loadFile() {
 	IOStreamFile fs( mFilepath );
 
@@ -424,9 +435,16 @@ void TextureLoader::loadFromPixels() {
 					}
 				}
 
-				mTexId = TextureFactory::instance()->pushTexture(
-					mFilepath, tTexId, width, height, mImgWidth, mImgHeight, mMipmap, mChannels,
-					mClampMode, mCompressTexture || mIsCompressed, mLocalCopy, mSize );
+				if ( 0 != mTargetTexId ) {
+					mTexId = TextureFactory::instance()->replaceTexture(
+						mTargetTexId, tTexId, width, height, mImgWidth, mImgHeight, mMipmap,
+						mChannels, mClampMode, mCompressTexture || mIsCompressed, mLocalCopy,
+						mSize );
+				} else {
+					mTexId = TextureFactory::instance()->pushTexture(
+						mFilepath, tTexId, width, height, mImgWidth, mImgHeight, mMipmap, mChannels,
+						mClampMode, mCompressTexture || mIsCompressed, mLocalCopy, mSize );
+				}
 
 				if ( mFilepath.empty() ) {
 					Log::info( "Texture ID %d loaded in %4.3f ms.", mTexId,
@@ -32,6 +32,10 @@ void VertexBufferOGL::draw() {
 	}
 }
 
+void VertexBufferOGL::draw( const Uint32& firstVertex, const Uint32& vertexCount ) {
+	GLi->drawArrays( mDrawType, firstVertex, vertexCount );
+}
+
 void VertexBufferOGL::setVertexStates() {
 	Uint32 alloc = getVertexCount() * sizeof( Vector2f );
 	Uint32 allocC = getVertexCount() * sizeof( Color );
@@ -113,6 +117,8 @@ void VertexBufferOGL::unbind() {
 
 void VertexBufferOGL::update( const Uint32&, bool ) {}
 
+void VertexBufferOGL::update( const Uint32&, const Uint32&, const Uint32& ) {}
+
 void VertexBufferOGL::reload() {}
 
 }} // namespace EE::Graphics
@@ -188,6 +188,31 @@ void VertexBufferVBO::draw() {
 	}
 }
 
+void VertexBufferVBO::draw( const Uint32& firstVertex, const Uint32& vertexCount ) {
+	if ( !mCompiled )
+		return;
+
+	int curVAO = 0;
+#ifndef EE_GLES
+	if ( GLv_3CP == GLi->version() ) {
+		glGetIntegerv( GL_VERTEX_ARRAY_BINDING, &curVAO );
+		GLi->bindVertexArray( mVAO );
+	}
+#endif
+
+	if ( GLv_3 == GLi->version() || GLv_3CP == GLi->version() || GLv_ES2 == GLi->version() ) {
+		if ( !mTextured ) {
+			GLi->disable( GL_TEXTURE_2D );
+		}
+	}
+
+	GLi->drawArrays( mDrawType, firstVertex, vertexCount );
+
+	if ( GLv_3CP == GLi->version() ) {
+		GLi->bindVertexArray( curVAO );
+	}
+}
+
 void VertexBufferVBO::setVertexStates() {
 #ifdef EE_GL3_ENABLED
 	int index;
@@ -393,6 +418,45 @@ void VertexBufferVBO::update( const Uint32& types, bool indices ) {
 	mBuffersSet = false;
 }
 
+void VertexBufferVBO::update( const Uint32& types, const Uint32& firstVertex,
+							  const Uint32& vertexCount ) {
+	// Not uploaded yet, the whole buffer will be uploaded when compiled.
+	if ( !mCompiled || firstVertex >= getVertexCount() )
+		return;
+
+	Uint32 count = eemin( vertexCount, getVertexCount() - firstVertex );
+
+	for ( Int32 i = 0; i < VERTEX_FLAGS_COUNT; i++ ) {
+		if ( VERTEX_FLAG_QUERY( mVertexFlags, i ) && VERTEX_FLAG_QUERY( types, i ) &&
+			 mArrayHandle[i] ) {
+			glBindBufferARB( GL_ARRAY_BUFFER, mArrayHandle[i] );
+
+			switch ( i ) {
+				case VERTEX_FLAG_POSITION:
+					glBufferSubDataARB( GL_ARRAY_BUFFER, firstVertex * sizeof( Vector2f ),
+										count * sizeof( Vector2f ), &mPosArray[firstVertex] );
+					break;
+				case VERTEX_FLAG_TEXTURE0:
+				case VERTEX_FLAG_TEXTURE1:
+				case VERTEX_FLAG_TEXTURE2:
+				case VERTEX_FLAG_TEXTURE3:
+					glBufferSubDataARB( GL_ARRAY_BUFFER, firstVertex * sizeof( Vector2f ),
+										count * sizeof( Vector2f ),
+										&mTexCoordArray[i - 1][firstVertex] );
+					break;
+				case VERTEX_FLAG_COLOR:
+					glBufferSubDataARB( GL_ARRAY_BUFFER, firstVertex * sizeof( Color ),
+										count * sizeof( Color ), &mColorArray[firstVertex] );
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
 void VertexBufferVBO::reload() {
 	mCompiled = false;
 	mBuffersSet = false;
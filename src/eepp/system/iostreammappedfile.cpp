@@ -0,0 +1,211 @@
+#include <cstring>
+#include <eepp/core/memorymanager.hpp>
+#include <eepp/core/string.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreamfile.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined( EE_PLATFORM_POSIX ) && EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN
+#define EE_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace EE { namespace System {
+
+IOStreamMappedFile* IOStreamMappedFile::New( const std::string& path, bool memoryFallback ) {
+	return eeNew( IOStreamMappedFile, ( path, memoryFallback ) );
+}
+
+IOStreamMappedFile::IOStreamMappedFile( const std::string& path, bool memoryFallback ) :
+	mData( NULL ),
+	mSize( 0 ),
+	mPos( 0 ),
+	mMapped( false ),
+	mOpen( false ),
+	mBuffer( NULL )
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	,
+	mFile( NULL ),
+	mMapping( NULL )
+#endif
+{
+	if ( !map( path ) && memoryFallback )
+		readIntoMemory( path );
+}
+
+IOStreamMappedFile::~IOStreamMappedFile() {
+	close();
+}
+
+bool IOStreamMappedFile::map( const std::string& path ) {
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	HANDLE file = CreateFileW( String::fromUtf8( path ).toWideString().c_str(), GENERIC_READ,
+							   FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+							   FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE )
+		return false;
+
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( file, &size ) ) {
+		CloseHandle( file );
+		return false;
+	}
+
+	if ( size.QuadPart == 0 ) {
+		CloseHandle( file );
+		mData = "";
+		mOpen = true;
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	if ( mapping == NULL ) {
+		CloseHandle( file );
+		return false;
+	}
+
+	void* data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	if ( data == NULL ) {
+		CloseHandle( mapping );
+		CloseHandle( file );
+		return false;
+	}
+
+	mFile = file;
+	mMapping = mapping;
+	mData = static_cast<const char*>( data );
+	mSize = static_cast<ios_size>( size.QuadPart );
+	mMapped = true;
+	mOpen = true;
+	return true;
+#elif defined( EE_HAS_MMAP )
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if ( fd == -1 )
+		return false;
+
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) ) {
+		::close( fd );
+		return false;
+	}
+
+	if ( st.st_size == 0 ) {
+		::close( fd );
+		mData = "";
+		mOpen = true;
+		return true;
+	}
+
+	void* data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	// The mapping keeps its own reference to the file.
+	::close( fd );
+
+	if ( data == MAP_FAILED )
+		return false;
+
+	mData = static_cast<const char*>( data );
+	mSize = static_cast<ios_size>( st.st_size );
+	mMapped = true;
+	mOpen = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool IOStreamMappedFile::readIntoMemory( const std::string& path ) {
+	IOStreamFile file( path );
+	if ( !file.isOpen() )
+		return false;
+	mSize = file.getSize();
+	mBuffer = eeNewArray( char, mSize + 1 );
+	mSize = file.read( mBuffer, mSize );
+	mBuffer[mSize] = '\0';
+	mData = mBuffer;
+	mOpen = true;
+	return true;
+}
+
+ios_size IOStreamMappedFile::read( char* data, ios_size size ) {
+	ios_size read = readAt( mPos, data, size );
+	mPos += read;
+	return read;
+}
+
+ios_size IOStreamMappedFile::readAt( ios_size position, char* data, ios_size size ) const {
+	if ( !mOpen || position < 0 || position >= mSize || size <= 0 )
+		return 0;
+	ios_size count = eemin( size, mSize - position );
+	std::memcpy( data, mData + position, static_cast<size_t>( count ) );
+	return count;
+}
+
+ios_size IOStreamMappedFile::write( const char*, ios_size ) {
+	return 0;
+}
+
+ios_size IOStreamMappedFile::seek( ios_size position ) {
+	mPos = eeclamp<ios_size>( position, 0, mSize );
+	return mPos;
+}
+
+ios_size IOStreamMappedFile::tell() {
+	return mOpen ? mPos : -1;
+}
+
+ios_size IOStreamMappedFile::getSize() {
+	return mSize;
+}
+
+bool IOStreamMappedFile::isOpen() {
+	return mOpen;
+}
+
+const char* IOStreamMappedFile::getData() const {
+	return mData;
+}
+
+const ios_size& IOStreamMappedFile::getLength() const {
+	return mSize;
+}
+
+bool IOStreamMappedFile::isMapped() const {
+	return mMapped;
+}
+
+void IOStreamMappedFile::close() {
+	if ( !mOpen )
+		return;
+
+	if ( mMapped ) {
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		UnmapViewOfFile( mData );
+		CloseHandle( (HANDLE)mMapping );
+		CloseHandle( (HANDLE)mFile );
+		mMapping = NULL;
+		mFile = NULL;
+#elif defined( EE_HAS_MMAP )
+		munmap( const_cast<char*>( mData ), mSize );
+#endif
+	}
+
+	eeSAFE_DELETE_ARRAY( mBuffer );
+	mData = NULL;
+	mSize = 0;
+	mPos = 0;
+	mMapped = false;
+	mOpen = false;
+}
+
+}} // namespace EE::System
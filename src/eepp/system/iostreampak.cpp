@@ -1,3 +1,4 @@
+#include <cstring>
 #include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/iostreampak.hpp>
 
@@ -8,12 +9,18 @@ IOStreamPak* IOStreamPak::New( Pak* pack, const std::string& path, bool writeMod
 }
 
 IOStreamPak::IOStreamPak( Pak* pack, const std::string& path, bool writeMode ) :
-	mFile( NULL ), mPos( 0 ), mOpen( false ) {
+	mFile( NULL ), mData( NULL ), mPos( 0 ), mOpen( false ) {
 	int index = -1;
 
 	if ( -1 != ( index = pack->exists( path ) ) ) {
 		mEntry = pack->getPackEntry( (Uint32)index );
 
+		if ( !writeMode && NULL != ( mData = pack->getEntryView( mEntry ) ) ) {
+			mMappedFile = pack->mMappedFile;
+			mOpen = true;
+			return;
+		}
+
 		mFile = IOStreamFile::New( pack->getPackPath(), ( writeMode ? "wb" : "rb" ) );
 
 		if ( mFile->isOpen() ) {
@@ -28,6 +35,14 @@ IOStreamPak::~IOStreamPak() {
 }
 
 ios_size IOStreamPak::read( char* data, ios_size size ) {
+	if ( isOpen() && NULL != mData ) {
+		ios_size available = mPos < (Int32)mEntry.file_length ? mEntry.file_length - mPos : 0;
+		size = eemin( size, available );
+		memcpy( data, mData + mPos, size );
+		mPos += size;
+		return size;
+	}
+
 	if ( isOpen() ) {
 		mFile->read( data, size );
 
@@ -38,7 +53,7 @@ ios_size IOStreamPak::read( char* data, ios_size size ) {
 }
 
 ios_size IOStreamPak::write( const char* data, ios_size size ) {
-	if ( isOpen() && static_cast<Uint32>( mPos ) + size < mEntry.file_length ) {
+	if ( isOpen() && NULL != mFile && static_cast<Uint32>( mPos ) + size < mEntry.file_length ) {
 		mFile->write( data, size );
 	}
 
@@ -47,7 +62,8 @@ ios_size IOStreamPak::write( const char* data, ios_size size ) {
 
 ios_size IOStreamPak::seek( ios_size position ) {
 	if ( isOpen() ) {
-		mFile->seek( mEntry.file_position + position );
+		if ( NULL != mFile )
+			mFile->seek( mEntry.file_position + position );
 		mPos = position;
 	}
 
@@ -10,13 +10,13 @@ IOStreamZip* IOStreamZip::New( Zip* pack, const std::string& path ) {
 }
 
 IOStreamZip::IOStreamZip( Zip* pack, const std::string& path ) :
-	mPath( path ), mZip( pack->getZip() ), mFile( NULL ), mPos( 0 ) {
-	struct zip_stat zs;
-	int err = zip_stat( mZip, path.c_str(), 0, &zs );
-
-	if ( !err ) {
-		mFile = zip_fopen_index( mZip, zs.index, 0 );
-	}
+	mPath( path ),
+	mZip( pack->getZip() ),
+	mIndex( pack->exists( path ) ),
+	mFile( NULL ),
+	mPos( 0 ) {
+	if ( -1 != mIndex )
+		mFile = zip_fopen_index( mZip, mIndex, 0 );
 }
 
 IOStreamZip::~IOStreamZip() {
@@ -47,12 +47,9 @@ ios_size IOStreamZip::seek( ios_size position ) {
 	if ( isOpen() && mPos != position ) {
 		zip_fclose( mFile );
 
-		struct zip_stat zs;
-		int err = zip_stat( mZip, mPath.c_str(), 0, &zs );
-
-		if ( !err ) {
-			mFile = zip_fopen_index( mZip, zs.index, 0 );
+		mFile = zip_fopen_index( mZip, mIndex, 0 );
 
+		if ( NULL != mFile ) {
 			if ( 0 != position ) {
 				ScopedBuffer ptr( position );
 				read( (char*)ptr.get(), position );
@@ -73,7 +70,7 @@ ios_size IOStreamZip::tell() {
 
 ios_size IOStreamZip::getSize() {
 	struct zip_stat zs;
-	int err = zip_stat( mZip, mPath.c_str(), 0, &zs );
+	int err = -1 != mIndex ? zip_stat_index( mZip, mIndex, 0, &zs ) : -1;
 	return !err ? zs.size : 0;
 }
 
@@ -1,6 +1,7 @@
 #include <cstdarg>
 #include <eepp/system/log.hpp>
 #include <iostream>
+#include <limits>
 
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
 #include <android/log.h>
@@ -20,6 +21,11 @@ namespace EE { namespace System {
 
 SINGLETON_DECLARE_IMPLEMENTATION( Log )
 
+/* Number of messages that can be queued in asynchronous mode (a power of two) */
+static constexpr size_t RING_SIZE = 4096;
+/* Bytes written by the writer thread at once */
+static constexpr size_t BATCH_SIZE = 64 * 1024;
+
 std::unordered_map<std::string, LogLevel> Log::getMapFlag() {
 	return { { "debug", LogLevel::Debug },	 { "info", LogLevel::Info },
 			 { "notice", LogLevel::Notice }, { "warning", LogLevel::Warning },
@@ -70,6 +76,8 @@ void Log::setFilePath( const std::string& filePath ) {
 Log::~Log() {
 	writel( LogLevel::Info, "eepp stoped\n" );
 
+	setAsync( false );
+
 	if ( mSave && !mLiveWrite ) {
 		openFS();
 
@@ -98,9 +106,11 @@ void Log::save( const std::string& filepath ) {
 }
 
 void Log::write( const std::string& text ) {
-	lock();
-	mData += text;
-	unlock();
+	dispatch( std::string( text ) );
+}
+
+void Log::writeRecords( const std::string& text ) {
+	appendToBuffer( text );
 
 	writeToReaders( text );
 
@@ -114,16 +124,20 @@ void Log::write( const std::string& text ) {
 		OutputDebugString( text.c_str() );
 #endif
 #else
-		std::cout << text;
+		std::cout << text << std::flush;
 #endif
 	}
 
 	if ( mLiveWrite ) {
+		lock();
+
 		openFS();
 
 		mFS->write( text.c_str(), text.size() );
 
 		mFS->flush();
+
+		unlock();
 	}
 }
 
@@ -160,36 +174,7 @@ void Log::write( const LogLevel& level, const std::string& text ) {
 }
 
 void Log::writel( const std::string& text ) {
-	lock();
-	mData += text;
-	mData += "\n";
-	unlock();
-
-	writeToReaders( text );
-	writeToReaders( "\n" );
-
-	if ( mConsoleOutput ) {
-#if EE_PLATFORM == EE_PLATFORM_ANDROID
-		__android_log_print( ANDROID_LOG_INFO, "eepp", "%s\n", text.c_str() );
-#elif defined( EE_COMPILER_MSVC )
-#ifdef UNICODE
-		OutputDebugString( String::fromUtf8( text + "\n" ).toWideString().c_str() );
-#else
-		OutputDebugString( ( text + "\n" ).c_str() );
-#endif
-#else
-		std::cout << text << std::endl;
-#endif
-	}
-
-	if ( mLiveWrite ) {
-		openFS();
-
-		mFS->write( text.c_str(), text.size() );
-		mFS->write( "\n", 1 );
-
-		mFS->flush();
-	}
+	dispatch( text + "\n" );
 }
 
 void Log::writel( const LogLevel& level, const std::string& text ) {
@@ -228,36 +213,10 @@ void Log::writef( const char* format, ... ) {
 			tstr.resize( n );
 			tstr += '\n';
 
-			lock();
-			mData += tstr;
-			unlock();
-
-			writeToReaders( tstr );
-
-			if ( mConsoleOutput ) {
-#if EE_PLATFORM == EE_PLATFORM_ANDROID
-				__android_log_print( ANDROID_LOG_INFO, "eepp", "%s", tstr.c_str() );
-#elif defined( EE_COMPILER_MSVC )
-#ifdef UNICODE
-				OutputDebugString( String::fromUtf8( tstr ).toWideString().c_str() );
-#else
-				OutputDebugString( tstr.c_str() );
-#endif
-#else
-				std::cout << tstr;
-#endif
-			}
-
-			if ( mLiveWrite ) {
-				openFS();
-
-				mFS->write( tstr.c_str(), tstr.size() );
-
-				mFS->flush();
-			}
-
 			va_end( args );
 
+			dispatch( std::move( tstr ) );
+
 			return;
 		}
 
@@ -293,36 +252,10 @@ void Log::writef( const LogLevel& level, const char* format, ... ) {
 				first = false;
 			}
 
-			lock();
-			mData += tstr;
-			unlock();
-
-			writeToReaders( tstr );
-
-			if ( mConsoleOutput ) {
-#if EE_PLATFORM == EE_PLATFORM_ANDROID
-				__android_log_print( ANDROID_LOG_INFO, "eepp", "%s", tstr.c_str() );
-#elif defined( EE_COMPILER_MSVC )
-#ifdef UNICODE
-				OutputDebugString( String::fromUtf8( tstr ).toWideString().c_str() );
-#else
-				OutputDebugString( tstr.c_str() );
-#endif
-#else
-				std::cout << tstr;
-#endif
-			}
-
-			if ( mLiveWrite ) {
-				openFS();
-
-				mFS->write( tstr.c_str(), tstr.size() );
-
-				mFS->flush();
-			}
-
 			va_end( args );
 
+			dispatch( std::move( tstr ) );
+
 			return;
 		}
 
@@ -336,7 +269,212 @@ void Log::writef( const LogLevel& level, const char* format, ... ) {
 }
 
 std::string Log::getBuffer() const {
-	return mData;
+	Log* log = const_cast<Log*>( this );
+	log->lock();
+	std::string data( mData );
+	log->unlock();
+	return data;
+}
+
+const size_t& Log::getMaxBufferSize() const {
+	return mMaxBufferSize;
+}
+
+void Log::setMaxBufferSize( const size_t& maxBufferSize ) {
+	mMaxBufferSize = maxBufferSize;
+	appendToBuffer( "" );
+}
+
+void Log::appendToBuffer( const std::string& text ) {
+	lock();
+	mData += text;
+	if ( mMaxBufferSize > 0 && mData.size() > mMaxBufferSize ) {
+		/* Trimmed at a line start to 3/4 of the limit, so it's not trimmed on every write */
+		size_t keep = mMaxBufferSize / 4 * 3;
+		size_t pos = mData.find( '\n', mData.size() - keep );
+		mData.erase( 0, pos != std::string::npos ? pos + 1 : mData.size() - keep );
+	}
+	unlock();
+}
+
+bool Log::isAsync() const {
+	return mAsync;
+}
+
+void Log::setAsync( bool async ) {
+	if ( async == mAsync )
+		return;
+
+	if ( async ) {
+		if ( !mRing ) {
+			mRing.reset( new Record[RING_SIZE] );
+			mRingMask = RING_SIZE - 1;
+		}
+		for ( size_t i = 0; i < RING_SIZE; i++ )
+			mRing[i].sequence = i;
+		mRingHead = 0;
+		mRingTail = 0;
+		mRingWritten = 0;
+		mStalledTail = std::numeric_limits<size_t>::max();
+		mWriterRunning = true;
+		mWriterThread = std::thread( &Log::writerLoop, this );
+		mWriterThreadId = mWriterThread.get_id();
+		mAsync = true;
+	} else {
+		mAsync = false;
+
+		/* The producers that already saw the asynchronous mode finish queueing their records */
+		while ( mDispatching > 0 )
+			std::this_thread::yield();
+
+		mWriterRunning = false;
+		wakeWriter();
+		mWriterThread.join();
+
+		/* The messages queued while the writer was stopping */
+		std::string batch;
+		while ( popRecord( batch ) )
+			;
+		if ( !batch.empty() )
+			writeRecords( batch );
+
+		std::lock_guard<std::mutex> lock( mFlushMutex );
+		mFlushCondition.notify_all();
+	}
+}
+
+void Log::flush() {
+	if ( !mAsync || std::this_thread::get_id() == mWriterThreadId )
+		return;
+
+	/* The records reserved until now, they are done once the writer has written them (popping
+	 * them is not enough) */
+	size_t target = mRingHead.load( std::memory_order_acquire );
+	std::unique_lock<std::mutex> lock( mFlushMutex );
+	while ( mAsync && mRingWritten.load( std::memory_order_acquire ) < target ) {
+		wakeWriter();
+		mFlushCondition.wait_for( lock, std::chrono::milliseconds( 100 ), [this, target] {
+			return !mAsync || mRingWritten.load( std::memory_order_acquire ) >= target;
+		} );
+	}
+}
+
+void Log::dispatch( std::string&& text ) {
+	++mDispatching;
+
+	if ( mAsync ) {
+		/* When the ring is full the caller waits for the writer, unless it's the writer itself
+		 * (a log reader logging) or the writer stopped making progress (it can be blocked by a
+		 * reader waiting for a lock held by the caller), then the message is written
+		 * immediately */
+		bool isWriter = std::this_thread::get_id() == mWriterThreadId;
+		size_t tail = mRingTail.load( std::memory_order_relaxed );
+		auto lastProgress = std::chrono::steady_clock::now();
+		while ( true ) {
+			if ( pushRecord( text ) ) {
+				wakeWriter();
+				--mDispatching;
+				return;
+			}
+			if ( isWriter )
+				break;
+			size_t curTail = mRingTail.load( std::memory_order_relaxed );
+			if ( curTail == mStalledTail )
+				break;
+			if ( curTail != tail ) {
+				tail = curTail;
+				lastProgress = std::chrono::steady_clock::now();
+			} else if ( std::chrono::steady_clock::now() - lastProgress >
+						std::chrono::milliseconds( 50 ) ) {
+				/* The next callers don't wait until the writer moves again */
+				mStalledTail = curTail;
+				break;
+			}
+			wakeWriter();
+			std::this_thread::yield();
+		}
+	}
+
+	--mDispatching;
+
+	writeRecords( text );
+}
+
+bool Log::pushRecord( std::string& text ) {
+	size_t pos = mRingHead.load( std::memory_order_relaxed );
+	Record* record;
+
+	while ( true ) {
+		record = &mRing[pos & mRingMask];
+		size_t sequence = record->sequence.load( std::memory_order_acquire );
+		Int64 diff = (Int64)sequence - (Int64)pos;
+		if ( diff == 0 ) {
+			if ( mRingHead.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+				break;
+		} else if ( diff < 0 ) {
+			return false;
+		} else {
+			pos = mRingHead.load( std::memory_order_relaxed );
+		}
+	}
+
+	record->text = std::move( text );
+	record->sequence.store( pos + 1, std::memory_order_release );
+	return true;
+}
+
+bool Log::popRecord( std::string& text ) {
+	size_t pos = mRingTail.load( std::memory_order_relaxed );
+	Record& record = mRing[pos & mRingMask];
+
+	if ( record.sequence.load( std::memory_order_acquire ) != pos + 1 )
+		return false;
+
+	text += record.text;
+	record.text = std::string();
+	record.sequence.store( pos + mRingMask + 1, std::memory_order_release );
+	mRingTail.store( pos + 1, std::memory_order_release );
+	return true;
+}
+
+void Log::wakeWriter() {
+	if ( mWriterSleeping ) {
+		std::lock_guard<std::mutex> lock( mWriterMutex );
+		mWriterCondition.notify_one();
+	}
+}
+
+void Log::writerLoop() {
+	std::string batch;
+	size_t count;
+
+	while ( true ) {
+		batch.clear();
+		count = 0;
+		while ( batch.size() < BATCH_SIZE && popRecord( batch ) )
+			count++;
+
+		if ( count > 0 ) {
+			if ( !batch.empty() )
+				writeRecords( batch );
+			mRingWritten.fetch_add( count, std::memory_order_release );
+			std::lock_guard<std::mutex> lock( mFlushMutex );
+			mFlushCondition.notify_all();
+			continue;
+		}
+
+		if ( !mWriterRunning )
+			break;
+
+		std::unique_lock<std::mutex> lock( mWriterMutex );
+		mWriterSleeping = true;
+		mWriterCondition.wait_for( lock, std::chrono::milliseconds( 100 ), [this] {
+			return !mWriterRunning ||
+				   mRing[mRingTail & mRingMask].sequence.load( std::memory_order_acquire ) ==
+					   mRingTail + 1;
+		} );
+		mWriterSleeping = false;
+	}
 }
 
 const bool& Log::isConsoleOutput() const {
@@ -365,19 +503,43 @@ void Log::setLiveWrite( const bool& lw ) {
 	mLiveWrite = lw;
 }
 
+/* Set while the thread is calling the readers, so a reader can remove itself from writeLog */
+static thread_local bool sCallingReaders = false;
+
 void Log::addLogReader( LogReaderInterface* reader ) {
+	std::lock_guard<std::mutex> lock( mReadersMutex );
 	mReaders.push_back( reader );
 }
 
 void Log::removeLogReader( LogReaderInterface* reader ) {
+	std::unique_lock<std::mutex> lock( mReadersMutex );
 	mReaders.remove( reader );
+
+	/* Another thread could be calling the reader from a copy of the list taken before */
+	if ( !sCallingReaders )
+		mReadersCondition.wait( lock, [this] { return mReadersCalling == 0; } );
 }
 
 void Log::writeToReaders( const std::string& text ) {
-	for ( std::list<LogReaderInterface*>::iterator it = mReaders.begin(); it != mReaders.end();
-		  ++it ) {
-		( *it )->writeLog( text );
+	std::list<LogReaderInterface*> readers;
+
+	{
+		std::lock_guard<std::mutex> lock( mReadersMutex );
+		if ( mReaders.empty() )
+			return;
+		readers = mReaders;
+		mReadersCalling++;
 	}
+
+	bool wasCalling = sCallingReaders;
+	sCallingReaders = true;
+	for ( auto reader : readers )
+		reader->writeLog( text );
+	sCallingReaders = wasCalling;
+
+	std::lock_guard<std::mutex> lock( mReadersMutex );
+	if ( --mReadersCalling == 0 )
+		mReadersCondition.notify_all();
 }
 
 }} // namespace EE::System
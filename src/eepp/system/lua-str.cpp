@@ -438,3 +438,80 @@ int lua_str_match( const char* s, int offset, size_t ls, const char* p, LuaMatch
 	} while ( s1++ < ms.src_end && !anchor );
 	return 0;
 }
+
+int lua_str_first_chars( const char* p, size_t lp, unsigned char* first_chars ) {
+	const char* p_end = p + lp;
+	const char* ep;
+	int c;
+	if ( p < p_end && *p == '^' )
+		p++;
+	while ( p < p_end ) {
+		switch ( *p ) {
+			case '(':
+			case ')': {
+				/* captures do not consume characters */
+				p++;
+				continue;
+			}
+			case '$': {
+				if ( p + 1 == p_end )
+					return 0;
+				ep = p + 1;
+				break;
+			}
+			case L_ESC: {
+				if ( p + 1 >= p_end )
+					return 0;
+				if ( *( p + 1 ) == 'b' ) {
+					if ( p + 2 >= p_end )
+						return 0;
+					memset( first_chars, 0, 256 );
+					first_chars[uchar( *( p + 2 ) )] = 1;
+					return 1;
+				}
+				if ( *( p + 1 ) == 'f' || isdigit( uchar( *( p + 1 ) ) ) )
+					return 0;
+				ep = p + 2;
+				break;
+			}
+			case '[': {
+				ep = p + 1;
+				if ( ep < p_end && *ep == '^' )
+					ep++;
+				do {
+					if ( ep >= p_end )
+						return 0;
+					if ( *( ep++ ) == L_ESC && ep < p_end )
+						ep++;
+				} while ( ep >= p_end || *ep != ']' );
+				ep++;
+				break;
+			}
+			default: {
+				ep = p + 1;
+				break;
+			}
+		}
+		/* the item can be skipped, so any character could start the match */
+		if ( ep < p_end && ( *ep == '*' || *ep == '?' || *ep == '-' ) )
+			return 0;
+		for ( c = 0; c < 256; c++ ) {
+			switch ( *p ) {
+				case '.':
+					first_chars[c] = 1;
+					break;
+				case L_ESC:
+					first_chars[c] = match_class( c, uchar( *( p + 1 ) ) ) ? 1 : 0;
+					break;
+				case '[':
+					first_chars[c] = matchbracketclass( c, p, ep - 1 ) ? 1 : 0;
+					break;
+				default:
+					first_chars[c] = uchar( *p ) == c ? 1 : 0;
+					break;
+			}
+		}
+		return 1;
+	}
+	return 0;
+}
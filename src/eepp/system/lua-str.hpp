@@ -14,4 +14,8 @@ struct LuaMatch {
 
 int lua_str_match( const char* text, int offset, size_t len, const char* pattern, LuaMatch* mm );
 
+/* Fills first_chars (256 entries) with the bytes that can start a match of the anchored pattern.
+ * Returns 0 if the set can't be determined (any byte or an empty string could match). */
+int lua_str_first_chars( const char* pattern, size_t len, unsigned char* first_chars );
+
 #endif // EE_SYSTEM_LUA_STR_HPP
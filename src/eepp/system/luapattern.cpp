@@ -103,6 +103,28 @@ const size_t& LuaPattern::getNumMatches() const {
 	return mMatchNum;
 }
 
+size_t LuaPattern::countMatches( const char* stringSearch, int stringStartOffset,
+								 LuaPattern::Range* matchList, size_t stringLength ) const {
+	LuaPattern::Range matchesBuffer[MAX_DEFAULT_MATCHES];
+	if ( matchList == nullptr )
+		matchList = matchesBuffer;
+	try {
+		return lua_str_match( stringSearch, stringStartOffset, stringLength, mPattern.c_str(),
+							  (LuaMatch*)matchList );
+	} catch ( const std::string& ) {
+		return 0;
+	}
+}
+
+bool LuaPattern::getFirstChars( std::bitset<256>& firstChars ) const {
+	unsigned char chars[256];
+	if ( !lua_str_first_chars( mPattern.c_str(), mPattern.size(), chars ) )
+		return false;
+	for ( size_t i = 0; i < 256; ++i )
+		firstChars[i] = chars[i] != 0;
+	return true;
+}
+
 bool LuaPattern::LuaPattern::State::range( int index, int& start, int& end ) {
 	return mPattern->range( index, start, end, mRanges );
 }
@@ -16,6 +16,10 @@ bool Pack::isOpen() const {
 	return mIsOpen;
 }
 
+const PackIndex& Pack::getIndex() const {
+	return mIndex;
+}
+
 void Pack::onPackOpened() {
 	VirtualFileSystem::instance()->onResourceAdd( this );
 }
@@ -0,0 +1,172 @@
+#include <eepp/system/packindex.hpp>
+
+namespace EE { namespace System {
+
+bool PackIndex::needsNormalization( const std::string& path ) {
+	if ( path.empty() )
+		return false;
+
+	if ( path[0] == '/' || ( path.size() > 1 && path[0] == '.' && path[1] == '/' ) )
+		return true;
+
+	for ( size_t i = 0; i < path.size(); i++ ) {
+		if ( path[i] == '\\' || ( path[i] == '/' && i + 1 < path.size() && path[i + 1] == '/' ) )
+			return true;
+	}
+
+	return false;
+}
+
+std::string PackIndex::normalizePath( std::string path ) {
+	if ( !needsNormalization( path ) )
+		return path;
+
+	std::string res;
+	res.reserve( path.size() );
+
+	for ( size_t i = 0; i < path.size(); i++ ) {
+		char ch = path[i] == '\\' ? '/' : path[i];
+
+		if ( ch == '/' && ( res.empty() || res.back() == '/' ) )
+			continue;
+
+		if ( ch == '.' && res.empty() && i + 1 < path.size() &&
+			 ( path[i + 1] == '/' || path[i + 1] == '\\' ) ) {
+			i++;
+			continue;
+		}
+
+		res.push_back( ch );
+	}
+
+	return res;
+}
+
+PackIndex::PackIndex() {}
+
+void PackIndex::clear() {
+	mEntries.clear();
+	mRoot = Directory();
+}
+
+void PackIndex::add( const std::string& path, const Int32& entry ) {
+	std::string npath( normalizePath( path ) );
+
+	if ( npath.empty() )
+		return;
+
+	auto it = mEntries.find( npath );
+
+	if ( it != mEntries.end() ) {
+		it->second = entry;
+		return;
+	}
+
+	Directory* curDir = &mRoot;
+	size_t start = 0;
+	size_t pos;
+
+	while ( ( pos = npath.find( '/', start ) ) != std::string::npos ) {
+		curDir = &curDir->directories[npath.substr( start, pos - start )];
+		start = pos + 1;
+	}
+
+	// Paths ending with a slash are directory entries.
+	if ( start < npath.size() )
+		curDir->files.insert( npath );
+
+	mEntries[std::move( npath )] = entry;
+}
+
+void PackIndex::remove( const std::string& path ) {
+	std::string npath( normalizePath( path ) );
+	auto it = mEntries.find( npath );
+
+	if ( it == mEntries.end() )
+		return;
+
+	mEntries.erase( it );
+
+	Directory* curDir = &mRoot;
+	size_t start = 0;
+	size_t pos;
+
+	while ( ( pos = npath.find( '/', start ) ) != std::string::npos ) {
+		auto dirIt = curDir->directories.find( npath.substr( start, pos - start ) );
+
+		if ( dirIt == curDir->directories.end() )
+			return;
+
+		curDir = &dirIt->second;
+		start = pos + 1;
+	}
+
+	curDir->files.erase( npath );
+}
+
+Int32 PackIndex::find( const std::string& path ) const {
+	auto it = needsNormalization( path ) ? mEntries.find( normalizePath( path ) )
+										 : mEntries.find( path );
+	return it != mEntries.end() ? it->second : -1;
+}
+
+bool PackIndex::exists( const std::string& path ) const {
+	return -1 != find( path );
+}
+
+size_t PackIndex::size() const {
+	return mEntries.size();
+}
+
+bool PackIndex::empty() const {
+	return mEntries.empty();
+}
+
+const PackIndex::Directory* PackIndex::findDirectory( const std::string& directory ) const {
+	std::string path( normalizePath( directory ) );
+	const Directory* curDir = &mRoot;
+	size_t start = 0;
+
+	while ( start < path.size() ) {
+		size_t pos = path.find( '/', start );
+
+		if ( pos == std::string::npos )
+			pos = path.size();
+
+		auto it = curDir->directories.find( path.substr( start, pos - start ) );
+
+		if ( it == curDir->directories.end() )
+			return NULL;
+
+		curDir = &it->second;
+		start = pos + 1;
+	}
+
+	return curDir;
+}
+
+std::vector<std::string> PackIndex::getFilesInDirectory( const std::string& directory ) const {
+	const Directory* dir = findDirectory( directory );
+
+	if ( NULL == dir )
+		return {};
+
+	return std::vector<std::string>( dir->files.begin(), dir->files.end() );
+}
+
+std::vector<std::string>
+PackIndex::getDirectoriesInDirectory( const std::string& directory ) const {
+	std::vector<std::string> dirs;
+	const Directory* dir = findDirectory( directory );
+
+	if ( NULL != dir ) {
+		dirs.reserve( dir->directories.size() );
+
+		for ( const auto& subDir : dir->directories )
+			dirs.push_back( subDir.first );
+	}
+
+	return dirs;
+}
+
+}} // namespace EE::System
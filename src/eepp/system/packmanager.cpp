@@ -15,6 +15,8 @@ Pack* PackManager::exists( std::string& path ) {
 
 	FileSystem::filePathRemoveProcessPath( tpath );
 
+	// The first registered pack that contains the file wins. The packs with an index resolve
+	// exists() with a hash lookup, so this costs one lookup per pack.
 	for ( auto& pack : mResources ) {
 		if ( -1 != pack->exists( tpath ) ) {
 			if ( path.size() != tpath.size() ) {
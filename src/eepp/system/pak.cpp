@@ -1,3 +1,4 @@
+#include <cstring>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/iostreampak.hpp>
 #include <eepp/system/log.hpp>
@@ -69,8 +70,12 @@ bool Pak::open( const std::string& path ) {
 				mPak.fs->read( reinterpret_cast<char*>( &Entry ), sizeof( pakEntry ) );
 
 				mPakFiles.push_back( Entry );
+
+				mIndex.add( getEntryName( Entry ), i );
 			}
 
+			mapPak();
+
 			mIsOpen = true;
 
 			onPackOpened();
@@ -86,8 +91,12 @@ bool Pak::close() {
 	if ( mIsOpen ) {
 		eeSAFE_DELETE( mPak.fs );
 
+		mMappedFile.reset();
+
 		mPakFiles.clear();
 
+		mIndex.clear();
+
 		mIsOpen = false;
 
 		onPackClosed();
@@ -113,13 +122,7 @@ Int8 Pak::checkPack() {
 }
 
 Int32 Pak::exists( const std::string& path ) {
-	if ( isOpen() ) {
-		for ( Uint32 i = 0; i < mPakFiles.size(); i++ )
-			if ( std::strncmp( path.c_str(), mPakFiles[i].filename, path.size() ) == 0 )
-				return i;
-	}
-
-	return -1;
+	return isOpen() ? mIndex.find( path ) : -1;
 }
 
 bool Pak::extractFile( const std::string& path, const std::string& dest ) {
@@ -153,25 +156,17 @@ bool Pak::extractFileToMemory( const std::string& path, std::vector<Uint8>& data
 		return false;
 	}
 
-	lock();
-
-	bool Ret = false;
-
 	Int32 Pos = exists( path );
 
-	if ( Pos != -1 ) {
-		data.clear();
-		data.resize( mPakFiles[Pos].file_length );
+	if ( Pos == -1 )
+		return false;
 
-		mPak.fs->seek( mPakFiles[Pos].file_position );
-		mPak.fs->read( reinterpret_cast<char*>( &data[0] ), mPakFiles[Pos].file_length );
+	const pakEntry& entry = mPakFiles[Pos];
 
-		Ret = true;
-	}
+	data.clear();
+	data.resize( entry.file_length );
 
-	unlock();
-
-	return Ret;
+	return entry.file_length == 0 || readEntry( entry, reinterpret_cast<char*>( &data[0] ) );
 }
 
 bool Pak::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
@@ -179,24 +174,16 @@ bool Pak::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 		return false;
 	}
 
-	lock();
-
-	bool Ret = false;
-
 	Int32 Pos = exists( path );
 
-	if ( Pos != -1 ) {
-		data.reset( mPakFiles[Pos].file_length );
-
-		mPak.fs->seek( mPakFiles[Pos].file_position );
-		mPak.fs->read( reinterpret_cast<char*>( data.get() ), data.length() );
+	if ( Pos == -1 )
+		return false;
 
-		Ret = true;
-	}
+	const pakEntry& entry = mPakFiles[Pos];
 
-	unlock();
+	data.reset( entry.file_length );
 
-	return Ret;
+	return entry.file_length == 0 || readEntry( entry, reinterpret_cast<char*>( data.get() ) );
 }
 
 bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string& inpack ) {
@@ -228,6 +215,10 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 
 			mPakFiles.push_back( newFile );
 
+			mIndex.add( getEntryName( newFile ), 0 );
+
+			mapPak();
+
 			return true;
 		} else {
 			if ( exists( inpack ) != -1 ) // If the file already exists exit
@@ -268,10 +259,13 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 							( std::streamsize )( sizeof( pakEntry ) * pakE.size() ) );
 
 			mPakFiles.push_back( pakE[mPak.pakFilesNum] );
+			mIndex.add( getEntryName( pakE[mPak.pakFilesNum] ), mPak.pakFilesNum );
 			mPak.pakFilesNum += 1;
 
 			pakE.clear();
 
+			mapPak();
+
 			return true;
 		}
 	}
@@ -382,7 +376,7 @@ std::vector<std::string> Pak::getFileList() {
 	tmpv.resize( mPakFiles.size() );
 
 	for ( Uint32 i = 0; i < mPakFiles.size(); i++ )
-		tmpv[i] = std::string( mPakFiles[i].filename );
+		tmpv[i] = getEntryName( mPakFiles[i] );
 
 	return tmpv;
 }
@@ -399,6 +393,65 @@ IOStream* Pak::getFileStream( const std::string& path ) {
 	return eeNew( IOStreamPak, ( this, path ) );
 }
 
+const char* Pak::getFileView( const std::string& path, Uint32& size ) {
+	Int32 Pos = exists( path );
+
+	if ( Pos == -1 )
+		return NULL;
+
+	const char* data = getEntryView( mPakFiles[Pos] );
+
+	if ( NULL != data )
+		size = mPakFiles[Pos].file_length;
+
+	return data;
+}
+
+void Pak::mapPak() {
+	mMappedFile.reset();
+
+	if ( NULL != mPak.fs )
+		mPak.fs->flush();
+
+	// Only real mappings are used, reading the whole pak into memory is not worth it.
+	std::shared_ptr<IOStreamMappedFile> mappedFile =
+		std::make_shared<IOStreamMappedFile>( mPak.pakPath, false );
+
+	if ( mappedFile->isMapped() )
+		mMappedFile = mappedFile;
+}
+
+const char* Pak::getEntryView( const pakEntry& entry ) const {
+	if ( NULL == mMappedFile ||
+		 (Uint64)entry.file_position + entry.file_length > (Uint64)mMappedFile->getLength() )
+		return NULL;
+
+	return mMappedFile->getData() + entry.file_position;
+}
+
+bool Pak::readEntry( const pakEntry& entry, char* data ) const {
+	const char* view = getEntryView( entry );
+
+	if ( NULL != view ) {
+		memcpy( data, view, entry.file_length );
+		return true;
+	}
+
+	// Positional read with its own stream, the shared pak stream position is never touched.
+	IOStreamFile file( mPak.pakPath, "rb" );
+
+	if ( !file.isOpen() )
+		return false;
+
+	file.seek( entry.file_position );
+
+	return file.read( data, entry.file_length ) == entry.file_length;
+}
+
+std::string Pak::getEntryName( const pakEntry& entry ) {
+	return std::string( entry.filename, strnlen( entry.filename, sizeof( entry.filename ) ) );
+}
+
 Pak::pakEntry Pak::getPackEntry( Uint32 index ) {
 	if ( isOpen() && index < mPakFiles.size() ) {
 		return mPakFiles[index];
@@ -1,7 +1,31 @@
+#include <atomic>
 #include <eepp/system/threadpool.hpp>
 
 namespace EE { namespace System {
 
+namespace {
+
+struct ParallelForState {
+	std::function<void( size_t )> task;
+	size_t count{ 0 };
+	std::atomic<size_t> next{ 0 };
+	std::mutex mutex;
+	std::condition_variable doneCond;
+	size_t done{ 0 };
+
+	void work() {
+		size_t i;
+		while ( ( i = next++ ) < count ) {
+			task( i );
+			std::lock_guard<std::mutex> l( mutex );
+			if ( ++done == count )
+				doneCond.notify_all();
+		}
+	}
+};
+
+} // namespace
+
 std::shared_ptr<ThreadPool> ThreadPool::createShared( Uint32 numThreads, bool terminateOnClose ) {
 	std::shared_ptr<ThreadPool> pool( new ThreadPool( numThreads, terminateOnClose ) );
 	return pool;
@@ -87,6 +111,26 @@ void ThreadPool::run( const std::function<void()>& func,
 	mWorkAvailable.notify_one();
 }
 
+void ThreadPool::parallelFor( size_t count, const std::function<void( size_t )>& task ) {
+	if ( count == 0 )
+		return;
+
+	auto state = std::make_shared<ParallelForState>();
+	state->task = task;
+	state->count = count;
+
+	// The state is shared with the pool threads: the ones that start after all the tasks were
+	// taken return without running any task, even after this call returned.
+	size_t helpers = std::min<size_t>( numThreads(), count - 1 );
+	for ( size_t i = 0; i < helpers; i++ )
+		run( [state] { state->work(); } );
+
+	state->work();
+
+	std::unique_lock<std::mutex> lock( state->mutex );
+	state->doneCond.wait( lock, [&state] { return state->done == state->count; } );
+}
+
 Uint32 ThreadPool::numThreads() const {
 	std::unique_lock<std::mutex> lock( mMutex );
 	return mShuttingDown ? 0 : static_cast<Uint32>( mThreads.size() );
@@ -45,6 +45,15 @@ bool Zip::open( const std::string& path ) {
 		if ( 0 == checkPack() ) {
 			mZipPath = path;
 
+			Int32 numfiles = zip_get_num_files( mZip );
+
+			for ( Int32 i = 0; i < numfiles; i++ ) {
+				const char* name = zip_get_name( mZip, i, 0 );
+
+				if ( NULL != name )
+					mIndex.add( name, i );
+			}
+
 			mIsOpen = true;
 
 			onPackOpened();
@@ -68,6 +77,8 @@ bool Zip::close() {
 
 		mZip = NULL;
 
+		mIndex.clear();
+
 		onPackClosed();
 
 		return true;
@@ -135,6 +146,8 @@ bool Zip::eraseFiles( const std::vector<std::string>& paths ) {
 		else {
 			if ( zip_delete( mZip, Ex ) == -1 )
 				return false;
+
+			mIndex.remove( paths[i] );
 		}
 	}
 
@@ -168,8 +181,9 @@ bool Zip::extractFileToMemory( const std::string& path, std::vector<Uint8>& data
 
 		data.clear();
 
+		/* Resolved by the index, the path could be not normalized as it's stored in the zip */
 		struct zip_stat zs;
-		int err = zip_stat( mZip, path.c_str(), 0, &zs );
+		int err = zip_stat_index( mZip, Pos, 0, &zs );
 
 		if ( !err ) {
 			struct zip_file* zf = zip_fopen_index( mZip, zs.index, 0 );
@@ -201,8 +215,9 @@ bool Zip::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 	Int32 Result = 0;
 
 	if ( 0 == checkPack() && -1 != Pos ) {
+		/* Resolved by the index, the path could be not normalized as it's stored in the zip */
 		struct zip_stat zs;
-		int err = zip_stat( mZip, path.c_str(), 0, &zs );
+		int err = zip_stat_index( mZip, Pos, 0, &zs );
 
 		if ( !err ) {
 			struct zip_file* zf = zip_fopen_index( mZip, zs.index, 0 );
@@ -226,10 +241,7 @@ bool Zip::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 }
 
 Int32 Zip::exists( const std::string& path ) {
-	if ( isOpen() )
-		return zip_name_locate( mZip, path.c_str(), 0 );
-
-	return -1;
+	return isOpen() ? mIndex.find( path ) : -1;
 }
 
 Int8 Zip::checkPack() {
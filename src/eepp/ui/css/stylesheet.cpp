@@ -45,6 +45,23 @@ void StyleSheet::setMarker( const Uint32& marker ) {
 		keyframes.second.setMarker( marker );
 }
 
+template <typename Index>
+static void removeAllWithMarkerFromIndex( Index& index, const Uint32& marker ) {
+	for ( auto it = index.begin(); it != index.end(); ) {
+		StyleSheetStyleVector& nodes = it->second;
+		nodes.erase( std::remove_if( nodes.begin(), nodes.end(),
+									 [marker]( const StyleSheetStyle* node ) {
+										 return node->getMarker() == marker;
+									 } ),
+					 nodes.end() );
+		if ( nodes.empty() ) {
+			it = index.erase( it );
+		} else {
+			++it;
+		}
+	}
+}
+
 void StyleSheet::removeAllWithMarker( const Uint32& marker ) {
 	std::vector<std::shared_ptr<StyleSheetStyle>> removeNodes;
 
@@ -52,26 +69,11 @@ void StyleSheet::removeAllWithMarker( const Uint32& marker ) {
 		if ( node->getMarker() == marker )
 			removeNodes.emplace_back( node );
 
-	std::vector<size_t> deprecatedNodeIndex;
-	for ( auto& nodeIndex : mNodeIndex ) {
-		std::vector<StyleSheetStyle*> removeNodesIndex;
-		for ( auto node : nodeIndex.second ) {
-			if ( node->getMarker() == marker ) {
-				removeNodesIndex.emplace_back( node );
-			}
-		}
-		for ( auto removeNodeIndex : removeNodesIndex ) {
-			auto found =
-				std::find( nodeIndex.second.begin(), nodeIndex.second.end(), removeNodeIndex );
-			if ( found != nodeIndex.second.end() )
-				nodeIndex.second.erase( found );
-		}
-		if ( nodeIndex.second.empty() )
-			deprecatedNodeIndex.emplace_back( nodeIndex.first );
-	}
+	removeAllWithMarkerFromIndex( mNodeIndex, marker );
+	removeAllWithMarkerFromIndex( mClassIndex, marker );
 
-	for ( auto removeIndex : deprecatedNodeIndex )
-		mNodeIndex.erase( removeIndex );
+	for ( auto& node : removeNodes )
+		mStyleOrder.erase( node.get() );
 
 	std::vector<MediaQueryList::ptr> removeMediaQueries;
 	for ( auto& mediaQueryList : mMediaQueryList ) {
@@ -135,12 +137,17 @@ bool StyleSheet::refreshCacheFromStyles(
 bool StyleSheet::addStyleToNodeIndex( StyleSheetStyle* style ) {
 	const std::string& id = style->getSelector().getSelectorId();
 	const std::string& tag = style->getSelector().getSelectorTagName();
+	const std::vector<std::string>& classes = style->getSelector().getSelectorClasses();
 	if ( style->hasProperties() || style->hasVariables() ) {
-		size_t nodeHash = this->nodeHash( "*" == tag ? "" : tag, id );
-		StyleSheetStyleVector& nodes = mNodeIndex[nodeHash];
+		// The id is the most selective key, then the class. "*.cls" is indexed by its class like
+		// "tag.cls", the style is only applied to elements with the class.
+		StyleSheetStyleVector& nodes = id.empty() && !classes.empty()
+										   ? mClassIndex[classes.back()]
+										   : mNodeIndex[nodeHash( "*" == tag ? "" : tag, id )];
 		auto it = std::find( nodes.begin(), nodes.end(), style );
 		if ( it == nodes.end() ) {
 			nodes.push_back( style );
+			mStyleOrder[style] = mNextStyleOrder++;
 			return true;
 		} else {
 			Log::debug( "Ignored style %s", style->getSelector().getName().c_str() );
@@ -189,18 +196,34 @@ void StyleSheet::combineStyleSheet( const StyleSheet& styleSheet ) {
 	addKeyframes( styleSheet.getKeyframes() );
 }
 
-inline static bool StyleSheetNodeSort( const StyleSheetStyle* lhs, const StyleSheetStyle* rhs ) {
-	return lhs->getSelector().getSpecificity() < rhs->getSelector().getSpecificity();
+// This is based on the RmlUi implementation.
+std::shared_ptr<ElementDefinition>
+StyleSheet::getElementStyles( UIWidget* element, const bool& applyPseudo,
+							  const StyleSheetAncestorFilter* ancestorFilter ) const {
+	return getElementDefinition( getElementStyleNodes( element, applyPseudo, ancestorFilter ) );
 }
 
-// This is based on the RmlUi implementation.
-std::shared_ptr<ElementDefinition> StyleSheet::getElementStyles( UIWidget* element,
-																 const bool& applyPseudo ) const {
-	static StyleSheetStyleVector applicableNodes;
-	applicableNodes.clear();
+StyleSheetStyleVector
+StyleSheet::getElementStyleNodes( UIWidget* element, const bool& applyPseudo,
+								  const StyleSheetAncestorFilter* ancestorFilter ) const {
+	StyleSheetStyleVector applicableNodes;
 
 	const std::string& tag = element->getElementTag();
 	const std::string& id = element->getId();
+	const std::vector<std::string>& classes = element->getStyleSheetClasses();
+
+	if ( ancestorFilter && !ancestorFilter->isValidFor( element ) )
+		ancestorFilter = nullptr;
+
+	auto addApplicableNodes = [&]( const StyleSheetStyleVector& nodes ) {
+		for ( StyleSheetStyle* node : nodes ) {
+			if ( node->isMediaValid() &&
+				 ( !ancestorFilter || node->getSelector().mayMatchAncestors( *ancestorFilter ) ) &&
+				 node->getSelector().select( element, applyPseudo ) ) {
+				applicableNodes.push_back( node );
+			}
+		}
+	};
 
 	std::array<size_t, 4> nodeHash;
 	int numHashes = 2;
@@ -216,18 +239,45 @@ std::shared_ptr<ElementDefinition> StyleSheet::getElementStyles( UIWidget* eleme
 
 	for ( int i = 0; i < numHashes; i++ ) {
 		auto itNodes = mNodeIndex.find( nodeHash[i] );
-		if ( itNodes != mNodeIndex.end() ) {
-			const StyleSheetStyleVector& nodes = itNodes->second;
-			for ( StyleSheetStyle* node : nodes ) {
-				if ( node->isMediaValid() && node->getSelector().select( element, applyPseudo ) ) {
-					applicableNodes.push_back( node );
-				}
-			}
+		if ( itNodes != mNodeIndex.end() )
+			addApplicableNodes( itNodes->second );
+	}
+
+	if ( !mClassIndex.empty() ) {
+		for ( size_t i = 0; i < classes.size(); i++ ) {
+			if ( std::find( classes.begin(), classes.begin() + i, classes[i] ) !=
+				 classes.begin() + i )
+				continue;
+			auto itNodes = mClassIndex.find( classes[i] );
+			if ( itNodes != mClassIndex.end() )
+				addApplicableNodes( itNodes->second );
+		}
+	}
+
+	if ( applicableNodes.size() > 1 ) {
+		std::vector<std::pair<size_t, StyleSheetStyle*>> sortedNodes;
+		sortedNodes.reserve( applicableNodes.size() );
+		for ( StyleSheetStyle* node : applicableNodes ) {
+			auto order = mStyleOrder.find( node );
+			sortedNodes.emplace_back( order != mStyleOrder.end() ? order->second : 0, node );
 		}
+		std::sort( sortedNodes.begin(), sortedNodes.end(),
+				   []( const std::pair<size_t, StyleSheetStyle*>& lhs,
+					   const std::pair<size_t, StyleSheetStyle*>& rhs ) {
+					   Uint32 lhsSpecificity = lhs.second->getSelector().getSpecificity();
+					   Uint32 rhsSpecificity = rhs.second->getSelector().getSpecificity();
+					   return lhsSpecificity != rhsSpecificity ? lhsSpecificity < rhsSpecificity
+															   : lhs.first < rhs.first;
+				   } );
+		for ( size_t i = 0; i < sortedNodes.size(); i++ )
+			applicableNodes[i] = sortedNodes[i].second;
 	}
 
-	std::sort( applicableNodes.begin(), applicableNodes.end(), StyleSheetNodeSort );
+	return applicableNodes;
+}
 
+std::shared_ptr<ElementDefinition>
+StyleSheet::getElementDefinition( const StyleSheetStyleVector& applicableNodes ) const {
 	if ( applicableNodes.empty() )
 		return nullptr;
 
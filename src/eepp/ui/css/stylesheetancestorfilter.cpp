@@ -0,0 +1,88 @@
+#include <eepp/ui/css/stylesheetancestorfilter.hpp>
+#include <eepp/ui/uiwidget.hpp>
+
+namespace EE { namespace UI { namespace CSS {
+
+// Every kind of name is salted differently, so a tag and a class with the same name don't collide.
+static inline Uint32 saltedHash( const std::string& name, const Uint32& salt ) {
+	return ( String::hash( name ) ^ salt ) * 0x9E3779B1u;
+}
+
+Uint32 StyleSheetAncestorFilter::tagHash( const std::string& tag ) {
+	return saltedHash( tag, 0x1F2E3D4Cu );
+}
+
+Uint32 StyleSheetAncestorFilter::idHash( const std::string& id ) {
+	return saltedHash( id, 0x5A6B7C8Du );
+}
+
+Uint32 StyleSheetAncestorFilter::classHash( const std::string& cls ) {
+	return saltedHash( cls, 0x92A3B4C5u );
+}
+
+StyleSheetAncestorFilter::StyleSheetAncestorFilter() : mCounters( 1 << KeyBits, 0 ) {}
+
+void StyleSheetAncestorFilter::add( const Uint32& hash ) {
+	Uint8& first = mCounters[hash & KeyMask];
+	Uint8& second = mCounters[( hash >> 16 ) & KeyMask];
+	// Saturated counters are never decremented, they only cause false positives.
+	if ( first != 0xFF )
+		first++;
+	if ( second != 0xFF )
+		second++;
+	mHashes.push_back( hash );
+}
+
+void StyleSheetAncestorFilter::remove( const Uint32& hash ) {
+	Uint8& first = mCounters[hash & KeyMask];
+	Uint8& second = mCounters[( hash >> 16 ) & KeyMask];
+	if ( first != 0xFF )
+		first--;
+	if ( second != 0xFF )
+		second--;
+}
+
+void StyleSheetAncestorFilter::pushElement( UIWidget* element ) {
+	mElements.push_back( element );
+	mHashesStart.push_back( mHashes.size() );
+	add( tagHash( element->getElementTag() ) );
+	if ( !element->getId().empty() )
+		add( idHash( element->getId() ) );
+	for ( const auto& cls : element->getStyleSheetClasses() )
+		add( classHash( cls ) );
+}
+
+void StyleSheetAncestorFilter::popElement() {
+	if ( mElements.empty() )
+		return;
+	size_t start = mHashesStart.back();
+	for ( size_t i = start; i < mHashes.size(); i++ )
+		remove( mHashes[i] );
+	mHashes.resize( start );
+	mHashesStart.pop_back();
+	mElements.pop_back();
+}
+
+void StyleSheetAncestorFilter::pushAncestors( UIWidget* element ) {
+	std::vector<UIWidget*> ancestors;
+	UIWidget* parent = element->getStyleSheetParentElement();
+	while ( NULL != parent ) {
+		ancestors.push_back( parent );
+		parent = parent->getStyleSheetParentElement();
+	}
+	for ( auto it = ancestors.rbegin(); it != ancestors.rend(); ++it )
+		pushElement( *it );
+}
+
+void StyleSheetAncestorFilter::clear() {
+	std::fill( mCounters.begin(), mCounters.end(), 0 );
+	mElements.clear();
+	mHashes.clear();
+	mHashesStart.clear();
+}
+
+bool StyleSheetAncestorFilter::isValidFor( UIWidget* element ) const {
+	return !mElements.empty() && mElements.back() == element->getStyleSheetParentElement();
+}
+
+}}} // namespace EE::UI::CSS
@@ -101,6 +101,23 @@ void StyleSheetSelector::parseSelector( std::string selector ) {
 				}
 			}
 		}
+
+		// The elements matched by descendant and child combinators are ancestors of the element
+		// (siblings share the same ancestors), so their names must be in the ancestor filter.
+		for ( size_t i = 1; i < mSelectorRules.size(); i++ ) {
+			const StyleSheetSelectorRule& rule = mSelectorRules[i];
+			if ( ( rule.getPatternMatch() != StyleSheetSelectorRule::DESCENDANT &&
+				   rule.getPatternMatch() != StyleSheetSelectorRule::CHILD ) ||
+				 rule.getTagName() == "*" )
+				continue;
+			if ( !rule.getTagName().empty() )
+				mAncestorHashes.push_back(
+					StyleSheetAncestorFilter::tagHash( rule.getTagName() ) );
+			if ( !rule.getId().empty() )
+				mAncestorHashes.push_back( StyleSheetAncestorFilter::idHash( rule.getId() ) );
+			for ( const auto& cls : rule.getClasses() )
+				mAncestorHashes.push_back( StyleSheetAncestorFilter::classHash( cls ) );
+		}
 	}
 }
 
@@ -321,4 +338,15 @@ const std::string& StyleSheetSelector::getSelectorTagName() const {
 	return mSelectorRules[0].getTagName();
 }
 
+const std::vector<std::string>& StyleSheetSelector::getSelectorClasses() const {
+	return mSelectorRules[0].getClasses();
+}
+
+bool StyleSheetSelector::mayMatchAncestors( const StyleSheetAncestorFilter& filter ) const {
+	for ( const auto& hash : mAncestorHashes )
+		if ( !filter.mayContain( hash ) )
+			return false;
+	return true;
+}
+
 }}} // namespace EE::UI::CSS
@@ -237,6 +237,10 @@ const std::string& StyleSheetSelectorRule::getId() const {
 	return mId;
 }
 
+const std::vector<std::string>& StyleSheetSelectorRule::getClasses() const {
+	return mClasses;
+}
+
 bool StyleSheetSelectorRule::matches( UIWidget* element, const bool& applyPseudo ) const {
 	Uint32 flags = 0;
 
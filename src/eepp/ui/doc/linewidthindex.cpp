@@ -0,0 +1,80 @@
+#include <eepp/core/core.hpp>
+#include <eepp/ui/doc/linewidthindex.hpp>
+
+namespace EE { namespace UI { namespace Doc {
+
+LineWidthIndex::LineWidthIndex() {}
+
+void LineWidthIndex::reset( const size_t& linesCount ) {
+	mWidths.assign( linesCount, 0 );
+	mWidthCount.clear();
+	if ( linesCount )
+		mWidthCount[0] = linesCount;
+}
+
+void LineWidthIndex::clear() {
+	mWidths.clear();
+	mWidthCount.clear();
+}
+
+size_t LineWidthIndex::size() const {
+	return mWidths.size();
+}
+
+bool LineWidthIndex::empty() const {
+	return mWidths.empty();
+}
+
+void LineWidthIndex::setWidth( const Int64& line, const Float& width ) {
+	if ( line < 0 || line >= (Int64)mWidths.size() || mWidths[line] == width )
+		return;
+	removeWidth( mWidths[line] );
+	mWidths[line] = width;
+	addWidth( width );
+}
+
+Float LineWidthIndex::getWidth( const Int64& line ) const {
+	if ( line < 0 || line >= (Int64)mWidths.size() )
+		return 0;
+	return mWidths[line];
+}
+
+Float LineWidthIndex::getMaxWidth() const {
+	return mWidthCount.empty() ? 0 : mWidthCount.rbegin()->first;
+}
+
+size_t LineWidthIndex::countLinesWiderThan( const Float& width ) const {
+	size_t count = 0;
+	for ( auto it = mWidthCount.upper_bound( width ); it != mWidthCount.end(); ++it )
+		count += it->second;
+	return count;
+}
+
+void LineWidthIndex::insertLines( const Int64& line, const Int64& count ) {
+	if ( count <= 0 || line < 0 || line > (Int64)mWidths.size() )
+		return;
+	mWidths.insert( mWidths.begin() + line, count, 0 );
+	mWidthCount[0] += count;
+}
+
+void LineWidthIndex::removeLines( const Int64& line, const Int64& count ) {
+	if ( count <= 0 || line < 0 || line >= (Int64)mWidths.size() )
+		return;
+	auto start = mWidths.begin() + line;
+	auto end = start + eemin<Int64>( count, (Int64)mWidths.size() - line );
+	for ( auto it = start; it != end; ++it )
+		removeWidth( *it );
+	mWidths.erase( start, end );
+}
+
+void LineWidthIndex::addWidth( const Float& width ) {
+	mWidthCount[width]++;
+}
+
+void LineWidthIndex::removeWidth( const Float& width ) {
+	auto it = mWidthCount.find( width );
+	if ( it != mWidthCount.end() && --it->second == 0 )
+		mWidthCount.erase( it );
+}
+
+}}} // namespace EE::UI::Doc
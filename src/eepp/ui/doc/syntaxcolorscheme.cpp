@@ -221,17 +221,30 @@ const SyntaxColorScheme::Style& SyntaxColorScheme::getSyntaxStyle( const std::st
 	return StyleEmpty;
 }
 
+const SyntaxColorScheme::Style&
+SyntaxColorScheme::getSyntaxStyle( const SyntaxStyleType& type ) const {
+	if ( type == SyntaxStyleTypes::None )
+		return StyleEmpty;
+	if ( type >= mStyleTypeCache.size() )
+		mStyleTypeCache.resize( type + 1 );
+	if ( !mStyleTypeCache[type] )
+		mStyleTypeCache[type] = getSyntaxStyle( SyntaxStyleTypes::getName( type ) );
+	return *mStyleTypeCache[type];
+}
+
 bool SyntaxColorScheme::hasSyntaxStyle( const std::string& type ) const {
 	return mSyntaxColors.find( type ) != mSyntaxColors.end();
 }
 
 void SyntaxColorScheme::setSyntaxStyles( const std::unordered_map<std::string, Style>& styles ) {
 	mSyntaxColors.insert( styles.begin(), styles.end() );
+	mStyleTypeCache.clear();
 }
 
 void SyntaxColorScheme::setSyntaxStyle( const std::string& type,
 										const SyntaxColorScheme::Style& style ) {
 	mSyntaxColors[type] = style;
+	mStyleTypeCache.clear();
 }
 
 const SyntaxColorScheme::Style&
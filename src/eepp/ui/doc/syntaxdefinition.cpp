@@ -4,6 +4,18 @@
 
 namespace EE { namespace UI { namespace Doc {
 
+SyntaxPatternMatcher::SyntaxPatternMatcher( const std::vector<std::string>& patterns ) :
+	mStart( patterns.empty() ? ""
+							 : ( !patterns[0].empty() && patterns[0][0] == '^' ? patterns[0]
+																			  : "^" + patterns[0] ) ),
+	mEnd( patterns.size() >= 2 ? patterns[1] : "" ),
+	mEndAnchored( patterns.size() >= 2 ? "^" + patterns[1] : "" ),
+	mEscape( patterns.size() >= 3 ? patterns[2] : "" ),
+	mLineStartOnly( !patterns.empty() && !patterns[0].empty() && patterns[0][0] == '^' ) {
+	if ( !mStart.getFirstChars( mFirstChars ) )
+		mFirstChars.set();
+}
+
 SyntaxDefinition::SyntaxDefinition() {}
 
 SyntaxDefinition::SyntaxDefinition( const std::string& languageName,
@@ -20,7 +32,10 @@ SyntaxDefinition::SyntaxDefinition( const std::string& languageName,
 	mSymbols( symbols ),
 	mComment( comment ),
 	mHeaders( headers ),
-	mLSPName( lspName.empty() ? String::toLower( mLanguageName ) : lspName ) {}
+	mLSPName( lspName.empty() ? String::toLower( mLanguageName ) : lspName ) {
+	for ( const auto& symbol : mSymbols )
+		mSymbolTypes[symbol.first] = SyntaxStyleTypes::intern( symbol.second );
+}
 
 const std::vector<std::string>& SyntaxDefinition::getFiles() const {
 	return mFiles;
@@ -56,6 +71,13 @@ std::string SyntaxDefinition::getSymbol( const std::string& symbol ) const {
 	return "";
 }
 
+SyntaxStyleType SyntaxDefinition::getSymbolType( const std::string& symbol ) const {
+	auto it = mSymbolTypes.find( symbol );
+	if ( it != mSymbolTypes.end() )
+		return it->second;
+	return SyntaxStyleTypes::None;
+}
+
 SyntaxDefinition& SyntaxDefinition::addFileType( const std::string& fileType ) {
 	mFiles.push_back( fileType );
 	return *this;
@@ -78,6 +100,7 @@ SyntaxDefinition& SyntaxDefinition::addPatternToFront( const SyntaxPattern& patt
 SyntaxDefinition& SyntaxDefinition::addSymbol( const std::string& symbolName,
 											   const std::string& typeName ) {
 	mSymbols[symbolName] = typeName;
+	mSymbolTypes[symbolName] = SyntaxStyleTypes::intern( typeName );
 	return *this;
 }
 
@@ -109,6 +132,7 @@ void SyntaxDefinition::clearPatterns() {
 
 void SyntaxDefinition::clearSymbols() {
 	mSymbols.clear();
+	mSymbolTypes.clear();
 }
 
 const std::string& SyntaxDefinition::getLSPName() const {
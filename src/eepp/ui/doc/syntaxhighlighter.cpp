@@ -9,6 +9,10 @@ SyntaxHighlighter::SyntaxHighlighter( TextDocument* doc ) :
 	reset();
 }
 
+SyntaxHighlighter::~SyntaxHighlighter() {
+	cancelJob();
+}
+
 void SyntaxHighlighter::changeDoc( TextDocument* doc ) {
 	mDoc = doc;
 	reset();
@@ -16,6 +20,7 @@ void SyntaxHighlighter::changeDoc( TextDocument* doc ) {
 }
 
 void SyntaxHighlighter::reset() {
+	cancelJob();
 	mLines.clear();
 	mFirstInvalidLine = 0;
 	mMaxWantedLine = 0;
@@ -24,35 +29,115 @@ void SyntaxHighlighter::reset() {
 void SyntaxHighlighter::invalidate( Int64 lineIndex ) {
 	mFirstInvalidLine = eemin( lineIndex, mFirstInvalidLine );
 	mMaxWantedLine = eemin<Int64>( mMaxWantedLine, (Int64)mDoc->linesCount() - 1 );
+	if ( mAsync && mAsync->running && lineIndex < mJobEditLine ) {
+		// The running job results are only valid until the edited line, stop it as soon as
+		// possible so a new job can restart from there.
+		mJobEditLine = lineIndex;
+		mAsync->editLine = lineIndex;
+	}
 }
 
-TokenizedLine SyntaxHighlighter::tokenizeLine( const size_t& line, const Uint64& state ) {
+void SyntaxHighlighter::onDocumentTextChanged( const DocumentContentChange& change ) {
+	TextRange range( change.range.normalized() );
+	Int64 startLine = range.start().line();
+	Int64 linesRemoved = range.end().line() - startLine;
+	Int64 linesAdded = 0;
+	for ( const auto& ch : change.text )
+		if ( ch == '\n' )
+			linesAdded++;
+
+	if ( linesRemoved != linesAdded && startLine + 1 < (Int64)mLines.size() ) {
+		auto first = mLines.begin() + startLine + 1;
+		if ( linesRemoved > 0 )
+			mLines.erase( first, first + eemin<Int64>( linesRemoved, mLines.end() - first ) );
+		if ( linesAdded > 0 )
+			mLines.insert( mLines.begin() + startLine + 1, linesAdded, TokenizedLine() );
+	}
+
+	invalidate( startLine );
+}
+
+static void tokensBytesToChars( std::vector<SyntaxToken>& tokens, const std::string& text ) {
+	size_t charPos = 0;
+	for ( auto& token : tokens ) {
+		size_t charLen = 0;
+		const char* ptr = text.data() + token.pos;
+		const char* end = ptr + token.len;
+		for ( ; ptr < end; ++ptr ) {
+			if ( ( *ptr & 0xC0 ) != 0x80 )
+				++charLen;
+		}
+		token.pos = charPos;
+		token.len = charLen;
+		charPos += charLen;
+	}
+}
+
+static TokenizedLine tokenizeText( const SyntaxDefinition& syntax, const std::string& text,
+								   const size_t& charCount, const String::HashType& hash,
+								   const Uint64& state ) {
 	TokenizedLine tokenizedLine;
 	tokenizedLine.initState = state;
-	tokenizedLine.hash = mDoc->line( line ).getHash();
-	std::pair<std::vector<SyntaxToken>, Uint64> res = SyntaxTokenizer::tokenize(
-		mDoc->getSyntaxDefinition(), mDoc->line( line ).toUtf8(), state );
+	tokenizedLine.hash = hash;
+	std::pair<std::vector<SyntaxToken>, Uint64> res =
+		SyntaxTokenizer::tokenize( syntax, text, state );
 	tokenizedLine.tokens = std::move( res.first );
 	tokenizedLine.state = std::move( res.second );
+	tokenizedLine.tokenized = true;
+	// The tokens positions are converted to character positions, so the clients can use them
+	// directly against the document line.
+	if ( text.size() != charCount )
+		tokensBytesToChars( tokenizedLine.tokens, text );
 	return tokenizedLine;
 }
 
+TokenizedLine SyntaxHighlighter::tokenizeLine( const size_t& line, const Uint64& state ) {
+	const TextDocumentLine& docLine = mDoc->line( line );
+	return tokenizeText( mDoc->getSyntaxDefinition(), docLine.toUtf8(), docLine.size(),
+						 docLine.getHash(), state );
+}
+
+TokenizedLine& SyntaxHighlighter::getTokenizedLine( const size_t& index ) {
+	if ( index >= mLines.size() )
+		mLines.resize( eemax( index + 1, mDoc->linesCount() ) );
+	return mLines[index];
+}
+
+Uint64 SyntaxHighlighter::getLineInitState( const Int64& index ) const {
+	if ( index <= 0 || index > (Int64)mLines.size() || !mLines[index - 1].tokenized )
+		return SYNTAX_TOKENIZER_STATE_NONE;
+	return mLines[index - 1].state;
+}
+
+bool SyntaxHighlighter::isLineValid( const Int64& index ) const {
+	if ( index >= (Int64)mLines.size() || index >= (Int64)mDoc->linesCount() )
+		return false;
+	const TokenizedLine& line = mLines[index];
+	return line.tokenized && line.initState == getLineInitState( index ) &&
+		   line.hash == mDoc->line( index ).getHash();
+}
+
+void SyntaxHighlighter::skipValidLines() {
+	// The lines after an edit usually keep the same tokenizer state, once the tokenizer state
+	// converges all the lines below are still valid.
+	while ( isLineValid( mFirstInvalidLine ) )
+		mFirstInvalidLine++;
+}
+
 const std::vector<SyntaxToken>& SyntaxHighlighter::getLine( const size_t& index ) {
-	const auto& it = mLines.find( index );
-	if ( it == mLines.end() ||
-		 ( index < mDoc->linesCount() && mDoc->line( index ).getHash() != it->second.hash ) ) {
-		int prevState = SYNTAX_TOKENIZER_STATE_NONE;
-		if ( index > 0 ) {
-			auto prevIt = mLines.find( index - 1 );
-			if ( prevIt != mLines.end() ) {
-				prevState = prevIt->second.state;
-			}
-		}
-		mLines[index] = tokenizeLine( index, prevState );
-		return mLines[index].tokens;
-	}
+	static const std::vector<SyntaxToken> EMPTY_TOKENS;
+	if ( index >= mDoc->linesCount() )
+		return EMPTY_TOKENS;
 	mMaxWantedLine = eemax<Int64>( mMaxWantedLine, index );
-	return it->second.tokens;
+	TokenizedLine& line = getTokenizedLine( index );
+	if ( !line.tokenized || line.hash != mDoc->line( index ).getHash() ) {
+		Uint64 prevState = line.state;
+		bool wasTokenized = line.tokenized;
+		line = tokenizeLine( index, getLineInitState( index ) );
+		if ( wasTokenized && prevState != line.state )
+			invalidate( index + 1 );
+	}
+	return line.tokens;
 }
 
 Int64 SyntaxHighlighter::getFirstInvalidLine() const {
@@ -66,28 +151,34 @@ Int64 SyntaxHighlighter::getMaxWantedLine() const {
 bool SyntaxHighlighter::updateDirty( int visibleLinesCount ) {
 	if ( visibleLinesCount <= 0 )
 		return 0;
+
+	if ( isAsync() ) {
+		bool wasRunning = mAsync->running;
+		bool changed = publishSnapshots();
+		if ( !wasRunning ) {
+			skipValidLines();
+			if ( mFirstInvalidLine <= mMaxWantedLine &&
+				 mFirstInvalidLine < (Int64)mDoc->linesCount() )
+				runJob();
+		}
+		return changed;
+	}
+
 	if ( mFirstInvalidLine > mMaxWantedLine ) {
 		mMaxWantedLine = 0;
 	} else {
 		bool changed = false;
+		skipValidLines();
 		Int64 max = eemax( 0LL, eemin( mFirstInvalidLine + visibleLinesCount, mMaxWantedLine ) );
 
 		for ( Int64 index = mFirstInvalidLine; index <= max; index++ ) {
-			Uint64 state = SYNTAX_TOKENIZER_STATE_NONE;
-			if ( index > 0 ) {
-				auto prevIt = mLines.find( index - 1 );
-				if ( prevIt != mLines.end() ) {
-					state = prevIt->second.state;
-				}
-			}
-			const auto& it = mLines.find( index );
-			if ( it == mLines.end() || it->second.initState != state ) {
-				mLines[index] = tokenizeLine( index, state );
+			if ( !isLineValid( index ) && index < (Int64)mDoc->linesCount() ) {
+				getTokenizedLine( index ) = tokenizeLine( index, getLineInitState( index ) );
 				changed = true;
 			}
 		}
 
-		mFirstInvalidLine = max + 1;
+		mFirstInvalidLine = eemax( mFirstInvalidLine, max + 1 );
 		return changed;
 	}
 	return false;
@@ -95,11 +186,11 @@ bool SyntaxHighlighter::updateDirty( int visibleLinesCount ) {
 
 const SyntaxDefinition&
 SyntaxHighlighter::getSyntaxDefinitionFromTextPosition( const TextPosition& position ) {
-	auto found = mLines.find( position.line() );
-	if ( found == mLines.end() )
+	if ( position.line() < 0 || position.line() >= (Int64)mLines.size() ||
+		 !mLines[position.line()].tokenized )
 		return SyntaxDefinitionManager::instance()->getPlainStyle();
 
-	TokenizedLine& line = found->second;
+	TokenizedLine& line = mLines[position.line()];
 	SyntaxState state =
 		SyntaxTokenizer::retrieveSyntaxState( mDoc->getSyntaxDefinition(), line.state );
 
@@ -109,4 +200,118 @@ SyntaxHighlighter::getSyntaxDefinitionFromTextPosition( const TextPosition& posi
 	return *state.currentSyntax;
 }
 
+void SyntaxHighlighter::setThreadPool( std::shared_ptr<ThreadPool> pool ) {
+	if ( mPool == pool )
+		return;
+	cancelJob();
+	mPool = pool;
+	mAsync = mPool ? std::make_shared<AsyncState>() : nullptr;
+}
+
+const std::shared_ptr<ThreadPool>& SyntaxHighlighter::getThreadPool() const {
+	return mPool;
+}
+
+bool SyntaxHighlighter::isAsync() const {
+	return mPool != nullptr && mAsync != nullptr;
+}
+
+void SyntaxHighlighter::cancelJob() {
+	if ( !mAsync )
+		return;
+	mAsync->version++;
+	Lock l( mAsync->mutex );
+	mAsync->snapshots.clear();
+	// Nothing published by the cancelled job can be used anymore.
+	mJobEditLine = mAsync->running ? 0 : std::numeric_limits<Int64>::max();
+}
+
+bool SyntaxHighlighter::publishSnapshots() {
+	std::vector<Snapshot> snapshots;
+	{
+		Lock l( mAsync->mutex );
+		if ( mAsync->snapshots.empty() )
+			return false;
+		snapshots.swap( mAsync->snapshots );
+	}
+
+	bool changed = false;
+	Int64 linesCount = mDoc->linesCount();
+	for ( auto& snapshot : snapshots ) {
+		// The lines of a cancelled job could be tokenized with another syntax definition.
+		if ( snapshot.version != mAsync->version )
+			continue;
+		// Lines are only accepted if they continue the valid lines and they were not edited
+		// while the job was running.
+		Int64 end = eemin( eemin( snapshot.startLine + (Int64)snapshot.lines.size(), mJobEditLine ),
+						   linesCount );
+		for ( Int64 index = snapshot.startLine; index < end && index == mFirstInvalidLine;
+			  index++ ) {
+			TokenizedLine& tokenizedLine = snapshot.lines[index - snapshot.startLine];
+			if ( tokenizedLine.hash != mDoc->line( index ).getHash() ||
+				 tokenizedLine.initState != getLineInitState( index ) )
+				break;
+			getTokenizedLine( index ) = std::move( tokenizedLine );
+			mFirstInvalidLine++;
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+void SyntaxHighlighter::runJob() {
+	Int64 startLine = mFirstInvalidLine;
+	Int64 endLine = eemin<Int64>( eemin( startLine + MaxLinesPerJob, mMaxWantedLine + 1 ),
+								  mDoc->linesCount() );
+	if ( startLine >= endLine )
+		return;
+
+	struct JobLine {
+		std::string text;
+		size_t charCount;
+		String::HashType hash;
+	};
+
+	// The job works over a copy of the lines, so the document can be freely modified meanwhile.
+	auto lines = std::make_shared<std::vector<JobLine>>();
+	lines->reserve( endLine - startLine );
+	for ( Int64 i = startLine; i < endLine; i++ ) {
+		const TextDocumentLine& line = mDoc->line( i );
+		lines->push_back( { line.toUtf8(), line.size(), line.getHash() } );
+	}
+
+	std::shared_ptr<AsyncState> async = mAsync;
+	const SyntaxDefinition* syntax = &mDoc->getSyntaxDefinition();
+	Uint64 version = async->version;
+	Uint64 initState = getLineInitState( startLine );
+	mJobEditLine = std::numeric_limits<Int64>::max();
+	async->editLine = mJobEditLine;
+	async->running = true;
+
+	mPool->run( [async, syntax, version, initState, startLine, lines] {
+		Snapshot snapshot{ version, startLine, {} };
+		Uint64 state = initState;
+		for ( size_t i = 0; i < lines->size(); i++ ) {
+			const JobLine& line = ( *lines )[i];
+			snapshot.lines.emplace_back(
+				tokenizeText( *syntax, line.text, line.charCount, line.hash, state ) );
+			state = snapshot.lines.back().state;
+
+			if ( ( i + 1 ) % CheckpointInterval == 0 || i + 1 == lines->size() ) {
+				if ( async->version != version )
+					break;
+				Int64 nextLine = snapshot.startLine + snapshot.lines.size();
+				{
+					Lock l( async->mutex );
+					async->snapshots.emplace_back( std::move( snapshot ) );
+				}
+				if ( nextLine >= async->editLine )
+					break;
+				snapshot = Snapshot{ version, nextLine, {} };
+			}
+		}
+		async->running = false;
+	} );
+}
+
 }}} // namespace EE::UI::Doc
@@ -0,0 +1,70 @@
+#include <deque>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/mutex.hpp>
+#include <eepp/ui/doc/syntaxstyletype.hpp>
+#include <unordered_map>
+
+using namespace EE::System;
+
+namespace EE { namespace UI { namespace Doc {
+
+namespace {
+
+struct SyntaxStyleTypesTable {
+	Mutex mutex;
+	// A deque keeps the references to the names valid while new names are registered.
+	std::deque<std::string> names;
+	std::unordered_map<std::string, SyntaxStyleType> ids;
+
+	SyntaxStyleTypesTable() {
+		// Must follow the order of the SyntaxStyleTypes constants.
+		for ( const auto& name :
+			  { "normal", "symbol", "comment", "keyword", "keyword2", "number", "literal",
+				"string", "operator", "function", "link", "link_hover" } ) {
+			ids[name] = names.size();
+			names.emplace_back( name );
+		}
+	}
+};
+
+static SyntaxStyleTypesTable& getTable() {
+	static SyntaxStyleTypesTable table;
+	return table;
+}
+
+} // namespace
+
+SyntaxStyleType SyntaxStyleTypes::intern( const std::string& name ) {
+	SyntaxStyleTypesTable& table = getTable();
+	Lock l( table.mutex );
+	auto it = table.ids.find( name );
+	if ( it != table.ids.end() )
+		return it->second;
+	SyntaxStyleType id = table.names.size();
+	table.names.emplace_back( name );
+	table.ids[name] = id;
+	return id;
+}
+
+std::vector<SyntaxStyleType> SyntaxStyleTypes::intern( const std::vector<std::string>& names ) {
+	std::vector<SyntaxStyleType> types;
+	types.reserve( names.size() );
+	for ( const auto& name : names )
+		types.push_back( intern( name ) );
+	return types;
+}
+
+const std::string& SyntaxStyleTypes::getName( const SyntaxStyleType& type ) {
+	static const std::string empty;
+	SyntaxStyleTypesTable& table = getTable();
+	Lock l( table.mutex );
+	return type < table.names.size() ? table.names[type] : empty;
+}
+
+size_t SyntaxStyleTypes::count() {
+	SyntaxStyleTypesTable& table = getTable();
+	Lock l( table.mutex );
+	return table.names.size();
+}
+
+}}} // namespace EE::UI::Doc
@@ -27,30 +27,33 @@ static int isInMultiByteCodePoint( const char* text, const size_t& textSize, con
 	return 0;
 }
 
-static void pushToken( std::vector<SyntaxToken>& tokens, const std::string& type,
-					   const std::string& text ) {
-	if ( !tokens.empty() && ( tokens[tokens.size() - 1].type == type ) ) {
-		tokens[tokens.size() - 1].type = type;
-		tokens[tokens.size() - 1].text += text;
+static void pushToken( std::vector<SyntaxToken>& tokens, const SyntaxStyleType& type,
+					   const std::string& text, const size_t& pos, const size_t& len ) {
+	// Only contiguous spans can be merged, the tokenizer can skip text between two tokens of the
+	// same type (the subsyntax separators and the discarded captures).
+	if ( !tokens.empty() && tokens.back().type == type &&
+		 tokens.back().pos + tokens.back().len == pos ) {
+		tokens.back().len += len;
 	} else {
-		if ( text.size() > MAX_TOKEN_SIZE ) {
-			size_t textSize = text.size();
-			size_t pos = 0;
+		if ( len > MAX_TOKEN_SIZE ) {
+			size_t textSize = len;
+			size_t chunkPos = pos;
 			size_t chunkSize = 0;
 			int multiByteCodePointPos = 0;
 
 			while ( textSize > 0 ) {
 				chunkSize = textSize > MAX_TOKEN_SIZE ? MAX_TOKEN_SIZE : textSize;
-				if ( ( multiByteCodePointPos = isInMultiByteCodePoint( text.c_str(), text.size(),
-																	   pos + chunkSize ) ) > 0 ) {
+				if ( ( multiByteCodePointPos = isInMultiByteCodePoint(
+						   text.c_str(), pos + len, chunkPos + chunkSize ) ) > 0 ) {
 					chunkSize = eemin( textSize, chunkSize + multiByteCodePointPos );
 				}
-				tokens.push_back( { type, text.substr( pos, chunkSize ) } );
+				tokens.push_back(
+					{ type, static_cast<Uint32>( chunkPos ), static_cast<Uint32>( chunkSize ) } );
 				textSize -= chunkSize;
-				pos += chunkSize;
+				chunkPos += chunkSize;
 			}
 		} else {
-			tokens.push_back( { type, text } );
+			tokens.push_back( { type, static_cast<Uint32>( pos ), static_cast<Uint32>( len ) } );
 		}
 	}
 }
@@ -66,16 +69,15 @@ bool isScaped( const std::string& text, const size_t& startIndex, const std::str
 	return count % 2 == 1;
 }
 
-std::pair<int, int> findNonEscaped( const std::string& text, const std::string& pattern, int offset,
-									const std::string& escapeStr ) {
+static std::pair<int, int> findNonEscaped( const std::string& text, const LuaPattern& pattern,
+										   int offset, const std::string& escapeStr ) {
+	LuaPattern::Range matches[12];
 	while ( true ) {
-		LuaPattern words( pattern );
-		int start, end;
-		if ( words.find( text, start, end, offset ) ) {
-			if ( !escapeStr.empty() && isScaped( text, start, escapeStr ) ) {
-				offset = end;
+		if ( pattern.countMatches( text.c_str(), offset, matches, text.size() ) > 0 ) {
+			if ( !escapeStr.empty() && isScaped( text, matches[0].start, escapeStr ) ) {
+				offset = matches[0].end;
 			} else {
-				return std::make_pair( start, end );
+				return std::make_pair( matches[0].start, matches[0].end );
 			}
 		} else {
 			return std::make_pair( -1, -1 );
@@ -118,12 +120,13 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 						   const Uint32& state, const size_t& startIndex,
 						   bool skipSubSyntaxSeparator ) {
 	std::vector<SyntaxToken> tokens;
+	std::string patternText;
 	LuaPattern::Range matches[12];
 	int start, end;
 	size_t numMatches;
 
 	if ( syntax.getPatterns().empty() ) {
-		pushToken( tokens, "normal", text );
+		pushToken( tokens, SyntaxStyleTypes::Normal, text, 0, text.size() );
 		return std::make_pair( tokens, SYNTAX_TOKENIZER_STATE_NONE );
 	}
 
@@ -158,24 +161,21 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 		if ( curState.currentPatternIdx != SYNTAX_TOKENIZER_STATE_NONE ) {
 			const SyntaxPattern& pattern =
 				curState.currentSyntax->getPatterns()[curState.currentPatternIdx - 1];
-			std::pair<int, int> range =
-				findNonEscaped( text, pattern.patterns[1], i,
-								pattern.patterns.size() >= 3 ? pattern.patterns[2] : "" );
+			std::pair<int, int> range = findNonEscaped( text, pattern.matcher->getEnd(), i,
+														pattern.matcher->getEscape() );
 
 			bool skip = false;
 
 			if ( curState.subsyntaxInfo != nullptr ) {
 				std::pair<int, int> rangeSubsyntax =
-					findNonEscaped( text, curState.subsyntaxInfo->patterns[1], i,
-									curState.subsyntaxInfo->patterns.size() >= 3
-										? curState.subsyntaxInfo->patterns[2]
-										: "" );
+					findNonEscaped( text, curState.subsyntaxInfo->matcher->getEnd(), i,
+									curState.subsyntaxInfo->matcher->getEscape() );
 
 				if ( rangeSubsyntax.first != -1 &&
 					 ( range.first == -1 || rangeSubsyntax.first < range.first ) ) {
 					if ( !skipSubSyntaxSeparator ) {
-						pushToken( tokens, curState.subsyntaxInfo->types[0],
-								   text.substr( i, rangeSubsyntax.second - i ) );
+						pushToken( tokens, curState.subsyntaxInfo->typeIds[0], text, i,
+								   rangeSubsyntax.second - i );
 					}
 					popSubsyntax();
 					i = rangeSubsyntax.second;
@@ -185,26 +185,25 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 
 			if ( !skip ) {
 				if ( range.first != -1 ) {
-					pushToken( tokens, pattern.types[0], text.substr( i, range.second - i ) );
+					pushToken( tokens, pattern.typeIds[0], text, i, range.second - i );
 					setSubsyntaxPatternIdx( SYNTAX_TOKENIZER_STATE_NONE );
 					i = range.second;
 				} else {
-					pushToken( tokens, pattern.types[0], text.substr( i ) );
+					pushToken( tokens, pattern.typeIds[0], text, i, text.size() - i );
 					break;
 				}
 			}
 		}
 
 		if ( curState.subsyntaxInfo != nullptr ) {
-			std::pair<int, int> rangeSubsyntax = findNonEscaped(
-				text, "^" + curState.subsyntaxInfo->patterns[1], i,
-				curState.subsyntaxInfo->patterns.size() >= 3 ? curState.subsyntaxInfo->patterns[2]
-															 : "" );
+			std::pair<int, int> rangeSubsyntax =
+				findNonEscaped( text, curState.subsyntaxInfo->matcher->getEndAnchored(), i,
+								curState.subsyntaxInfo->matcher->getEscape() );
 
 			if ( rangeSubsyntax.first != -1 ) {
 				if ( !skipSubSyntaxSeparator ) {
-					pushToken( tokens, curState.subsyntaxInfo->types[0],
-							   text.substr( i, rangeSubsyntax.second - i ) );
+					pushToken( tokens, curState.subsyntaxInfo->typeIds[0], text, i,
+							   rangeSubsyntax.second - i );
 				}
 				popSubsyntax();
 				i = rangeSubsyntax.second;
@@ -216,18 +215,15 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 		for ( size_t patternIndex = 0; patternIndex < curState.currentSyntax->getPatterns().size();
 			  patternIndex++ ) {
 			const SyntaxPattern& pattern = curState.currentSyntax->getPatterns()[patternIndex];
-			if ( i != 0 && pattern.patterns[0][0] == '^' )
+			const SyntaxPatternMatcher& matcher = *pattern.matcher;
+			if ( ( i != 0 && matcher.isLineStartOnly() ) || !matcher.canStartWith( text[i] ) )
 				continue;
-			const std::string& patternStr(
-				pattern.patterns[0][0] == '^' ? pattern.patterns[0] : "^" + pattern.patterns[0] );
-			LuaPattern words( patternStr );
-			if ( words.matches( text, matches, i ) && ( numMatches = words.getNumMatches() ) > 0 ) {
+			if ( ( numMatches = matcher.getStart().countMatches( text.c_str(), i, matches,
+																 text.size() ) ) > 0 ) {
 				if ( numMatches > 1 ) {
 					int patternMatchStart = matches[0].start;
 					int patternMatchEnd = matches[0].end;
-					std::string patternFullText(
-						text.substr( patternMatchStart, patternMatchEnd - patternMatchStart ) );
-					std::string patternType = pattern.types[0];
+					SyntaxStyleType patternType = pattern.typeIds[0];
 					int lastStart = patternMatchStart;
 					int lastEnd = patternMatchEnd;
 
@@ -238,23 +234,22 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 							 text[i - 1] == pattern.patterns[2][0] )
 							continue;
 						if ( curMatch == 1 && start > lastStart ) {
-							pushToken(
-								tokens, patternType,
-								text.substr( patternMatchStart, start - patternMatchStart ) );
+							pushToken( tokens, patternType, text, patternMatchStart,
+									   start - patternMatchStart );
 						} else if ( start > lastEnd ) {
-							pushToken( tokens, patternType,
-									   text.substr( lastEnd, start - lastEnd ) );
+							pushToken( tokens, patternType, text, lastEnd, start - lastEnd );
 						}
 
-						std::string patternText( text.substr( start, end - start ) );
-						std::string type = curState.currentSyntax->getSymbol( patternText );
+						patternText.assign( text, start, end - start );
+						SyntaxStyleType type = curState.currentSyntax->getSymbolType( patternText );
 						if ( !skipSubSyntaxSeparator || pattern.syntax.empty() ) {
 							pushToken( tokens,
-									   type.empty() ? ( curMatch < pattern.types.size()
-															? pattern.types[curMatch]
-															: pattern.types[0] )
-													: type,
-									   patternText );
+									   type == SyntaxStyleTypes::None
+										   ? ( curMatch < pattern.typeIds.size()
+												   ? pattern.typeIds[curMatch]
+												   : pattern.typeIds[0] )
+										   : type,
+									   text, start, end - start );
 						}
 
 						if ( !pattern.syntax.empty() ) {
@@ -266,8 +261,7 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 						i = end;
 
 						if ( curMatch == numMatches - 1 && end < patternMatchEnd ) {
-							pushToken( tokens, patternType,
-									   text.substr( end, patternMatchEnd - end ) );
+							pushToken( tokens, patternType, text, end, patternMatchEnd - end );
 							i = patternMatchEnd;
 						}
 
@@ -283,15 +277,16 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 						if ( pattern.patterns.size() >= 3 && i > 0 &&
 							 text[i - 1] == pattern.patterns[2][0] )
 							continue;
-						std::string patternText( text.substr( start, end - start ) );
-						std::string type = curState.currentSyntax->getSymbol( patternText );
+						patternText.assign( text, start, end - start );
+						SyntaxStyleType type = curState.currentSyntax->getSymbolType( patternText );
 						if ( !skipSubSyntaxSeparator || pattern.syntax.empty() ) {
 							pushToken( tokens,
-									   type.empty() ? ( curMatch < pattern.types.size()
-															? pattern.types[curMatch]
-															: pattern.types[0] )
-													: type,
-									   patternText );
+									   type == SyntaxStyleTypes::None
+										   ? ( curMatch < pattern.typeIds.size()
+												   ? pattern.typeIds[curMatch]
+												   : pattern.typeIds[0] )
+										   : type,
+									   text, start, end - start );
 						}
 						if ( !pattern.syntax.empty() ) {
 							pushSubsyntax( pattern, patternIndex + 1 );
@@ -307,7 +302,7 @@ SyntaxTokenizer::tokenize( const SyntaxDefinition& syntax, const std::string& te
 		}
 
 		if ( !matched && i < text.size() ) {
-			pushToken( tokens, "normal", text.substr( i, 1 ) );
+			pushToken( tokens, SyntaxStyleTypes::Normal, text, i, 1 );
 			i += 1;
 		}
 	}
@@ -319,41 +314,43 @@ Text& SyntaxTokenizer::tokenizeText( const SyntaxDefinition& syntax,
 									 const SyntaxColorScheme& colorScheme, Text& text,
 									 const size_t& startIndex, const size_t& endIndex,
 									 bool skipSubSyntaxSeparator, const std::string& trimChars ) {
-
-	auto tokens = SyntaxTokenizer::tokenize( syntax, text.getString(), SYNTAX_TOKENIZER_STATE_NONE,
-											 startIndex, skipSubSyntaxSeparator )
+	std::string str( text.getString().toUtf8() );
+	auto tokens = SyntaxTokenizer::tokenize( syntax, str, SYNTAX_TOKENIZER_STATE_NONE, startIndex,
+											 skipSubSyntaxSeparator )
 					  .first;
 
 	if ( skipSubSyntaxSeparator || !trimChars.empty() ) {
-		String txt;
+		std::string txt;
 		size_t c = 0;
 		for ( auto& token : tokens ) {
+			std::string_view tokenText( str.data() + token.pos, token.len );
 			if ( c == 0 ) {
-				auto f = token.text.find_first_not_of( trimChars );
-				if ( f == std::string::npos ) {
-					token.text.clear();
+				auto f = tokenText.find_first_not_of( trimChars );
+				if ( f == std::string_view::npos ) {
+					token.len = 0;
 				} else if ( f > 0 ) {
-					token.text = token.text.substr( f );
+					token.pos += f;
+					token.len -= f;
 				}
 			} else if ( c == tokens.size() - 1 ) {
-				auto f = token.text.find_last_not_of( trimChars );
-				if ( f == std::string::npos ) {
-					token.text.clear();
-				} else if ( f >= 0 && f + 1 <= token.text.size() ) {
-					token.text = token.text.substr( 0, f + 1 );
+				auto f = tokenText.find_last_not_of( trimChars );
+				if ( f == std::string_view::npos ) {
+					token.len = 0;
+				} else if ( f + 1 <= token.len ) {
+					token.len = f + 1;
 				}
 			}
-			if ( token.text.size() )
-				txt += token.text;
+			if ( token.len )
+				txt.append( str, token.pos, token.len );
 			++c;
 		}
-		text.setString( txt );
+		text.setString( String::fromUtf8( txt ) );
 	}
 
 	size_t start = startIndex;
 	for ( auto& token : tokens ) {
 		if ( start < endIndex ) {
-			size_t strSize = String::utf8Length( token.text );
+			size_t strSize = String::utf8Length( str.substr( token.pos, token.len ) );
 			if ( strSize > 0 )
 				text.setFillColor( colorScheme.getSyntaxStyle( token.type ).color, start,
 								   std::min( start + strSize, endIndex ) );
@@ -861,9 +861,18 @@ TextPosition TextDocument::insert( const size_t& cursorIdx, TextPosition positio
 	mLines[position.line()] = TextDocumentLine( lines[0] );
 	notifyLineChanged( position.line() );
 
-	for ( Int64 i = 1; i < (Int64)lines.size(); i++ ) {
-		mLines.insert( mLines.begin() + position.line() + i, TextDocumentLine( lines[i] ) );
-		notifyLineChanged( position.line() + i );
+	if ( lines.size() > 1 ) {
+		// Insert all the new lines at once, so the lines below the insertion point are only
+		// shifted one time.
+		std::vector<TextDocumentLine> newLines;
+		newLines.reserve( lines.size() - 1 );
+		for ( size_t i = 1; i < lines.size(); i++ )
+			newLines.emplace_back( lines[i] );
+		mLines.insert( mLines.begin() + position.line() + 1,
+					   std::make_move_iterator( newLines.begin() ),
+					   std::make_move_iterator( newLines.end() ) );
+		for ( Int64 i = 1; i < (Int64)lines.size(); i++ )
+			notifyLineChanged( position.line() + i );
 	}
 
 	TextPosition cursor = positionOffset( position, text.size() );
@@ -717,6 +717,9 @@ bool FileSystemModel::handleFileEvent( const FileEvent& event ) {
 		Lock l( resourceMutex() );
 
 		ret = handleFileEventLocked( event );
+
+		/* The moves rename and reinsert the nodes without an operation */
+		increaseGeneration();
 	}
 
 	onModelUpdate( UpdateFlag::DontInvalidateIndexes );
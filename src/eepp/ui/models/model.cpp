@@ -5,6 +5,7 @@
 namespace EE { namespace UI { namespace Models {
 
 void Model::onModelUpdate( unsigned flags ) {
+	increaseGeneration();
 	if ( mOnUpdate )
 		mOnUpdate();
 	for ( auto& client : mClients )
@@ -159,6 +160,7 @@ void Model::saveDeletedIndices( ModelIndex const& parent, int first, int last )
 }
 
 void Model::endInsertRows() {
+	increaseGeneration();
 	auto operation = mOperationStack.top();
 	mOperationStack.pop();
 	eeASSERT( operation.type == OperationType::Insert );
@@ -171,6 +173,7 @@ void Model::endInsertRows() {
 }
 
 void Model::endInsertColumns() {
+	increaseGeneration();
 	auto operation = mOperationStack.top();
 	mOperationStack.pop();
 	eeASSERT( operation.type == OperationType::Insert );
@@ -182,6 +185,7 @@ void Model::endInsertColumns() {
 }
 
 void Model::endMoveRows() {
+	increaseGeneration();
 	auto operation = mOperationStack.top();
 	mOperationStack.pop();
 	eeASSERT( operation.type == OperationType::Move );
@@ -194,6 +198,7 @@ void Model::endMoveRows() {
 }
 
 void Model::endMoveColumns() {
+	increaseGeneration();
 	auto operation = mOperationStack.top();
 	mOperationStack.pop();
 	eeASSERT( operation.type == OperationType::Move );
@@ -207,6 +212,7 @@ void Model::endMoveColumns() {
 }
 
 void Model::endDeleteRows() {
+	increaseGeneration();
 	auto operation = mOperationStack.top();
 	mOperationStack.pop();
 	eeASSERT( operation.type == OperationType::Delete );
@@ -219,6 +225,7 @@ void Model::endDeleteRows() {
 }
 
 void Model::endDeleteColumns() {
+	increaseGeneration();
 	auto operation = mOperationStack.top();
 	mOperationStack.pop();
 	eeASSERT( operation.type == OperationType::Delete );
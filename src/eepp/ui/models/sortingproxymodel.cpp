@@ -8,6 +8,36 @@ using namespace EE::UI::Abstract;
 
 namespace EE { namespace UI { namespace Models {
 
+/* Minimum number of rows sorted by each thread of the parallel sort */
+static constexpr size_t PARALLEL_SORT_JOB_ROWS = 16384;
+
+template <typename Compare>
+static void parallelStableSort( ThreadPool& pool, std::vector<int>::iterator first,
+								std::vector<int>::iterator last, Compare compare, size_t jobs ) {
+	size_t count = last - first;
+	std::vector<size_t> bounds;
+	for ( size_t i = 0; i <= jobs; i++ )
+		bounds.push_back( count * i / jobs );
+
+	pool.parallelFor( jobs, [first, &bounds, &compare]( size_t i ) {
+		std::stable_sort( first + bounds[i], first + bounds[i + 1], compare );
+	} );
+
+	/* The sorted runs are merged in pairs, keeping the order of the runs to keep it stable */
+	while ( bounds.size() > 2 ) {
+		std::vector<size_t> merged{ 0 };
+		for ( size_t i = 0; i + 2 < bounds.size(); i += 2 )
+			merged.push_back( bounds[i + 2] );
+		if ( bounds.size() % 2 == 0 )
+			merged.push_back( bounds.back() );
+		pool.parallelFor( ( bounds.size() - 1 ) / 2, [first, &bounds, &compare]( size_t i ) {
+			std::inplace_merge( first + bounds[i * 2], first + bounds[i * 2 + 1],
+								first + bounds[i * 2 + 2], compare );
+		} );
+		bounds.swap( merged );
+	}
+}
+
 SortingProxyModel::SortingProxyModel( std::shared_ptr<Model> target ) :
 	mSource( target ), mKeyColumn( -1 ) {
 	mSource->registerClient( this );
@@ -19,14 +49,17 @@ SortingProxyModel::~SortingProxyModel() {
 }
 
 void SortingProxyModel::invalidate( unsigned int flags ) {
-	if ( flags == UpdateFlag::DontInvalidateIndexes ) {
-		sort( mKeyColumn, mSortOrder );
-	} else {
+	if ( flags & UpdateFlag::InvalidateAllIndexes ) {
 		mMappings.clear();
 
 		// FIXME: This is really harsh, but without precise invalidation, not much we can do.
 		forEachView( [&]( UIAbstractView* view ) { view->getSelection().clear( false ); } );
 		forEachView( [&]( UIAbstractView* view ) { view->notifySelectionChange(); } );
+	} else if ( flags & UpdateFlag::RowsAppended ) {
+		for ( auto& it : mMappings )
+			sortAppendedRows( *it.second );
+	} else {
+		sort( mKeyColumn, mSortOrder );
 	}
 	onModelUpdate( flags );
 }
@@ -206,49 +239,152 @@ std::shared_ptr<Model> SortingProxyModel::getSource() const {
 	return mSource;
 }
 
+void SortingProxyModel::setThreadPool( std::shared_ptr<ThreadPool> pool ) {
+	mThreadPool = pool;
+}
+
+const std::shared_ptr<ThreadPool>& SortingProxyModel::getThreadPool() const {
+	return mThreadPool;
+}
+
 bool SortingProxyModel::isColumnSortable( const size_t& columnIndex ) const {
 	return source().isColumnSortable( columnIndex );
 }
 
+SortingProxyModel::SortKey SortingProxyModel::getSortKey( const ModelIndex& sourceIndex ) const {
+	SortKey key;
+	Variant data( mSource->data( sourceIndex, mSortRole ) );
+	key.isNumber = true;
+
+	if ( data.is( Variant::Type::Bool ) ) {
+		key.number = data.asBool();
+	} else if ( data.is( Variant::Type::Float ) ) {
+		key.number = data.asFloat();
+	} else if ( data.is( Variant::Type::Int ) ) {
+		key.number = data.asInt();
+	} else if ( data.is( Variant::Type::Uint ) ) {
+		key.number = data.asUint();
+	} else if ( data.is( Variant::Type::Int64 ) ) {
+		key.number = data.asInt64();
+	} else if ( data.is( Variant::Type::Uint64 ) ) {
+		key.number = data.asUint64();
+	} else {
+		key.isNumber = false;
+		if ( data.is( Variant::Type::StdString ) )
+			key.text = data.asStdString();
+		else if ( data.is( Variant::Type::cstr ) )
+			key.text = data.asCStr() ? data.asCStr() : "";
+		else
+			key.text = data.toString();
+		if ( !mSortingCaseSensitive )
+			String::toLowerInPlace( key.text );
+	}
+
+	return key;
+}
+
+bool SortingProxyModel::keyLessThan( const SortKey& key1, const SortKey& key2 ) {
+	if ( key1.isNumber != key2.isNumber )
+		return key1.isNumber;
+	if ( key1.isNumber )
+		return key1.number < key2.number;
+	return key1.text < key2.text;
+}
+
 bool SortingProxyModel::lessThan( const ModelIndex& index1, const ModelIndex& index2 ) const {
-	auto data1 = mSource->data( index1, mSortRole );
-	auto data2 = mSource->data( index2, mSortRole );
-	if ( data1.is( Variant::Type::StdString ) && data2.is( Variant::Type::StdString ) )
-		return String::toLower( data1.asString() ) < String::toLower( data2.asString() );
-	if ( data1.is( Variant::Type::cstr ) && data2.is( Variant::Type::cstr ) )
-		return String::toLower( std::string( data1.asCStr() ) ) <
-			   String::toLower( std::string( data2.asCStr() ) );
-	return data1 < data2;
+	return keyLessThan( getSortKey( index1 ), getSortKey( index2 ) );
+}
+
+void SortingProxyModel::extractKeys( Mapping& mapping, int column, int fromRow, int toRow ) {
+	mapping.keys.resize( fromRow );
+	mapping.keys.reserve( toRow );
+	for ( int row = fromRow; row < toRow; ++row )
+		mapping.keys.emplace_back(
+			getSortKey( mSource->index( row, column, mapping.sourceParent ) ) );
+}
+
+void SortingProxyModel::sortRows( std::vector<int>& rows, size_t firstRow,
+								  const std::vector<SortKey>& keys, SortOrder sortOrder ) {
+	bool ascending = sortOrder == SortOrder::Ascending;
+	auto compare = [&keys, ascending]( int row1, int row2 ) -> bool {
+		return ascending ? keyLessThan( keys[row1], keys[row2] )
+						 : keyLessThan( keys[row2], keys[row1] );
+	};
+
+	auto first = rows.begin() + firstRow;
+	size_t count = rows.end() - first;
+	size_t jobs = mThreadPool ? eemin<size_t>( mThreadPool->numThreads() + 1,
+											   count / PARALLEL_SORT_JOB_ROWS )
+							  : 1;
+
+	if ( jobs > 1 ) {
+		parallelStableSort( *mThreadPool, first, rows.end(), compare, jobs );
+	} else {
+		std::stable_sort( first, rows.end(), compare );
+	}
+
+	if ( firstRow > 0 )
+		std::inplace_merge( rows.begin(), first, rows.end(), compare );
 }
 
 void SortingProxyModel::sortMapping( SortingProxyModel::Mapping& mapping, int column,
 									 SortOrder sortOrder ) {
+	int rowCount = source().rowCount( mapping.sourceParent );
+	auto oldSourceRows = mapping.sourceRows;
+
+	mapping.sourceRows.resize( rowCount );
+	mapping.proxyRows.resize( rowCount );
+	for ( int i = 0; i < rowCount; ++i )
+		mapping.sourceRows[i] = i;
+
 	if ( column == -1 ) {
-		int rowCount = source().rowCount( mapping.sourceParent );
-		for ( int i = 0; i < rowCount; ++i ) {
-			mapping.sourceRows[i] = i;
+		for ( int i = 0; i < rowCount; ++i )
 			mapping.proxyRows[i] = i;
-		}
+		mapping.keys.clear();
 		return;
 	}
 
-	auto oldSourceRows = mapping.sourceRows;
+	/* The keys are extracted once, instead of querying the source in every comparison */
+	extractKeys( mapping, column, 0, rowCount );
+	sortRows( mapping.sourceRows, 0, mapping.keys, sortOrder );
 
-	int rowCount = source().rowCount( mapping.sourceParent );
 	for ( int i = 0; i < rowCount; ++i )
+		mapping.proxyRows[mapping.sourceRows[i]] = i;
+
+	updateSelection( mapping, oldSourceRows );
+}
+
+void SortingProxyModel::sortAppendedRows( Mapping& mapping ) {
+	int rowCount = source().rowCount( mapping.sourceParent );
+	int oldRowCount = mapping.sourceRows.size();
+
+	if ( mKeyColumn == -1 || rowCount < oldRowCount ||
+		 mapping.keys.size() != mapping.sourceRows.size() ) {
+		sortMapping( mapping, mKeyColumn, mSortOrder );
+		return;
+	}
+
+	if ( rowCount == oldRowCount )
+		return;
+
+	auto oldSourceRows = mapping.sourceRows;
+
+	extractKeys( mapping, mKeyColumn, oldRowCount, rowCount );
+	mapping.sourceRows.resize( rowCount );
+	mapping.proxyRows.resize( rowCount );
+	for ( int i = oldRowCount; i < rowCount; ++i )
 		mapping.sourceRows[i] = i;
 
-	std::stable_sort(
-		mapping.sourceRows.begin(), mapping.sourceRows.end(), [&]( auto row1, auto row2 ) -> bool {
-			bool isLessThan =
-				this->lessThan( mSource->index( row1, column, mapping.sourceParent ),
-								mSource->index( row2, column, mapping.sourceParent ) );
-			return sortOrder == SortOrder::Ascending ? isLessThan : !isLessThan;
-		} );
+	sortRows( mapping.sourceRows, oldRowCount, mapping.keys, mSortOrder );
 
 	for ( int i = 0; i < rowCount; ++i )
 		mapping.proxyRows[mapping.sourceRows[i]] = i;
 
+	updateSelection( mapping, oldSourceRows );
+}
+
+void SortingProxyModel::updateSelection( Mapping& mapping,
+										 const std::vector<int>& oldSourceRows ) {
 	// FIXME: I really feel like this should be done at the view layer somehow.
 	forEachView( [&]( UIAbstractView* view ) {
 		// Update the view's selection.
@@ -258,8 +394,9 @@ void SortingProxyModel::sortMapping( SortingProxyModel::Mapping& mapping, int co
 			selection.forEachIndex( [&]( const ModelIndex& index ) {
 				if ( index.parent() == mapping.sourceParent ) {
 					staleIndexesInSelection.push_back( index );
-					selectedIndexesInSource.push_back( source().index(
-						oldSourceRows[index.row()], index.column(), mapping.sourceParent ) );
+					if ( index.row() < (Int64)oldSourceRows.size() )
+						selectedIndexesInSource.push_back( source().index(
+							oldSourceRows[index.row()], index.column(), mapping.sourceParent ) );
 				}
 			} );
 
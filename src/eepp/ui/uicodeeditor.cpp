@@ -324,6 +324,17 @@ void UICodeEditor::draw() {
 		}
 	}
 
+	// Keep only the lines around the visible ones.
+	if ( mLineRenderCache.size() > 2 * ( lineRange.second - lineRange.first + 1 ) ) {
+		for ( auto it = mLineRenderCache.begin(); it != mLineRenderCache.end(); ) {
+			if ( it->first < (Int64)lineRange.first || it->first > (Int64)lineRange.second ) {
+				it = mLineRenderCache.erase( it );
+			} else {
+				++it;
+			}
+		}
+	}
+
 	for ( const auto& cursor : mDoc->getSelections() )
 		drawCursor( startScroll, lineHeight, cursor.start() );
 
@@ -395,6 +406,7 @@ void UICodeEditor::updateLongestLineWidth() {
 void UICodeEditor::reset() {
 	mDoc->reset();
 	mHighlighter.reset();
+	invalidateLongestLineWidth();
 	invalidateDraw();
 }
 
@@ -531,7 +543,9 @@ void UICodeEditor::onFontStyleChanged() {
 	udpateGlyphWidth();
 }
 
-void UICodeEditor::onDocumentLoaded( TextDocument* ) {}
+void UICodeEditor::onDocumentLoaded( TextDocument* ) {
+	invalidateLongestLineWidth();
+}
 
 void UICodeEditor::onDocumentLoaded() {
 	DocEvent event( this, mDoc.get(), Event::OnDocumentLoaded );
@@ -635,7 +649,10 @@ const Uint32& UICodeEditor::getTabWidth() const {
 }
 
 UICodeEditor* UICodeEditor::setTabWidth( const Uint32& tabWidth ) {
-	mTabWidth = tabWidth;
+	if ( mTabWidth != tabWidth ) {
+		mTabWidth = tabWidth;
+		mLineRenderCache.clear();
+	}
 	return this;
 }
 
@@ -745,6 +762,7 @@ const SyntaxColorScheme& UICodeEditor::getColorScheme() const {
 }
 
 void UICodeEditor::updateColorScheme() {
+	mLineRenderCache.clear();
 	setBackgroundColor( mColorScheme.getEditorColor( "background" ) );
 	setFontColor( mColorScheme.getEditorColor( "text" ) );
 	mFontStyleConfig.setFontSelectionBackColor( mColorScheme.getEditorColor( "selection" ) );
@@ -794,7 +812,9 @@ void UICodeEditor::setDocument( std::shared_ptr<TextDocument> doc ) {
 			onDocumentClosed( mDoc.get() );
 		mDoc = doc;
 		mDoc->registerClient( this );
+		mLineRenderCache.clear();
 		mHighlighter.changeDoc( mDoc.get() );
+		invalidateLongestLineWidth();
 		invalidateEditor();
 		invalidateDraw();
 		onDocumentChanged();
@@ -1375,13 +1395,45 @@ void UICodeEditor::onPaddingChange() {
 
 void UICodeEditor::findLongestLine() {
 	if ( mHorizontalScrollBarEnabled ) {
-		mLongestLineWidth = 0;
-		for ( size_t lineIndex = 0; lineIndex < mDoc->linesCount(); lineIndex++ ) {
-			mLongestLineWidth = eemax( mLongestLineWidth, getLineWidth( lineIndex ) );
-		}
+		mLineWidthIndex.reset( mDoc->linesCount() );
+		for ( size_t lineIndex = 0; lineIndex < mDoc->linesCount(); lineIndex++ )
+			mLineWidthIndex.setWidth( lineIndex, getLineWidth( lineIndex ) );
+		mLongestLineWidth = mLineWidthIndex.getMaxWidth();
 	}
 }
 
+void UICodeEditor::updateLineWidthIndex( const DocumentContentChange& change ) {
+	if ( !mHorizontalScrollBarEnabled || mLongestLineWidthDirty || mDoc->isLoading() )
+		return;
+
+	// The index was never built or it's out of sync with the document, measure everything again.
+	if ( mLineWidthIndex.empty() ) {
+		invalidateLongestLineWidth();
+		return;
+	}
+
+	TextRange range( change.range.normalized() );
+	Int64 startLine = range.start().line();
+	Int64 linesRemoved = range.end().line() - startLine;
+	Int64 linesAdded = std::count( change.text.begin(), change.text.end(), '\n' );
+
+	mLineWidthIndex.removeLines( startLine + 1, linesRemoved );
+	mLineWidthIndex.insertLines( startLine + 1, linesAdded );
+
+	if ( mLineWidthIndex.size() != mDoc->linesCount() ) {
+		invalidateLongestLineWidth();
+		return;
+	}
+
+	for ( Int64 lineIndex = startLine; lineIndex <= startLine + linesAdded; lineIndex++ )
+		mLineWidthIndex.setWidth( lineIndex, getLineWidth( lineIndex ) );
+
+	Float maxWidth = mLongestLineWidth;
+	mLongestLineWidth = mLineWidthIndex.getMaxWidth();
+	if ( maxWidth != mLongestLineWidth )
+		updateScrollBar();
+}
+
 Float UICodeEditor::getLineWidth( const Int64& lineIndex ) {
 	if ( mFont && !mFont->isMonospace() )
 		return getLineText( lineIndex ).getTextWidth() + getGlyphWidth();
@@ -1505,11 +1557,12 @@ void UICodeEditor::updateEditor() {
 	mDirtyScroll = false;
 }
 
-void UICodeEditor::onDocumentTextChanged( const DocumentContentChange& ) {
+void UICodeEditor::onDocumentTextChanged( const DocumentContentChange& change ) {
+	mHighlighter.onDocumentTextChanged( change );
 	invalidateDraw();
 	checkMatchingBrackets();
 	sendCommonEvent( Event::OnTextChanged );
-	invalidateLongestLineWidth();
+	updateLineWidthIndex( change );
 }
 
 void UICodeEditor::onDocumentCursorChange( const Doc::TextPosition& ) {
@@ -1532,6 +1585,7 @@ void UICodeEditor::onDocumentLineCountChange( const size_t&, const size_t& ) {
 
 void UICodeEditor::onDocumentLineChanged( const Int64& lineNumber ) {
 	mHighlighter.invalidate( lineNumber );
+	mLineRenderCache.erase( lineNumber );
 	if ( mFont && !mFont->isMonospace() )
 		updateLineCache( lineNumber );
 }
@@ -2134,6 +2188,15 @@ const SyntaxDefinition& UICodeEditor::getSyntaxDefinition() const {
 	return mDoc->getSyntaxDefinition();
 }
 
+void UICodeEditor::setSyntaxHighlighterThreadPool( std::shared_ptr<ThreadPool> pool ) {
+	mHighlighter.setThreadPool( pool );
+	invalidateDraw();
+}
+
+const std::shared_ptr<ThreadPool>& UICodeEditor::getSyntaxHighlighterThreadPool() const {
+	return mHighlighter.getThreadPool();
+}
+
 void UICodeEditor::checkMatchingBrackets() {
 	if ( mHighlightMatchingBracket ) {
 		const std::vector<String::StringBaseType> open{ '{', '(', '[' };
@@ -2488,6 +2551,10 @@ void UICodeEditor::setFindLongestLineWidthUpdateFrequency(
 	mFindLongestLineWidthUpdateFrequency = findLongestLineWidthUpdateFrequency;
 }
 
+const LineWidthIndex& UICodeEditor::getLineWidthIndex() const {
+	return mLineWidthIndex;
+}
+
 const bool& UICodeEditor::getHorizontalScrollBarEnabled() const {
 	return mHorizontalScrollBarEnabled;
 }
@@ -2495,6 +2562,8 @@ const bool& UICodeEditor::getHorizontalScrollBarEnabled() const {
 void UICodeEditor::setHorizontalScrollBarEnabled( const bool& horizontalScrollBarEnabled ) {
 	if ( horizontalScrollBarEnabled != mHorizontalScrollBarEnabled ) {
 		mHorizontalScrollBarEnabled = horizontalScrollBarEnabled;
+		if ( !mHorizontalScrollBarEnabled )
+			mLineWidthIndex.clear();
 		invalidateLongestLineWidth();
 		updateScrollBar();
 	}
@@ -2585,17 +2654,82 @@ void UICodeEditor::drawWordMatch( const String& text, const std::pair<int, int>&
 	primitives.setForceDraw( true );
 }
 
+static Uint64 tokensHash( const std::vector<SyntaxToken>& tokens ) {
+	Uint64 hash = 14695981039346656037ULL;
+	for ( const auto& token : tokens ) {
+		hash = ( hash ^ token.type ) * 1099511628211ULL;
+		hash = ( hash ^ ( (Uint64)token.pos << 32 | token.len ) ) * 1099511628211ULL;
+	}
+	return hash;
+}
+
 void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Float& fontSize,
 								 const Float& lineHeight ) {
-	Vector2f originalPosition( position );
 	auto& tokens = mHighlighter.getLine( line );
+	// The hovered link is drawn with its own style, that line is never cached.
+	bool hasLink = mHandShown && mLinkPosition.isValid() && mLinkPosition.inSameLine() &&
+				   mLinkPosition.start().line() == line;
+	LineRenderKey key{ mDoc->line( line ).getHash(),
+					   tokensHash( tokens ),
+					   fontSize,
+					   mAlpha,
+					   position.x - mScreenPos.x,
+					   mScroll.x,
+					   mSize.getWidth() };
+
+	if ( !hasLink ) {
+		auto it = mLineRenderCache.find( line );
+		if ( it != mLineRenderCache.end() && it->second.key == key ) {
+			drawLineRuns( it->second.runs, position, lineHeight );
+			return;
+		}
+	}
+
+	std::vector<LineRenderRun> runs;
+	buildLineRuns( line, tokens, position, fontSize, runs );
+
+	if ( hasLink ) {
+		mLineRenderCache.erase( line );
+		drawLineRuns( runs, position, lineHeight );
+	} else {
+		LineRender& render = mLineRenderCache[line];
+		render.key = key;
+		render.runs = std::move( runs );
+		drawLineRuns( render.runs, position, lineHeight );
+	}
+}
+
+void UICodeEditor::drawLineRuns( std::vector<LineRenderRun>& runs, const Vector2f& position,
+								 const Float& lineHeight ) {
 	Primitives primitives;
+	Float lineOffset = getLineOffset();
+	for ( auto& run : runs ) {
+		if ( run.background != Color::Transparent ) {
+			primitives.setColor( run.background );
+			primitives.drawRectangle(
+				Rectf( Vector2f( position.x + run.backgroundOffset, position.y ),
+					   Sizef( run.backgroundWidth, lineHeight ) ) );
+		}
+		// The geometry of the text is only built the first time the run is drawn.
+		run.text.draw( position.x + run.textOffset, position.y + lineOffset );
+	}
+}
+
+void UICodeEditor::buildLineRuns( const Int64& line, const std::vector<SyntaxToken>& tokens,
+								  Vector2f position, const Float& fontSize,
+								  std::vector<LineRenderRun>& runs ) {
+	Vector2f originalPosition( position );
+	const String& lineText = mDoc->line( line ).getText();
 	Int64 curChar = 0;
 	Int64 maxWidth = eeceil( mSize.getWidth() / getGlyphWidth() + 1 );
 	bool isMonospace = mFont->isMonospace();
-	Float lineOffset = getLineOffset();
+	auto addRun = [&]( const Text& txt, const Float& textX, const Color& background,
+					   const Float& backgroundX, const Float& backgroundWidth ) {
+		runs.push_back( { txt, textX - originalPosition.x, background,
+						  backgroundX - originalPosition.x, backgroundWidth } );
+	};
 	for ( auto& token : tokens ) {
-		String text( token.text );
+		String text( lineText.substr( token.pos, token.len ) );
 		Float textWidth = isMonospace ? getTextWidth( text ) : 0;
 		if ( !isMonospace || ( position.x + textWidth >= mScreenPos.x &&
 							   position.x <= mScreenPos.x + mSize.getWidth() ) ) {
@@ -2605,6 +2739,9 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 			Text txt( "", mFont, fontSize );
 			txt.setTabWidth( mTabWidth );
 			const SyntaxColorScheme::Style& style = mColorScheme.getSyntaxStyle( token.type );
+			Color background( style.background != Color::Transparent
+								  ? Color( style.background ).blendAlpha( mAlpha )
+								  : Color::Transparent );
 			txt.setStyleConfig( mFontStyleConfig );
 			if ( style.style )
 				txt.setStyle( style.style );
@@ -2627,14 +2764,8 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 
 						if ( !beforeString.empty() ) {
 							Float beforeWidth = getTextWidth( beforeString );
-							if ( style.background != Color::Transparent ) {
-								primitives.setColor(
-									Color( style.background ).blendAlpha( mAlpha ) );
-								primitives.drawRectangle(
-									Rectf( position, Sizef( beforeWidth, lineHeight ) ) );
-							}
 							txt.setString( beforeString );
-							txt.draw( position.x, position.y + lineOffset );
+							addRun( txt, position.x, background, position.x, beforeWidth );
 							offset += beforeWidth;
 						}
 
@@ -2652,30 +2783,21 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 						}
 
 						Float linkWidth = getTextWidth( mLink );
-						if ( linkStyle.background != Color::Transparent ) {
-							primitives.setColor(
-								Color( linkStyle.background ).blendAlpha( mAlpha ) );
-							primitives.drawRectangle(
-								Rectf( Vector2f( position.x + offset, position.y ),
-									   Sizef( linkWidth, lineHeight ) ) );
-						}
 						txt.setString( mLink );
-						txt.draw( position.x + offset, position.y + lineOffset );
+						addRun( txt, position.x + offset,
+								linkStyle.background != Color::Transparent
+									? Color( linkStyle.background ).blendAlpha( mAlpha )
+									: Color::Transparent,
+								position.x + offset, linkWidth );
 						offset += linkWidth;
 
 						if ( !afterString.empty() ) {
 							Float afterWidth = getTextWidth( afterString );
-							if ( style.background != Color::Transparent ) {
-								primitives.setColor(
-									Color( style.background ).blendAlpha( mAlpha ) );
-								primitives.drawRectangle(
-									Rectf( Vector2f( position.x + offset, position.y ),
-										   Sizef( afterWidth, lineHeight ) ) );
-							}
 							txt.setColor( Color( style.color ).blendAlpha( mAlpha ) );
 							txt.setStyle( lineStyle );
 							txt.setString( afterString );
-							txt.draw( position.x + offset, position.y + lineOffset );
+							addRun( txt, position.x + offset, background, position.x + offset,
+									afterWidth );
 							offset += afterWidth;
 						}
 
@@ -2689,11 +2811,6 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 				}
 			}
 
-			if ( style.background != Color::Transparent ) {
-				primitives.setColor( Color( style.background ).blendAlpha( mAlpha ) );
-				primitives.drawRectangle( Rectf( position, Sizef( textWidth, lineHeight ) ) );
-			}
-
 			if ( isMonospace && curPositionChar + curChar + curCharsWidth > curMaxPositionChar ) {
 				if ( curChar < curPositionChar ) {
 					Int64 charsToVisible = curPositionChar - curChar;
@@ -2703,21 +2820,24 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 					Int64 end = eemin( totalChars, minimumCharsToCoverScreen );
 					if ( curCharsWidth >= charsToVisible ) {
 						txt.setString( text.substr( start, end ) );
-						txt.draw( position.x + start * getGlyphWidth(), position.y + lineOffset );
+						addRun( txt, position.x + start * getGlyphWidth(), background, position.x,
+								textWidth );
 						if ( minimumCharsToCoverScreen == end )
 							break;
+					} else {
+						txt.setString( "" );
+						addRun( txt, position.x, background, position.x, textWidth );
 					}
 				} else {
 					txt.setString( text.substr( 0, eemin( curCharsWidth, maxWidth ) ) );
-					txt.draw( position.x, position.y + lineOffset );
+					addRun( txt, position.x, background, position.x, textWidth );
 				}
 			} else {
 				txt.setString( text );
-				txt.draw( position.x, position.y + lineOffset );
+				if ( !isMonospace )
+					textWidth = txt.getTextWidth();
+				addRun( txt, position.x, background, position.x, textWidth );
 			}
-
-			if ( !isMonospace )
-				textWidth = txt.getTextWidth();
 		} else if ( position.x > mScreenPos.x + mSize.getWidth() ) {
 			break;
 		}
@@ -3104,9 +3224,9 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 	Float batchWidth = 0;
 	Float batchStart = rect.Left;
 	Float minimapCutoffX = rect.Left + rect.getWidth();
-	std::string batchSyntaxType = "normal";
+	SyntaxStyleType batchSyntaxType = SyntaxStyleTypes::Normal;
 	Float widthScale = charSpacing / getGlyphWidth();
-	auto flushBatch = [&]( const std::string& type ) {
+	auto flushBatch = [&]( const SyntaxStyleType& type ) {
 		Color oldColor = color;
 		color = mColorScheme.getSyntaxStyle( batchSyntaxType ).color;
 		if ( mMinimapConfig.syntaxHighlight && color != Color::Transparent ) {
@@ -3211,7 +3331,7 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 
 	if ( mMinimapConfig.syntaxHighlight ) {
 		for ( int index = minimapStartLine; index <= endidx; index++ ) {
-			batchSyntaxType = "normal";
+			batchSyntaxType = SyntaxStyleTypes::Normal;
 			batchStart = rect.Left + gutterWidth;
 			batchWidth = 0;
 
@@ -3227,20 +3347,17 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 												   gutterWidth );
 
 			const auto& tokens = mHighlighter.getLine( index );
+			const String& lineText = mDoc->line( index ).getText();
 			for ( const auto& token : tokens ) {
 				if ( batchSyntaxType != token.type ) {
 					flushBatch( batchSyntaxType );
 					batchSyntaxType = token.type;
 				}
 
-				if ( token.text.empty() )
-					continue;
+				size_t end = eemin<size_t>( token.pos + token.len, lineText.size() );
 
-				char* str = (char*)token.text.c_str();
-				char* end = str + token.text.size();
-
-				do {
-					Uint32 ch = String::utf8Next( str );
+				for ( size_t pos = token.pos; pos < end; ++pos ) {
+					String::StringBaseType ch = lineText[pos];
 					if ( ch == ' ' || ch == '\n' ) {
 						flushBatch( token.type );
 						batchStart += charSpacing;
@@ -3253,9 +3370,9 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 					} else {
 						batchWidth += charSpacing;
 					}
-				} while ( str < end );
+				}
 			}
-			flushBatch( "normal" );
+			flushBatch( SyntaxStyleTypes::Normal );
 
 			for ( auto* plugin : mPlugins )
 				plugin->minimapDrawAfterLineText( this, index, { rect.Left, lineY },
@@ -3279,7 +3396,7 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 		}
 	} else {
 		for ( int index = minimapStartLine; index <= endidx; index++ ) {
-			batchSyntaxType = "normal";
+			batchSyntaxType = SyntaxStyleTypes::Normal;
 			batchStart = rect.Left + gutterWidth;
 			batchWidth = 0;
 
@@ -3292,19 +3409,19 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 			for ( size_t i = 0; i < text.size(); ++i ) {
 				String::StringBaseType ch = text[i];
 				if ( ch == ' ' || ch == '\n' ) {
-					flushBatch( "normal" );
+					flushBatch( SyntaxStyleTypes::Normal );
 					batchStart += charSpacing;
 				} else if ( ch == '\t' ) {
-					flushBatch( "normal" );
+					flushBatch( SyntaxStyleTypes::Normal );
 					batchStart += charSpacing * mMinimapConfig.tabWidth;
 				} else if ( batchStart + batchWidth > minimapCutoffX ) {
-					flushBatch( "normal" );
+					flushBatch( SyntaxStyleTypes::Normal );
 					break;
 				} else {
 					batchWidth += charSpacing;
 				}
 			}
-			flushBatch( "normal" );
+			flushBatch( SyntaxStyleTypes::Normal );
 			lineY = lineY + lineSpacing;
 		}
 	}
@@ -3433,6 +3550,7 @@ void UICodeEditor::updateLineCache( const Int64& lineIndex ) {
 }
 
 void UICodeEditor::invalidateLinesCache() {
+	mLineRenderCache.clear();
 	if ( mFont && !mFont->isMonospace() ) {
 		mTextCache.clear();
 		invalidateDraw();
@@ -339,7 +339,9 @@ void UIFileDialog::refreshFolder( bool resetScroll ) {
 			mModel->setRootPath( mCurPath );
 		}
 
-		mMultiView->setModel( SortingProxyModel::New( mModel ) );
+		auto sortingModel = SortingProxyModel::New( mModel );
+		sortingModel->setThreadPool( getUISceneNode()->getThreadPool() );
+		mMultiView->setModel( sortingModel );
 
 		mMultiView->getTableView()->setColumnsVisible(
 			{ FileSystemModel::Name, FileSystemModel::Size, FileSystemModel::ModificationTime } );
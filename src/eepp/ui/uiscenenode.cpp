@@ -383,21 +383,28 @@ CSS::StyleSheet& UISceneNode::getStyleSheet() {
 	return mStyleSheet;
 }
 
+CSS::StyleSheetAncestorFilter& UISceneNode::getStyleSheetAncestorFilter() {
+	return mStyleSheetAncestorFilter;
+}
+
 bool UISceneNode::hasStyleSheet() {
 	return !mStyleSheet.isEmpty();
 }
 
 void UISceneNode::reloadStyle( const bool& disableAnimations ) {
 	if ( NULL != mChild ) {
-		Node* child = mChild;
+		std::vector<UIWidget*> roots;
 
-		while ( NULL != child ) {
-			if ( child->isWidget() ) {
-				child->asType<UIWidget>()->reloadStyle( true, disableAnimations );
-			}
+		for ( Node* child = mChild; NULL != child; child = child->getNextNode() )
+			if ( child->isWidget() )
+				roots.push_back( child->asType<UIWidget>() );
 
-			child = child->getNextNode();
-		}
+		matchStyles( roots );
+
+		for ( UIWidget* widget : roots )
+			widget->reloadStyle( true, disableAnimations );
+
+		clearStyleMatches();
 	}
 }
 
@@ -592,6 +599,11 @@ void UISceneNode::onWidgetDelete( Node* node ) {
 		mDirtyStyle.erase( widget );
 
 		mDirtyStyleState.erase( widget );
+
+		// The match is dropped so its widget pointer never dangles.
+		if ( widget->mStyleMatchIndex < mStyleMatchWidgets.size() &&
+			 mStyleMatchWidgets[widget->mStyleMatchIndex] == widget )
+			mStyleMatchWidgets[widget->mStyleMatchIndex] = NULL;
 	}
 }
 
@@ -621,31 +633,11 @@ void UISceneNode::invalidateStyle( UIWidget* node ) {
 	if ( node->isClosing() )
 		return;
 
-	Node* itNode = NULL;
-
-	if ( mDirtyStyle.count( node ) > 0 )
-		return;
-
-	for ( auto& dirtyNode : mDirtyStyle ) {
-		if ( NULL != dirtyNode && dirtyNode->isParentOf( node ) ) {
-			return;
-		}
-	}
-
-	std::vector<std::unordered_set<UIWidget*>::iterator> itEraseList;
-
-	for ( auto it = mDirtyStyle.begin(); it != mDirtyStyle.end(); ++it ) {
-		itNode = *it;
-
-		if ( NULL == itNode || node->isParentOf( itNode ) ) {
-			itEraseList.push_back( it );
-		}
-	}
-
-	for ( auto ite = itEraseList.begin(); ite != itEraseList.end(); ++ite ) {
-		mDirtyStyle.erase( *ite );
-	}
+	// The styles matched in advance could depend on the invalidated widget.
+	clearStyleMatches();
 
+	// The widgets with a dirty ancestor are discarded when the styles are updated, checking it
+	// here is quadratic when many widgets are invalidated at once.
 	mDirtyStyle.insert( node );
 }
 
@@ -655,35 +647,8 @@ void UISceneNode::invalidateStyleState( UIWidget* node, bool disableCSSAnimation
 	if ( node->isClosing() )
 		return;
 
-	Node* itNode = NULL;
-
-	if ( mDirtyStyleState.count( node ) > 0 )
-		return;
-
-	for ( auto& dirtyNode : mDirtyStyleState ) {
-		if ( NULL != dirtyNode && dirtyNode->isParentOf( node ) ) {
-			return;
-		}
-	}
-
-	std::vector<std::unordered_set<UIWidget*>::iterator> itEraseList;
-
-	for ( auto it = mDirtyStyleState.begin(); it != mDirtyStyleState.end(); ++it ) {
-		itNode = *it;
-
-		if ( NULL != itNode && node->isParentOf( itNode ) ) {
-			itEraseList.push_back( it );
-		} else if ( NULL == itNode ) {
-			itEraseList.push_back( it );
-		}
-	}
-
-	for ( auto ite = itEraseList.begin(); ite != itEraseList.end(); ++ite ) {
-		mDirtyStyleState.erase( *ite );
-	}
-
-	mDirtyStyleState.insert( node );
-	mDirtyStyleStateCSSAnimations[node] = disableCSSAnimations;
+	if ( mDirtyStyleState.insert( node ).second )
+		mDirtyStyleStateCSSAnimations[node] = disableCSSAnimations;
 }
 
 void UISceneNode::invalidateLayout( UILayout* node ) {
@@ -742,13 +707,140 @@ void UISceneNode::updateDirtyLayouts() {
 	}
 }
 
+std::vector<UIWidget*>
+UISceneNode::getDirtyRoots( const std::unordered_set<UIWidget*>& dirty ) const {
+	std::vector<UIWidget*> roots;
+	roots.reserve( dirty.size() );
+
+	for ( UIWidget* node : dirty ) {
+		if ( NULL == node )
+			continue;
+
+		UIWidget* parent = node->getStyleSheetParentElement();
+
+		while ( NULL != parent && dirty.count( parent ) == 0 )
+			parent = parent->getStyleSheetParentElement();
+
+		if ( NULL == parent )
+			roots.push_back( node );
+	}
+
+	return roots;
+}
+
+static void matchStylesChunk( const CSS::StyleSheet& styleSheet,
+							  const std::vector<UIWidget*>& widgets,
+							  std::vector<CSS::StyleSheetStyleVector>& matches, size_t chunk ) {
+	// The widgets are in pre-order, so the ancestor filter is only rebuilt when a chunk starts or
+	// a new tree is found.
+	CSS::StyleSheetAncestorFilter ancestorFilter;
+	size_t end = std::min( ( chunk + 1 ) * UISceneNode::StyleMatchChunkSize, widgets.size() );
+	for ( size_t i = chunk * UISceneNode::StyleMatchChunkSize; i < end; i++ ) {
+		UIWidget* widget = widgets[i];
+		UIWidget* parent = widget->getStyleSheetParentElement();
+		while ( !ancestorFilter.isEmpty() && ancestorFilter.getTop() != parent )
+			ancestorFilter.popElement();
+		if ( ancestorFilter.isEmpty() )
+			ancestorFilter.pushAncestors( widget );
+		matches[i] = styleSheet.getElementStyleNodes( widget, false, &ancestorFilter );
+		ancestorFilter.pushElement( widget );
+	}
+}
+
+void UISceneNode::matchStyles( const std::vector<UIWidget*>& roots ) {
+	clearStyleMatches();
+
+	if ( !mThreadPool || mThreadPool->numThreads() == 0 || mStyleSheet.isEmpty() )
+		return;
+
+	// Same order than UIWidget::reloadStyle visits the widgets.
+	std::vector<UIWidget*> widgets;
+	std::vector<UIWidget*> stack( roots.rbegin(), roots.rend() );
+	while ( !stack.empty() ) {
+		UIWidget* widget = stack.back();
+		stack.pop_back();
+		widgets.push_back( widget );
+		size_t childsStart = stack.size();
+		for ( Node* child = widget->getFirstChild(); NULL != child; child = child->getNextNode() )
+			if ( child->isWidget() )
+				stack.push_back( child->asType<UIWidget>() );
+		std::reverse( stack.begin() + childsStart, stack.end() );
+	}
+
+	// Small trees are matched faster in the main thread.
+	if ( widgets.size() < StyleMatchChunkSize * 2 )
+		return;
+
+	std::vector<CSS::StyleSheetStyleVector> matches( widgets.size() );
+	size_t chunksCount = ( widgets.size() + StyleMatchChunkSize - 1 ) / StyleMatchChunkSize;
+	const CSS::StyleSheet& styleSheet = mStyleSheet;
+	mThreadPool->parallelFor( chunksCount, [&styleSheet, &widgets, &matches]( size_t chunk ) {
+		matchStylesChunk( styleSheet, widgets, matches, chunk );
+	} );
+
+	// The match of each widget is found through the index stored in the widget, and not through
+	// its address: a widget created during the pass (even at the address of a deleted one) has no
+	// index, so it can't get the match of another widget.
+	for ( size_t i = 0; i < widgets.size(); i++ )
+		widgets[i]->mStyleMatchIndex = static_cast<Uint32>( i );
+	mStyleMatchWidgets = std::move( widgets );
+	mStyleMatches = std::move( matches );
+}
+
+void UISceneNode::clearStyleMatches() {
+	if ( !mStyleMatches.empty() ) {
+		decltype( mStyleMatches )().swap( mStyleMatches );
+		decltype( mStyleMatchWidgets )().swap( mStyleMatchWidgets );
+	}
+}
+
+void UISceneNode::invalidateStyleMatch( UIWidget* widget ) {
+	if ( mStyleMatches.empty() )
+		return;
+
+	// The selectors of the descendants of the widget and of its next siblings (and their
+	// descendants) can depend on the id, classes and tag of the widget.
+	std::vector<Node*> stack;
+	for ( Node* node = widget; NULL != node; node = node->getNextNode() )
+		stack.push_back( node );
+
+	while ( !stack.empty() ) {
+		Node* node = stack.back();
+		stack.pop_back();
+		if ( node->isWidget() )
+			node->asType<UIWidget>()->mStyleMatchIndex = eeINDEX_NOT_FOUND;
+		for ( Node* child = node->getFirstChild(); NULL != child; child = child->getNextNode() )
+			stack.push_back( child );
+	}
+}
+
+const CSS::StyleSheetStyleVector* UISceneNode::getStyleMatch( UIWidget* widget ) const {
+	Uint32 index = widget->mStyleMatchIndex;
+	if ( index >= mStyleMatches.size() || mStyleMatchWidgets[index] != widget )
+		return nullptr;
+	return &mStyleMatches[index];
+}
+
+void UISceneNode::setThreadPool( std::shared_ptr<ThreadPool> pool ) {
+	mThreadPool = pool;
+}
+
+const std::shared_ptr<ThreadPool>& UISceneNode::getThreadPool() const {
+	return mThreadPool;
+}
+
 void UISceneNode::updateDirtyStyles() {
 	if ( !mDirtyStyle.empty() ) {
 		Clock clock;
-		for ( auto& node : mDirtyStyle ) {
-			node->reloadStyle( true, false, false );
+		std::vector<UIWidget*> roots( getDirtyRoots( mDirtyStyle ) );
+		matchStyles( roots );
+		for ( UIWidget* node : roots ) {
+			// Styling a widget can delete the following ones.
+			if ( mDirtyStyle.count( node ) > 0 )
+				node->reloadStyle( true, false, false );
 		}
 		mDirtyStyle.clear();
+		clearStyleMatches();
 
 		if ( mVerbose )
 			Log::info( "CSS Styles Reloaded in %.2f ms", clock.getElapsedTime().asMilliseconds() );
@@ -758,8 +850,10 @@ void UISceneNode::updateDirtyStyles() {
 void UISceneNode::updateDirtyStyleStates() {
 	if ( !mDirtyStyleState.empty() ) {
 		Clock clock;
-		for ( auto& node : mDirtyStyleState ) {
-			node->reportStyleStateChangeRecursive( mDirtyStyleStateCSSAnimations[node] );
+		std::vector<UIWidget*> roots( getDirtyRoots( mDirtyStyleState ) );
+		for ( UIWidget* node : roots ) {
+			if ( mDirtyStyleState.count( node ) > 0 )
+				node->reportStyleStateChangeRecursive( mDirtyStyleStateCSSAnimations[node] );
 		}
 		mDirtyStyleState.clear();
 		mDirtyStyleStateCSSAnimations.clear();
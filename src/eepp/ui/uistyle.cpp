@@ -55,8 +55,12 @@ void UIStyle::setStyleSheetProperty( const StyleSheetProperty& property ) {
 }
 
 void UIStyle::resetGlobalDefinition() {
-	mGlobalDefinition =
-		mWidget->getUISceneNode()->getStyleSheet().getElementStyles( mWidget, false );
+	UISceneNode* sceneNode = mWidget->getUISceneNode();
+	const StyleSheetStyleVector* styleMatch = sceneNode->getStyleMatch( mWidget );
+	mGlobalDefinition = NULL != styleMatch
+							? sceneNode->getStyleSheet().getElementDefinition( *styleMatch )
+							: sceneNode->getStyleSheet().getElementStyles(
+								  mWidget, false, &sceneNode->getStyleSheetAncestorFilter() );
 }
 
 void UIStyle::load() {
@@ -231,8 +235,10 @@ void UIStyle::onStateChange() {
 		mChangingState = true;
 
 		std::shared_ptr<ElementDefinition> prevDefinition = mDefinition;
+		UISceneNode* sceneNode = mWidget->getUISceneNode();
 		std::shared_ptr<ElementDefinition> newDefinition =
-			mWidget->getUISceneNode()->getStyleSheet().getElementStyles( mWidget, true );
+			sceneNode->getStyleSheet().getElementStyles(
+				mWidget, true, &sceneNode->getStyleSheetAncestorFilter() );
 
 		if ( newDefinition != mDefinition || mForceReapplyProperties ) {
 			PropertyIdSet changedProperties;
@@ -1,4 +1,4 @@
-#include <deque>
+#include <algorithm>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/system/lock.hpp>
 #include <eepp/ui/uilinearlayout.hpp>
@@ -44,46 +44,108 @@ UITreeView::MetadataForIndex& UITreeView::getIndexMetadata( const ModelIndex& in
 void UITreeView::traverseTree( TreeViewCallback callback ) const {
 	if ( !getModel() )
 		return;
-	auto& model = *getModel();
 	Lock l( const_cast<Model*>( getModel() )->resourceMutex() );
-	int indentLevel = 0;
-	Float yOffset = getHeaderHeight();
-	int rowIndex = -1;
-	std::function<IterationDecision( const ModelIndex& )> traverseIndex =
-		[&]( const ModelIndex& index ) {
-			if ( index.isValid() ) {
-				auto& metadata = getIndexMetadata( index );
-				rowIndex++;
-				IterationDecision decision = callback( rowIndex, index, indentLevel, yOffset );
-				if ( decision == IterationDecision::Break || decision == IterationDecision::Stop )
-					return decision;
-				yOffset += getRowHeight();
-				if ( !metadata.open ) {
-					return IterationDecision::Continue;
-				}
-			}
-			if ( indentLevel >= 0 && !index.isValid() )
-				return IterationDecision::Continue;
-			++indentLevel;
-			int rowCount = model.rowCount( index );
-			for ( int i = 0; i < rowCount; ++i ) {
-				IterationDecision decision =
-					traverseIndex( model.index( i, model.treeColumn(), index ) );
-				if ( decision == IterationDecision::Break || decision == IterationDecision::Stop )
-					return decision;
-			}
-			--indentLevel;
-			return IterationDecision::Continue;
-		};
-	int rootCount = model.rowCount();
-	for ( int rootIndex = 0; rootIndex < rootCount; ++rootIndex ) {
+	getVisibleRows();
+	/* The row is copied, the callback could rebuild the rows */
+	for ( size_t rowIndex = 0; rowIndex < mVisibleRows.size(); ++rowIndex ) {
+		VisibleRow row = mVisibleRows[rowIndex];
 		IterationDecision decision =
-			traverseIndex( model.index( rootIndex, model.treeColumn(), ModelIndex() ) );
+			callback( rowIndex, row.index, row.indentLevel, getRowOffset( rowIndex ) );
 		if ( decision == IterationDecision::Break || decision == IterationDecision::Stop )
 			break;
 	}
 }
 
+void UITreeView::appendVisibleRows( std::vector<VisibleRow>& rows, const ModelIndex& parent,
+									const size_t& indentLevel ) const {
+	auto& model = *getModel();
+	size_t rowCount = model.rowCount( parent );
+	for ( size_t i = 0; i < rowCount; ++i ) {
+		ModelIndex index( model.index( i, model.treeColumn(), parent ) );
+		if ( !index.isValid() )
+			continue;
+		rows.push_back( { index, indentLevel } );
+		if ( getIndexMetadata( index ).open )
+			appendVisibleRows( rows, index, indentLevel + 1 );
+	}
+}
+
+const std::vector<UITreeView::VisibleRow>& UITreeView::getVisibleRows() const {
+	if ( !getModel() ) {
+		mVisibleRows.clear();
+		return mVisibleRows;
+	}
+
+	/* The model can be modified from other threads (the file system watcher) under its lock before
+	 * notifying the update, so the generation is checked with the lock held */
+	Lock l( const_cast<Model*>( getModel() )->resourceMutex() );
+	Uint64 generation = getModel()->getGeneration();
+	if ( mVisibleRowsDirty || mVisibleRowsGeneration != generation ) {
+		mVisibleRowsDirty = false;
+		mVisibleRowsGeneration = generation;
+		mVisibleRows.clear();
+		appendVisibleRows( mVisibleRows, {}, 0 );
+	}
+	return mVisibleRows;
+}
+
+void UITreeView::invalidateVisibleRows() {
+	mVisibleRowsDirty = true;
+}
+
+void UITreeView::updateVisibleRows( const ModelIndex& index ) {
+	if ( !getModel() )
+		return;
+
+	Lock l( getModel()->resourceMutex() );
+	if ( mVisibleRowsDirty || mVisibleRowsGeneration != getModel()->getGeneration() )
+		return;
+
+	Int64 pos = getVisibleRowIndex( index );
+	if ( pos == -1 )
+		return;
+
+	size_t indentLevel = mVisibleRows[pos].indentLevel;
+	auto first = mVisibleRows.begin() + pos + 1;
+
+	if ( getIndexMetadata( index ).open ) {
+		std::vector<VisibleRow> rows;
+		appendVisibleRows( rows, index, indentLevel + 1 );
+		mVisibleRows.insert( first, rows.begin(), rows.end() );
+	} else {
+		auto last = std::find_if( first, mVisibleRows.end(), [indentLevel]( const VisibleRow& row ) {
+			return row.indentLevel <= indentLevel;
+		} );
+		mVisibleRows.erase( first, last );
+	}
+}
+
+Int64 UITreeView::getVisibleRowIndex( const ModelIndex& index ) const {
+	const auto& rows = getVisibleRows();
+	for ( size_t i = 0; i < rows.size(); ++i )
+		if ( rows[i].index == index )
+			return i;
+	return -1;
+}
+
+size_t UITreeView::getFirstVisibleRow() const {
+	Float rowHeight = getRowHeight();
+	Float hidden = mScrollOffset.y - getHeaderHeight() - rowHeight;
+	if ( rowHeight <= 0 || hidden <= 0 )
+		return 0;
+	return eemin( getVisibleRows().size(), (size_t)eeceil( hidden / rowHeight ) );
+}
+
+Float UITreeView::getRowOffset( const size_t& rowIndex ) const {
+	return getHeaderHeight() + rowIndex * getRowHeight();
+}
+
+void UITreeView::onModelUpdate( unsigned flags ) {
+	/* The rows can't be used anymore, even if the update is processed later in the main thread */
+	invalidateVisibleRows();
+	UIAbstractTableView::onModelUpdate( flags );
+}
+
 void UITreeView::createOrUpdateColumns( bool resetColumnData ) {
 	updateContentSize();
 	if ( !getModel() )
@@ -92,12 +154,7 @@ void UITreeView::createOrUpdateColumns( bool resetColumnData ) {
 }
 
 size_t UITreeView::getItemCount() const {
-	size_t count = 0;
-	traverseTree( [&]( const int&, const ModelIndex&, const size_t&, const Float& ) {
-		count++;
-		return IterationDecision::Continue;
-	} );
-	return count;
+	return getVisibleRows().size();
 }
 
 void UITreeView::onColumnSizeChange( const size_t& colIndex, bool fromUserInteraction ) {
@@ -124,6 +181,7 @@ void UITreeView::bindNavigationClick( UIWidget* widget ) {
 				if ( getModel()->rowCount( idx ) ) {
 					auto& data = getIndexMetadata( idx );
 					data.open = !data.open;
+					updateVisibleRows( idx );
 					createOrUpdateColumns( false );
 					onOpenTreeModelIndex( idx, data.open );
 				} else {
@@ -152,6 +210,7 @@ bool UITreeView::tryOpenModelIndex( const ModelIndex& index, bool forceUpdate )
 		auto& data = getIndexMetadata( index );
 		if ( !data.open ) {
 			data.open = true;
+			updateVisibleRows( index );
 			if ( forceUpdate )
 				createOrUpdateColumns( false );
 			onOpenTreeModelIndex( index, data.open );
@@ -186,6 +245,7 @@ UIWidget* UITreeView::setupCell( UITableCell* widget, UIWidget* rowWidget,
 					if ( getModel()->rowCount( idx ) ) {
 						auto& data = getIndexMetadata( idx );
 						data.open = !data.open;
+						updateVisibleRows( idx );
 						createOrUpdateColumns( false );
 						onOpenTreeModelIndex( idx, data.open );
 					}
@@ -311,12 +371,8 @@ Sizef UITreeView::getContentSize() const {
 void UITreeView::drawChilds() {
 	int realIndex = 0;
 
-	traverseTree( [&]( const int&, const ModelIndex& index, const size_t& indentLevel,
-					   const Float& yOffset ) {
-		if ( yOffset - mScrollOffset.y > mSize.getHeight() )
-			return IterationDecision::Stop;
-		if ( yOffset - mScrollOffset.y + getRowHeight() < 0 )
-			return IterationDecision::Continue;
+	traverseVisibleArea( [&]( const ModelIndex& index, const size_t& indentLevel,
+							  const Float& yOffset ) {
 		for ( size_t colIndex = 0; colIndex < getModel()->columnCount(); colIndex++ ) {
 			if ( columnData( colIndex ).visible ) {
 				if ( (Int64)colIndex != index.column() ) {
@@ -346,6 +402,22 @@ void UITreeView::drawChilds() {
 		mVScroll->nodeDraw();
 }
 
+void UITreeView::traverseVisibleArea( VisibleRowCallback callback ) const {
+	if ( !getModel() )
+		return;
+	Lock l( const_cast<Model*>( getModel() )->resourceMutex() );
+	/* The rows above the visible area are skipped without visiting them */
+	for ( size_t rowIndex = getFirstVisibleRow(); rowIndex < getVisibleRows().size();
+		  ++rowIndex ) {
+		Float yOffset = getRowOffset( rowIndex );
+		if ( yOffset - mScrollOffset.y > mSize.getHeight() )
+			break;
+		VisibleRow row = mVisibleRows[rowIndex];
+		if ( callback( row.index, row.indentLevel, yOffset ) == IterationDecision::Stop )
+			break;
+	}
+}
+
 Node* UITreeView::overFind( const Vector2f& point ) {
 	mUISceneNode->setIsLoading( true );
 
@@ -362,12 +434,8 @@ Node* UITreeView::overFind( const Vector2f& point ) {
 			if ( mHeader && ( pOver = mHeader->overFind( point ) ) )
 				return pOver;
 			int realIndex = 0;
-			traverseTree(
-				[&, point]( int, const ModelIndex& index, const size_t&, const Float& yOffset ) {
-					if ( yOffset - mScrollOffset.y > mSize.getHeight() )
-						return IterationDecision::Stop;
-					if ( yOffset - mScrollOffset.y + getRowHeight() < 0 )
-						return IterationDecision::Continue;
+			traverseVisibleArea(
+				[&, point]( const ModelIndex& index, const size_t&, const Float& yOffset ) {
 					pOver = updateRow( realIndex, index, yOffset )->overFind( point );
 					realIndex++;
 					if ( pOver )
@@ -390,6 +458,7 @@ bool UITreeView::isExpanded( const ModelIndex& index ) const {
 
 void UITreeView::setAllExpanded( const ModelIndex& index, bool expanded ) {
 	Model& model = *getModel();
+	invalidateVisibleRows();
 	size_t count = model.rowCount( index );
 	for ( size_t i = 0; i < count; i++ ) {
 		auto curIndex = model.index( i, model.treeColumn(), index );
@@ -481,79 +550,47 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 	if ( event.getMod() & KEYMOD_CTRL_SHIFT_ALT_META )
 		return UIAbstractTableView::onKeyDown( event );
 	auto curIndex = getSelection().first();
+	/* The visible rows are referenced while navigating */
+	ConditionalLock l( getModel() != nullptr, getModel() ? &getModel()->resourceMutex() : nullptr );
 
 	switch ( event.getKeyCode() ) {
 		case KEY_PAGEUP: {
-			int pageSize = eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1;
-			std::deque<std::pair<ModelIndex, Float>> deque;
-			Float curY;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					deque.push_back( { index, offsetY } );
-					if ( (int)deque.size() > pageSize )
-						deque.pop_front();
-					if ( index == curIndex )
-						return IterationDecision::Break;
-					return IterationDecision::Continue;
-				} );
-			curY = deque.front().second - getHeaderHeight();
-			getSelection().set( deque.front().first );
-			scrollToPosition(
-				{ { mScrollOffset.x, curY },
-				  { columnData( deque.front().first.column() ).width, getRowHeight() } } );
+			const auto& rows = getVisibleRows();
+			if ( rows.empty() )
+				return 1;
+			int pageSize = eemax<int>(
+				1, eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1 );
+			Int64 pos = getVisibleRowIndex( curIndex );
+			if ( pos == -1 )
+				pos = rows.size() - 1;
+			size_t foundPos = eemax<Int64>( 0, pos - pageSize + 1 );
+			ModelIndex foundIndex = rows[foundPos].index;
+			Float curY = getRowOffset( foundPos ) - getHeaderHeight();
+			getSelection().set( foundIndex );
+			scrollToPosition( { { mScrollOffset.x, curY },
+								{ columnData( foundIndex.column() ).width, getRowHeight() } } );
 			return 1;
 		}
 		case KEY_PAGEDOWN: {
+			const auto& rows = getVisibleRows();
+			if ( rows.empty() )
+				return 1;
 			int pageSize = eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1;
-			int counted = 0;
-			bool foundStart = false;
-			bool resultFound = false;
-			ModelIndex foundIndex;
-			Float curY = 0;
-			Float lastOffsetY = 0;
-			ModelIndex lastIndex;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					if ( index == curIndex ) {
-						foundStart = true;
-					} else if ( foundStart ) {
-						counted++;
-						if ( counted == pageSize ) {
-							foundIndex = index;
-							curY = offsetY;
-							resultFound = true;
-							return IterationDecision::Break;
-						}
-					}
-					lastOffsetY = offsetY;
-					lastIndex = index;
-					return IterationDecision::Continue;
-				} );
-			if ( !resultFound ) {
-				foundIndex = lastIndex;
-				curY = lastOffsetY;
-			}
-			curY += getRowHeight();
+			Int64 pos = getVisibleRowIndex( curIndex );
+			size_t foundPos = pos == -1 ? rows.size() - 1
+										: eemin<size_t>( pos + eemax( 1, pageSize ), rows.size() - 1 );
+			ModelIndex foundIndex = rows[foundPos].index;
+			Float curY = getRowOffset( foundPos ) + getRowHeight();
 			getSelection().set( foundIndex );
 			scrollToPosition( { { mScrollOffset.x, curY },
 								{ columnData( foundIndex.column() ).width, getRowHeight() } } );
 			return 1;
 		}
 		case KEY_UP: {
-			ModelIndex prevIndex;
-			ModelIndex foundIndex;
-			Float curY = 0;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					if ( index == curIndex ) {
-						foundIndex = prevIndex;
-						curY = offsetY;
-						return IterationDecision::Break;
-					}
-					prevIndex = index;
-					return IterationDecision::Continue;
-				} );
-			if ( foundIndex.isValid() ) {
+			Int64 pos = getVisibleRowIndex( curIndex );
+			if ( pos > 0 ) {
+				ModelIndex foundIndex = getVisibleRows()[pos - 1].index;
+				Float curY = getRowOffset( pos );
 				getSelection().set( foundIndex );
 				if ( curY < mScrollOffset.y + getHeaderHeight() + getRowHeight() ||
 					 curY > mScrollOffset.y + getPixelsSize().getHeight() - mPaddingPx.Top -
@@ -566,21 +603,12 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 			return 1;
 		}
 		case KEY_DOWN: {
-			ModelIndex prevIndex;
-			ModelIndex foundIndex;
-			Float curY = 0;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					if ( prevIndex == curIndex ) {
-						foundIndex = index;
-						curY = offsetY;
-						return IterationDecision::Break;
-					}
-					prevIndex = index;
-					return IterationDecision::Continue;
-				} );
-			if ( foundIndex.isValid() ) {
-				getSelection().set( foundIndex );
+			const auto& rows = getVisibleRows();
+			Int64 pos = curIndex.isValid() ? getVisibleRowIndex( curIndex ) : -1;
+			size_t foundPos = pos + 1;
+			if ( ( pos != -1 || !curIndex.isValid() ) && foundPos < rows.size() ) {
+				Float curY = getRowOffset( foundPos );
+				getSelection().set( rows[foundPos].index );
 				if ( curY < mScrollOffset.y ||
 					 curY > mScrollOffset.y + getPixelsSize().getHeight() - mPaddingPx.Top -
 								mPaddingPx.Bottom - getRowHeight() ) {
@@ -595,12 +623,8 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 		}
 		case KEY_END: {
 			scrollToBottom();
-			ModelIndex lastIndex;
-			traverseTree( [&]( const int&, const ModelIndex& index, const size_t&, const Float& ) {
-				lastIndex = index;
-				return IterationDecision::Continue;
-			} );
-			getSelection().set( lastIndex );
+			const auto& rows = getVisibleRows();
+			getSelection().set( rows.empty() ? ModelIndex() : rows.back().index );
 			return 1;
 		}
 		case KEY_HOME: {
@@ -613,6 +637,7 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 				auto& metadata = getIndexMetadata( curIndex );
 				if ( !metadata.open ) {
 					metadata.open = true;
+					updateVisibleRows( curIndex );
 					createOrUpdateColumns( false );
 					return 0;
 				}
@@ -625,6 +650,7 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 				auto& metadata = getIndexMetadata( curIndex );
 				if ( metadata.open ) {
 					metadata.open = false;
+					updateVisibleRows( curIndex );
 					createOrUpdateColumns( false );
 					return 0;
 				}
@@ -641,6 +667,7 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 				if ( getModel()->rowCount( curIndex ) ) {
 					auto& metadata = getIndexMetadata( curIndex );
 					metadata.open = !metadata.open;
+					updateVisibleRows( curIndex );
 					createOrUpdateColumns( false );
 				} else {
 					onOpenModelIndex( curIndex, &event );
@@ -748,21 +775,10 @@ void UITreeView::setSelection( const ModelIndex& index, bool scrollToSelection,
 		if ( !scrollToSelection )
 			return;
 
-		ModelIndex prevIndex;
-		ModelIndex foundIndex;
-		Float curY = 0;
-		traverseTree(
-			[&]( const int&, const ModelIndex& _index, const size_t&, const Float& offsetY ) {
-				if ( index == _index ) {
-					foundIndex = prevIndex;
-					curY = offsetY;
-					return IterationDecision::Break;
-				}
-				prevIndex = index;
-				return IterationDecision::Continue;
-			} );
+		Int64 pos = getVisibleRowIndex( index );
 
-		if ( foundIndex.isValid() ) {
+		if ( pos > 0 ) {
+			Float curY = getRowOffset( pos );
 			if ( curY < mScrollOffset.y + getHeaderHeight() + getRowHeight() ||
 				 curY > mScrollOffset.y + getPixelsSize().getHeight() - mPaddingPx.Top -
 							mPaddingPx.Bottom - getRowHeight() ) {
@@ -42,7 +42,8 @@ UIWidget::UIWidget( const std::string& tag ) :
 	mHeightPolicy( SizePolicy::WrapContent ),
 	mLayoutPositionPolicy( PositionPolicy::None ),
 	mLayoutPositionPolicyWidget( NULL ),
-	mAttributesTransactionCount( 0 ) {
+	mAttributesTransactionCount( 0 ),
+	mStyleMatchIndex( eeINDEX_NOT_FOUND ) {
 	mNodeFlags |= NODE_FLAG_WIDGET;
 	mFlags |= UI_TAB_FOCUSABLE | UI_TOOLTIP_ENABLED;
 
@@ -256,6 +257,10 @@ void UIWidget::onChildCountChange( Node* child, const bool& removed ) {
 		}
 	}
 
+	// The styles matched in advance could depend on the siblings of the child.
+	if ( mUISceneNode != NULL )
+		mUISceneNode->clearStyleMatches();
+
 	if ( !isSceneNodeLoading() && mUISceneNode != NULL && mStyle != NULL ) {
 		// Childs that are structurally volatile can change states when a new
 		// element is added to the parent. We pre-store them and invalidate its
@@ -428,6 +433,9 @@ UINode* UIWidget::setThemeSkin( UITheme* Theme, const std::string& skinName ) {
 Node* UIWidget::setId( const std::string& id ) {
 	Node::setId( id );
 
+	if ( NULL != mUISceneNode )
+		mUISceneNode->invalidateStyleMatch( this );
+
 	if ( !isSceneNodeLoading() && !isLoadingState() ) {
 		getUISceneNode()->invalidateStyle( this );
 		getUISceneNode()->invalidateStyleState( this );
@@ -722,6 +730,9 @@ void UIWidget::addClass( const std::string& cls ) {
 	if ( !cls.empty() && !hasClass( cls ) ) {
 		mClasses.push_back( cls );
 
+		if ( NULL != mUISceneNode )
+			mUISceneNode->invalidateStyleMatch( this );
+
 		if ( !isSceneNodeLoading() && !isLoadingState() ) {
 			getUISceneNode()->invalidateStyle( this );
 			getUISceneNode()->invalidateStyleState( this );
@@ -741,6 +752,9 @@ void UIWidget::addClasses( const std::vector<std::string>& classes ) {
 			}
 		}
 
+		if ( NULL != mUISceneNode )
+			mUISceneNode->invalidateStyleMatch( this );
+
 		if ( !isSceneNodeLoading() && !isLoadingState() ) {
 			getUISceneNode()->invalidateStyle( this );
 			getUISceneNode()->invalidateStyleState( this );
@@ -754,6 +768,9 @@ void UIWidget::removeClass( const std::string& cls ) {
 	if ( hasClass( cls ) ) {
 		mClasses.erase( std::find( mClasses.begin(), mClasses.end(), cls ) );
 
+		if ( NULL != mUISceneNode )
+			mUISceneNode->invalidateStyleMatch( this );
+
 		if ( !isSceneNodeLoading() && !isLoadingState() ) {
 			getUISceneNode()->invalidateStyle( this );
 			getUISceneNode()->invalidateStyleState( this );
@@ -777,6 +794,9 @@ void UIWidget::removeClasses( const std::vector<std::string>& classes ) {
 			}
 		}
 
+		if ( NULL != mUISceneNode )
+			mUISceneNode->invalidateStyleMatch( this );
+
 		if ( !isSceneNodeLoading() && !isLoadingState() ) {
 			getUISceneNode()->invalidateStyle( this );
 			getUISceneNode()->invalidateStyleState( this );
@@ -813,6 +833,9 @@ void UIWidget::setElementTag( const std::string& tag ) {
 		mMinHeightEq = "";
 		mMinSize = Sizef::Zero;
 
+		if ( NULL != mUISceneNode )
+			mUISceneNode->invalidateStyleMatch( this );
+
 		if ( !isSceneNodeLoading() && !isLoadingState() ) {
 			getUISceneNode()->invalidateStyle( this );
 			getUISceneNode()->invalidateStyleState( this );
@@ -905,11 +928,24 @@ void UIWidget::reloadStyle( const bool& reloadChilds, const bool& disableAnimati
 	createStyle();
 
 	if ( NULL != mStyle ) {
+		// The ancestors of the styled widgets are tracked while the tree is reloaded, so the
+		// descendant selectors that can't match are rejected early.
+		CSS::StyleSheetAncestorFilter& ancestorFilter =
+			getUISceneNode()->getStyleSheetAncestorFilter();
+		bool isFilterRoot = reloadChilds && ancestorFilter.isEmpty();
+
+		if ( isFilterRoot )
+			ancestorFilter.pushAncestors( this );
+
 		mStyle->load();
 
 		if ( NULL != getFirstChild() && reloadChilds ) {
+			bool useFilter = isFilterRoot || ancestorFilter.isValidFor( this );
 			Node* child = getFirstChild();
 
+			if ( useFilter )
+				ancestorFilter.pushElement( this );
+
 			while ( NULL != child ) {
 				if ( child->isWidget() )
 					child->asType<UIWidget>()->reloadStyle( reloadChilds, disableAnimations,
@@ -918,8 +954,14 @@ void UIWidget::reloadStyle( const bool& reloadChilds, const bool& disableAnimati
 
 				child = child->getNextNode();
 			}
+
+			if ( useFilter )
+				ancestorFilter.popElement();
 		}
 
+		if ( isFilterRoot )
+			ancestorFilter.clear();
+
 		if ( reportStateChange )
 			reportStyleStateChange( disableAnimations, forceReApplyProperties );
 	}
@@ -390,6 +390,10 @@ void Window::clear() {
 void Window::display( bool clear ) {
 	GlobalBatchRenderer::instance()->draw();
 
+	BatchRenderer::endFrameStats();
+
+	TextureFactory::instance()->processAsyncUploads();
+
 	swapBuffers();
 
 	if ( mCurrentView->isDirty() )
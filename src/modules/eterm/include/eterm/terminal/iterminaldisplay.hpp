@@ -79,6 +79,11 @@ class ITerminalDisplay {
 
 	virtual void drawEnd() = 0;
 
+	/** Moves the lines already drawn n rows up (down if negative). The terminal only draws again
+	 * the rows that enter the screen.
+	 * @return False if the display can't move its lines, the terminal draws all of them again. */
+	virtual bool moveLines( int lines );
+
   protected:
 	friend class TerminalEmulator;
 
@@ -172,6 +172,7 @@ class TerminalDisplay : public ITerminalDisplay {
 	virtual void drawLine( Line line, int x1, int y, int x2 );
 	virtual void drawCursor( int cx, int cy, TerminalGlyph g, int ox, int oy, TerminalGlyph og );
 	virtual void drawEnd();
+	virtual bool moveLines( int lines );
 
 	virtual bool update();
 
@@ -297,6 +298,9 @@ class TerminalDisplay : public ITerminalDisplay {
 	VertexBuffer* mVBBackground{ nullptr };
 	VertexBuffer* mVBForeground{ nullptr };
 	std::vector<VertexBuffer*> mVBStyles;
+	/** The buffers are a ring of row slices: the screen row y is stored in the slice
+	 * ( y + mRowOffset ) % mRows, so scrolling the whole screen only rotates the offset. */
+	Uint32 mRowOffset{ 0 };
 	TerminalColorScheme mColorScheme;
 	Uint32 mQuadVertexs{ 6 };
 	Primitives mPrimitives;
@@ -333,6 +337,10 @@ class TerminalDisplay : public ITerminalDisplay {
 
 	void initVBOs();
 
+	inline Uint32 getRowSlice( Uint32 row ) const { return ( row + mRowOffset ) % mRows; }
+
+	void drawRowSlices( VertexBuffer* vbo, const Vector2f& pos, Uint32 visibleRows );
+
 	void drawbox( float x, float y, float w, float h, Color fg, Color bg, ushort bd );
 
 	void drawrect( const Color& col, const float& x, const float& y, const float& w,
@@ -40,6 +40,7 @@
 #include <eterm/system/iprocess.hpp>
 #include <eterm/terminal/ipseudoterminal.hpp>
 #include <eterm/terminal/iterminaldisplay.hpp>
+#include <eterm/terminal/terminalhistory.hpp>
 #include <eterm/terminal/terminaltypes.hpp>
 #include <memory>
 #include <stdint.h>
@@ -63,10 +64,7 @@ struct Term {
 	int col{ 0 };				   /* nb col */
 	Line* line{ nullptr };		   /* screen */
 	Line* alt{ nullptr };		   /* alternate screen */
-	Line* hist{ nullptr };		   /* history buffer */
-	int histcursize{ 0 };		   /* history current size */
-	int histsize{ 0 };			   /* history max size */
-	int histi{ 0 };				   /* history index */
+	TerminalHistory hist;		   /* history buffer */
 	int scr{ 0 };				   /* scroll back */
 	int* dirty{ nullptr };		   /* dirtyness of lines */
 	TerminalCursor c{};			   /* cursor */
@@ -162,6 +160,12 @@ class TerminalEmulator final {
 
 	int getHistorySize() const;
 
+	/** @return The scrollback lines (line 0 is the oldest one), it can be searched. */
+	const TerminalHistory& getHistory() const;
+
+	/** Enables the compression of the old scrollback pages. */
+	void setHistoryCompression( bool compression );
+
 	int write( const char* buf, size_t buflen );
 
 	void printscreen( const TerminalArg* );
@@ -249,7 +253,6 @@ class TerminalEmulator final {
 	int mAllowAltScreen;
 	int mAllowWindowOps;
 
-	void resizeHistory();
 	void setClipboard( const char* str );
 
 	void loadColors();
@@ -285,6 +288,8 @@ class TerminalEmulator final {
 	void tnewline( int );
 	void tputtab( int );
 	void tputc( Rune );
+	bool tcanputascii() const;
+	void tputascii( const char*, int );
 	void treset();
 	void tscrollup( int, int, int );
 	void tscrolldown( int, int, int );
@@ -296,6 +301,7 @@ class TerminalEmulator final {
 	void tsetmode( int, int, int*, int );
 	int twrite( const char*, int, int );
 	void tfulldirt();
+	bool tmovedisplay( int );
 	void tcontrolcode( uchar );
 	void tdectest( char );
 	void tdefutf8( char );
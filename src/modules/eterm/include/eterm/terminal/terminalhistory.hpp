@@ -0,0 +1,125 @@
+#ifndef ETERM_TERMINALHISTORY_HPP
+#define ETERM_TERMINALHISTORY_HPP
+
+#include <deque>
+#include <eepp/config.hpp>
+#include <eterm/terminal/terminaltypes.hpp>
+#include <string>
+#include <vector>
+
+using namespace EE;
+
+namespace eterm { namespace Terminal {
+
+/** The scrollback of the terminal.
+ * The lines are stored encoded in pages: the text as UTF-8 and the attributes as runs of glyphs
+ * with the same mode and colors, without the trailing blanks. The pages are used as a ring, the
+ * oldest lines are dropped when the history is full. The lines are decoded on demand with the
+ * current number of columns, so resizing the terminal doesn't touch the history. The full pages
+ * can optionally be compressed. */
+class TerminalHistory {
+  public:
+	struct SearchResult {
+		/** Line index, -1 if not found. */
+		int line{ -1 };
+		/** Cell where the match starts (a wide glyph takes two cells). */
+		int column{ 0 };
+	};
+
+	TerminalHistory();
+
+	explicit TerminalHistory( size_t maxLines );
+
+	/** Sets the maximum number of lines, the oldest lines are dropped if needed. */
+	void setMaxLines( size_t maxLines );
+
+	size_t getMaxLines() const;
+
+	/** @return The number of lines in the history. */
+	size_t size() const;
+
+	bool empty() const;
+
+	/** Adds a line as the newest line of the history. */
+	void push( const TerminalGlyph* line, int columns );
+
+	/** Removes the newest line. */
+	void pop();
+
+	void clear();
+
+	/** @return The line at the index (0 is the oldest line) with the number of columns requested.
+	 * The line is decoded in a small cache: the pointer is valid until the history is modified or
+	 * many other lines are requested. */
+	Line getLine( size_t index, int columns ) const;
+
+	/** Searches the text in the history, line by line.
+	 * @param fromLine Line where the search starts (included).
+	 * @param backwards Searches from the newest to the oldest lines.
+	 * @param caseSensitive If disabled only the ASCII characters are compared ignoring the case. */
+	SearchResult search( const std::string& text, int fromLine, bool backwards = true,
+						 bool caseSensitive = true ) const;
+
+	/** Compresses the pages once they are full and old enough (disabled by default). */
+	void setCompression( bool compression );
+
+	bool getCompression() const;
+
+	/** @return The memory used by the encoded lines and their indexes. */
+	size_t getMemoryUsage() const;
+
+  protected:
+	struct Page {
+		Uint64 id{ 0 };
+		/** The encoded lines, or the compressed data of the page. */
+		std::vector<Uint8> data;
+		/** Start of every line in the uncompressed data. */
+		std::vector<Uint32> offsets;
+		/** Size of the uncompressed data. */
+		size_t size{ 0 };
+		/** Number of lines of the page already dropped. */
+		size_t first{ 0 };
+		bool compressed{ false };
+	};
+
+	struct CachedLine {
+		Uint64 line{ UINT64_MAX };
+		int columns{ 0 };
+		std::vector<TerminalGlyph> glyphs;
+	};
+
+	std::deque<Page> mPages;
+	size_t mMaxLines{ 1000 };
+	size_t mSize{ 0 };
+	/** Number of lines dropped since the creation, the absolute number of a line is
+	 * mDropped + index. */
+	Uint64 mDropped{ 0 };
+	Uint64 mNextPageId{ 0 };
+	bool mCompression{ false };
+	mutable std::vector<CachedLine> mCache;
+	mutable Uint64 mUncompressedPageId{ UINT64_MAX };
+	mutable std::vector<Uint8> mUncompressed;
+
+	void dropOldest();
+
+	void compressPage( Page& page );
+
+	void uncompressPage( Page& page );
+
+	/** Decompresses the page in data. If the page can't be decompressed its lines are replaced
+	 * by blank lines.
+	 * @return False if the page was corrupted. */
+	bool decompressPage( const Page& page, std::vector<Uint8>& data ) const;
+
+	/** @return The uncompressed data of the page. */
+	const Uint8* getPageData( const Page& page ) const;
+
+	/** @return The encoded line and its size. */
+	const Uint8* getLineData( size_t index, size_t& size ) const;
+
+	void invalidateCache( Uint64 line );
+};
+
+}} // namespace eterm::Terminal
+
+#endif
@@ -42,6 +42,10 @@ void ITerminalDisplay::detach( TerminalEmulator* terminal ) {
 
 void ITerminalDisplay::bell() {}
 
+bool ITerminalDisplay::moveLines( int ) {
+	return false;
+}
+
 void ITerminalDisplay::resetColors() {}
 
 int ITerminalDisplay::resetColor( const Uint32& /*index*/, const char* /*name*/ ) {
@@ -736,8 +736,10 @@ bool TerminalDisplay::drawBegin( Uint32 columns, Uint32 rows ) {
 	if ( columns != mColumns || rows != mRows ) {
 		TerminalGlyph defaultGlyph{};
 		mBuffer.resize( columns * rows, defaultGlyph );
+		mDirtyLines.resize( rows, 1 );
 		mColumns = columns;
 		mRows = rows;
+		mRowOffset = 0;
 
 		if ( !mUseFrameBuffer )
 			initVBOs();
@@ -750,10 +752,11 @@ bool TerminalDisplay::drawBegin( Uint32 columns, Uint32 rows ) {
 }
 
 void TerminalDisplay::drawLine( Line line, int x1, int y, int x2 ) {
-	memcpy( &mBuffer[y * mColumns + x1], line, ( x2 - x1 ) * sizeof( TerminalGlyph ) );
+	TerminalGlyph* row = &mBuffer[getRowSlice( y ) * mColumns];
+	memcpy( &row[x1], line, ( x2 - x1 ) * sizeof( TerminalGlyph ) );
 	for ( int i = x1; i < x2; i++ ) {
 		if ( mTerminal->selected( i, y ) ) {
-			mBuffer[y * mColumns + i].mode |= ATTR_REVERSE;
+			row[i].mode |= ATTR_REVERSE;
 		}
 	}
 	invalidateLine( y );
@@ -770,6 +773,16 @@ void TerminalDisplay::drawCursor( int cx, int cy, TerminalGlyph g, int, int, Ter
 
 void TerminalDisplay::drawEnd() {}
 
+bool TerminalDisplay::moveLines( int lines ) {
+	/* The frame buffer keeps the pixels of the rows, they can't be rotated */
+	if ( mFrameBuffer || 0 == mRows || std::abs( lines ) >= (int)mRows )
+		return false;
+
+	mRowOffset = ( mRowOffset + mRows + lines ) % mRows;
+	mDirty = true;
+	return true;
+}
+
 void TerminalDisplay::draw() {
 	draw( nullptr != mFrameBuffer ? Vector2f( mPadding.Left, mPadding.Top )
 								  : mPosition.floor() + Vector2f( mPadding.Left, mPadding.Top ) );
@@ -1056,7 +1069,7 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 	auto spaceCharAdvanceX = mFont->getGlyph( 'A', mFontSize, false ).advance;
 
 	float x = 0.0f;
-	float y = pos.y;
+	float y = 0.0f;
 	const float lineHeight = fontSize;
 	auto defaultFg = mColorScheme.getForeground();
 	auto defaultBg = mColorScheme.getBackground();
@@ -1064,26 +1077,41 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 	Rectf xBounds = mFont->getGlyph( L'x', mFontSize, false ).bounds;
 	Float strikeThroughOffset = lineHeight + xBounds.Top + cursorThickness;
 
+	/* The vertex buffers are filled with the rows at the position of their slice, and drawn
+	 * translated to the screen rows. Only the range of the dirty slices is uploaded. */
+	bool useVBO = nullptr != mVBForeground;
+	Vector2f origin( useVBO ? Vector2f::Zero : Vector2f( std::floor( pos.x ), pos.y ) );
+	Uint32 rowVertexs = mColumns * mQuadVertexs;
+	Uint32 visibleRows = 0;
+	std::vector<std::pair<Uint32, Uint32>> dirtySlices;
+
 	mPrimitives.setForceDraw( false );
 
-	bool dirtyBG = false;
 	if ( mVBBackground )
 		mVBBackground->bind();
 
 	for ( Uint32 j = 0; j < mRows; j++ ) {
-		x = std::floor( pos.x );
-
-		if ( pos.y + lineHeight * j > pos.y + mSize.getHeight() )
+		if ( lineHeight * j > mSize.getHeight() )
 			break;
 
-		if ( !mDirtyLines[j] ) {
-			y += lineHeight;
+		visibleRows++;
+		Uint32 slice = getRowSlice( j );
+
+		if ( !mDirtyLines[slice] )
 			continue;
+
+		if ( !dirtySlices.empty() && dirtySlices.back().second == slice ) {
+			dirtySlices.back().second++;
+		} else {
+			dirtySlices.emplace_back( slice, slice + 1 );
 		}
 
+		x = origin.x;
+		y = origin.y + ( useVBO ? slice : j ) * lineHeight;
+
 		for ( Uint32 i = 0; i < mColumns; i++ ) {
-			mCurGridPos = { i, j };
-			auto& glyph = mBuffer[j * mColumns + i];
+			mCurGridPos = { i, slice };
+			auto& glyph = mBuffer[slice * mColumns + i];
 			auto fg = termColor( glyph.fg, mColors );
 			auto bg = termColor( glyph.bg, mColors );
 
@@ -1111,7 +1139,6 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 
 			if ( mVBBackground ) {
 				mVBBackground->setQuad( mCurGridPos, { x, y }, { advanceX, lineHeight }, bg );
-				dirtyBG = true;
 			} else {
 				mPrimitives.setColor( bg );
 				mPrimitives.drawRectangle( Rectf( { x, y }, { advanceX, lineHeight } ) );
@@ -1120,44 +1147,37 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 			x += advanceX;
 		}
 
-		y += lineHeight;
-
 		if ( j == (Uint32)mCursor.y )
 			invalidateCursor();
 	}
 
 	if ( mVBBackground ) {
-		if ( dirtyBG )
-			mVBBackground->update( VERTEX_FLAGS_PRIMITIVE, false );
-		mVBBackground->draw();
+		for ( const auto& range : dirtySlices )
+			mVBBackground->update( VERTEX_FLAGS_PRIMITIVE, range.first * rowVertexs,
+								   ( range.second - range.first ) * rowVertexs );
+		drawRowSlices( mVBBackground, pos, visibleRows );
 		mVBBackground->unbind();
 	}
 
-	y = std::floor( pos.y );
-
-	bool dirtyFG = false;
+	for ( Uint32 j = 0; j < visibleRows; j++ ) {
+		Uint32 slice = getRowSlice( j );
 
-	for ( Uint32 j = 0; j < mRows; j++ ) {
-		x = std::floor( pos.x );
-
-		if ( pos.y + lineHeight * j > pos.y + mSize.getHeight() )
-			break;
-
-		if ( ( mFrameBuffer || mVBForeground ) && !mDirtyLines[j] ) {
-			y += lineHeight;
+		if ( ( mFrameBuffer || mVBForeground ) && !mDirtyLines[slice] )
 			continue;
-		}
 
-		mDirtyLines[j] = false;
+		mDirtyLines[slice] = false;
 
 		if ( !mVBStyles.empty() ) {
-			eeSAFE_DELETE( mVBStyles[j] );
-			mVBStyles[j] = createRowVBO( false );
+			eeSAFE_DELETE( mVBStyles[slice] );
+			mVBStyles[slice] = createRowVBO( false );
 		}
 
+		x = origin.x;
+		y = std::floor( origin.y ) + ( useVBO ? slice : j ) * lineHeight;
+
 		for ( Uint32 i = 0; i < mColumns; i++ ) {
-			mCurGridPos = { i, j };
-			auto& glyph = mBuffer[j * mColumns + i];
+			mCurGridPos = { i, slice };
+			auto& glyph = mBuffer[slice * mColumns + i];
 			auto fg = termColor( glyph.fg, mColors );
 			auto bg = termColor( glyph.bg, mColors );
 			Color temp{ Color::Transparent };
@@ -1225,7 +1245,6 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 				} else {
 					gd->draw( { x, y } );
 				}
-				dirtyFG = true;
 
 				if ( mVBStyles.empty() ) {
 					if ( glyph.mode & ATTR_UNDERLINE ) {
@@ -1239,11 +1258,11 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 					}
 				} else {
 					if ( glyph.mode & ATTR_UNDERLINE ) {
-						mVBStyles[j]->addQuad( { x, y + lineHeight - cursorThickness },
-											   { advanceX, cursorThickness }, fg );
+						mVBStyles[slice]->addQuad( { x, y + lineHeight - cursorThickness },
+												   { advanceX, cursorThickness }, fg );
 					} else if ( glyph.mode & ATTR_STRUCK ) {
-						mVBStyles[j]->addQuad( { x, y + strikeThroughOffset },
-											   { advanceX, cursorThickness }, fg );
+						mVBStyles[slice]->addQuad( { x, y + strikeThroughOffset },
+												   { advanceX, cursorThickness }, fg );
 					}
 				}
 			}
@@ -1251,30 +1270,34 @@ void TerminalDisplay::drawGrid( const Vector2f& pos ) {
 			x += advanceX;
 		}
 
-		y += lineHeight;
-
 		if ( j == (Uint32)mCursor.y )
 			invalidateCursor();
 	}
 
 	if ( mVBForeground ) {
 		mFont->getTexture( mFontSize )->bind();
-		if ( dirtyFG )
-			mVBForeground->update( VERTEX_FLAGS_DEFAULT, false );
+		for ( const auto& range : dirtySlices )
+			mVBForeground->update( VERTEX_FLAGS_DEFAULT, range.first * rowVertexs,
+								   ( range.second - range.first ) * rowVertexs );
 		mVBForeground->bind();
-		mVBForeground->draw();
+		drawRowSlices( mVBForeground, pos, visibleRows );
 		mVBForeground->unbind();
 	}
 
 	if ( !mVBStyles.empty() ) {
-		if ( dirtyFG ) {
-			for ( auto& vbo : mVBStyles )
-				vbo->update( VERTEX_FLAGS_PRIMITIVE, false );
-		}
-		for ( auto& vbo : mVBStyles ) {
+		/* The styles are uploaded when their row buffer is compiled */
+		for ( Uint32 j = 0; j < visibleRows; j++ ) {
+			Uint32 slice = getRowSlice( j );
+			VertexBuffer* vbo = mVBStyles[slice];
+			if ( 0 == vbo->getVertexCount() )
+				continue;
+			GLi->pushMatrix();
+			GLi->translatef( std::floor( pos.x ),
+							 std::floor( pos.y ) + ( (Float)j - (Float)slice ) * lineHeight, 0.f );
 			vbo->bind();
 			vbo->draw();
 			vbo->unbind();
+			GLi->popMatrix();
 		}
 	}
 
@@ -1610,10 +1633,11 @@ void TerminalDisplay::invalidateCursor() {
 }
 
 void TerminalDisplay::invalidateLine( const int& line ) {
-	if ( line >= (int)mDirtyLines.size() ) {
-		mDirtyLines.resize( line + 1 );
+	int slice = line >= 0 && line < (int)mRows ? (int)getRowSlice( line ) : line;
+	if ( slice >= (int)mDirtyLines.size() ) {
+		mDirtyLines.resize( slice + 1 );
 	}
-	mDirtyLines[line] = true;
+	mDirtyLines[slice] = true;
 	mDirty = true;
 }
 
@@ -1689,6 +1713,27 @@ void TerminalDisplay::createVBO( VertexBuffer** vbo, bool usesTexCoords ) {
 		( *vbo )->resizeArray( VERTEX_FLAG_TEXTURE0, mRows * mColumns * mQuadVertexs );
 }
 
+void TerminalDisplay::drawRowSlices( VertexBuffer* vbo, const Vector2f& pos,
+									 Uint32 visibleRows ) {
+	Float lineHeight = getLineHeight();
+	Uint32 rowVertexs = mColumns * mQuadVertexs;
+	Vector2f origin( std::floor( pos.x ), std::floor( pos.y ) );
+	/* From the first screen row to the end of the ring, then the first slices */
+	Uint32 rows = eemin( visibleRows, mRows - mRowOffset );
+
+	GLi->pushMatrix();
+	GLi->translatef( origin.x, origin.y - mRowOffset * lineHeight, 0.f );
+	vbo->draw( mRowOffset * rowVertexs, rows * rowVertexs );
+	GLi->popMatrix();
+
+	if ( visibleRows > rows ) {
+		GLi->pushMatrix();
+		GLi->translatef( origin.x, origin.y + rows * lineHeight, 0.f );
+		vbo->draw( 0, ( visibleRows - rows ) * rowVertexs );
+		GLi->popMatrix();
+	}
+}
+
 void TerminalDisplay::initVBOs() {
 	createVBO( &mVBBackground, false );
 	createVBO( &mVBForeground, true );
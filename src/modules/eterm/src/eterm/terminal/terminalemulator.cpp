@@ -36,6 +36,7 @@
 #include <eterm/terminal/boxdrawdata.hpp>
 #include <eterm/terminal/terminalemulator.hpp>
 
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <ctype.h>
@@ -52,6 +53,15 @@
 #include <string.h>
 #include <sys/types.h>
 
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __SSE2__ ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define ETERM_SSE2
+#include <emmintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#endif
+
 #if EE_PLATFORM == EE_PLATFORM_LINUX
 // For malloc_trim, which is a GNU extension
 extern "C" {
@@ -117,9 +127,9 @@ static const unsigned int tabspaces = 4;
 #define ISCONTROLC1( c ) ( BETWEEN( c, 0x80, 0x9f ) )
 #define ISCONTROL( c ) ( ISCONTROLC0( c ) || ISCONTROLC1( c ) )
 #define ISDELIM( u ) ( u && _wcschr( worddelimiters, u ) )
-#define TLINE( y )                                                                                \
-	( ( y ) < mTerm.scr && mTerm.histsize > 0                                                     \
-		  ? mTerm.hist[( ( y ) + mTerm.histi - mTerm.scr + mTerm.histsize + 1 ) % mTerm.histsize] \
+#define TLINE( y )                                                     \
+	( ( y ) < mTerm.scr                                                \
+		  ? mTerm.hist.getLine( mTerm.hist.size() - mTerm.scr + ( y ), mTerm.col ) \
 		  : mTerm.line[(y)-mTerm.scr] )
 
 typedef struct emoji_range {
@@ -653,7 +663,13 @@ void TerminalEmulator::kscrolldown( const TerminalArg* a ) {
 	if ( mTerm.scr > 0 ) {
 		mTerm.scr -= n;
 		selscroll( 0, -n );
-		tfulldirt();
+		if ( n < mTerm.row && tmovedisplay( n ) ) {
+			/* The rows still visible are kept by the display, only the new bottom rows are drawn */
+			memmove( mTerm.dirty, mTerm.dirty + n, ( mTerm.row - n ) * sizeof( *mTerm.dirty ) );
+			tsetdirt( mTerm.row - n, mTerm.row - 1 );
+		} else {
+			tfulldirt();
+		}
 	}
 }
 
@@ -661,28 +677,33 @@ void TerminalEmulator::kscrollup( const TerminalArg* a ) {
 	int n = a->i;
 
 	if ( n == INT_MAX )
-		n = mTerm.histi - mTerm.scr;
+		n = (int)mTerm.hist.size() - mTerm.scr;
 
 	if ( n < 0 )
 		n = mTerm.row + n;
 
-	if ( mTerm.scr + n > mTerm.histi )
-		n = mTerm.histi - mTerm.scr;
+	if ( mTerm.scr + n > (int)mTerm.hist.size() )
+		n = (int)mTerm.hist.size() - mTerm.scr;
 
 	if ( n == 0 )
 		return;
 
-	if ( mTerm.scr <= mTerm.histsize - n && mTerm.scr + n <= mTerm.histi ) {
+	if ( mTerm.scr + n <= (int)mTerm.hist.size() ) {
 		mTerm.scr += n;
 		selscroll( 0, n );
-		tfulldirt();
+		if ( n < mTerm.row && tmovedisplay( -n ) ) {
+			memmove( mTerm.dirty + n, mTerm.dirty, ( mTerm.row - n ) * sizeof( *mTerm.dirty ) );
+			tsetdirt( 0, n - 1 );
+		} else {
+			tfulldirt();
+		}
 	}
 }
 
 void TerminalEmulator::kscrollto( const TerminalArg* a ) {
 	int n = a->i;
 
-	if ( 0 <= n && n <= mTerm.histi ) {
+	if ( 0 <= n && n <= (int)mTerm.hist.size() ) {
 		mTerm.scr = n;
 		selscroll( 0, n );
 		tfulldirt();
@@ -694,7 +715,7 @@ int TerminalEmulator::tisaltscr() {
 }
 
 int TerminalEmulator::scrollSize() const {
-	return mTerm.histi;
+	return mTerm.hist.size();
 }
 
 int TerminalEmulator::rowCount() const {
@@ -710,11 +731,11 @@ void TerminalEmulator::trimMemory() {
 }
 
 void TerminalEmulator::clearHistory() {
-	for ( int i = 0; i < mTerm.histcursize; ++i )
-		eeSAFE_FREE( mTerm.hist[i] );
-	eeSAFE_FREE( mTerm.hist );
-	mTerm.histcursize = 0;
-	mTerm.histi = 0;
+	mTerm.hist.clear();
+	if ( mTerm.scr > 0 ) {
+		mTerm.scr = 0;
+		tfulldirt();
+	}
 	trimMemory();
 }
 
@@ -814,6 +835,11 @@ void TerminalEmulator::tfulldirt( void ) {
 	tsetdirt( 0, mTerm.row - 1 );
 }
 
+bool TerminalEmulator::tmovedisplay( int n ) {
+	auto dpy = mDpy.lock();
+	return n != 0 && dpy && dpy->moveLines( n );
+}
+
 void TerminalEmulator::tcursor( int mode ) {
 	static TerminalCursor c[2];
 	int alt = IS_SET( MODE_ALTSCREEN );
@@ -861,7 +887,7 @@ void TerminalEmulator::tnew( int col, int row, size_t historySize ) {
 	mTerm.c.attr = TerminalGlyph{};
 	mTerm.c.attr.fg = mDefaultFg;
 	mTerm.c.attr.bg = mDefaultBg;
-	mTerm.histsize = historySize;
+	mTerm.hist.setMaxLines( historySize );
 
 	tresize( col, row );
 	treset();
@@ -876,45 +902,42 @@ void TerminalEmulator::tswapscreen( void ) {
 	tfulldirt();
 }
 
-void TerminalEmulator::resizeHistory() {
-	size_t oriSize = mTerm.histcursize;
-	if ( mTerm.histi >= (int)mTerm.histcursize ) {
-		int newSize = eemin( mTerm.histi + mTerm.row, mTerm.histsize );
-		mTerm.hist = (Line*)xrealloc( mTerm.hist, newSize * sizeof( Line ) );
-		mTerm.histcursize = newSize;
-
-		for ( int i = oriSize; i < mTerm.histcursize; i++ ) {
-			mTerm.hist[i] = (TerminalGlyph*)xmalloc( mTerm.col * sizeof( TerminalGlyph ) );
-			for ( int j = 0; j < mTerm.col; j++ ) {
-				mTerm.hist[i][j] = mTerm.c.attr;
-				mTerm.hist[i][j].u = ' ';
-			}
-		}
-	}
-}
-
 void TerminalEmulator::tscrolldown( int orig, int n, int copyhist ) {
 	int i;
 	Line temp;
 
 	LIMIT( n, 0, mTerm.bot - orig + 1 );
-	if ( copyhist && mTerm.histsize > 0 ) {
-		mTerm.histi = ( mTerm.histi - 1 + mTerm.histsize ) % mTerm.histsize;
-		resizeHistory();
-		temp = mTerm.hist[mTerm.histi];
-		mTerm.hist[mTerm.histi] = mTerm.line[mTerm.bot];
-		mTerm.line[mTerm.bot] = temp;
+	if ( copyhist && !mTerm.hist.empty() ) {
+		/* The newest history line is dropped and the bottom line replaces the next one */
+		mTerm.hist.pop();
+		if ( !mTerm.hist.empty() ) {
+			mTerm.hist.pop();
+			mTerm.hist.push( mTerm.line[mTerm.bot], mTerm.col );
+		}
+		mTerm.scr = MIN( mTerm.scr, (int)mTerm.hist.size() );
 	}
 
-	tsetdirt( orig, mTerm.bot - n );
+	/* When the whole screen scrolls the display moves its rows, and the dirtiness moves with the
+	 * lines */
+	bool moved = orig == 0 && mTerm.bot == mTerm.row - 1 && mTerm.scr == 0 && n < mTerm.row &&
+				 tmovedisplay( -n );
+
+	if ( !moved )
+		tsetdirt( orig, mTerm.bot - n );
 	tclearregion( 0, mTerm.bot - n + 1, mTerm.col - 1, mTerm.bot );
 
 	for ( i = mTerm.bot; i >= orig + n; i-- ) {
 		temp = mTerm.line[i];
 		mTerm.line[i] = mTerm.line[i - n];
 		mTerm.line[i - n] = temp;
+		if ( moved )
+			std::swap( mTerm.dirty[i], mTerm.dirty[i - n] );
 	}
 
+	/* The selected rows moved, they are redrawn if the selection is cleared */
+	if ( moved && mSel.ob.x != -1 )
+		tsetdirt( mSel.nb.y + n, mSel.ne.y + n );
+
 	if ( mTerm.scr == 0 )
 		selscroll( orig, n );
 }
@@ -925,26 +948,30 @@ void TerminalEmulator::tscrollup( int orig, int n, int copyhist ) {
 
 	LIMIT( n, 0, mTerm.bot - orig + 1 );
 
-	if ( copyhist && mTerm.histsize > 0 ) {
-		mTerm.histi = ( mTerm.histi + 1 ) % mTerm.histsize;
-		resizeHistory();
-		temp = mTerm.hist[mTerm.histi];
-		mTerm.hist[mTerm.histi] = mTerm.line[orig];
-		mTerm.line[orig] = temp;
-	}
+	if ( copyhist )
+		mTerm.hist.push( mTerm.line[orig], mTerm.col );
 
-	if ( mTerm.scr > 0 && mTerm.scr < mTerm.histsize )
-		mTerm.scr = MIN( mTerm.scr + n, mTerm.histsize - 1 );
+	if ( mTerm.scr > 0 )
+		mTerm.scr = MIN( mTerm.scr + n, (int)mTerm.hist.size() );
+
+	bool moved = orig == 0 && mTerm.bot == mTerm.row - 1 && mTerm.scr == 0 && n < mTerm.row &&
+				 tmovedisplay( n );
 
 	tclearregion( 0, orig, mTerm.col - 1, orig + n - 1 );
-	tsetdirt( orig + n, mTerm.bot );
+	if ( !moved )
+		tsetdirt( orig + n, mTerm.bot );
 
 	for ( i = orig; i <= mTerm.bot - n; i++ ) {
 		temp = mTerm.line[i];
 		mTerm.line[i] = mTerm.line[i + n];
 		mTerm.line[i + n] = temp;
+		if ( moved )
+			std::swap( mTerm.dirty[i], mTerm.dirty[i + n] );
 	}
 
+	if ( moved && mSel.ob.x != -1 )
+		tsetdirt( mSel.nb.y - n, mSel.ne.y - n );
+
 	if ( mTerm.scr == 0 )
 		selscroll( orig, -n );
 }
@@ -1046,23 +1073,23 @@ void TerminalEmulator::tsetchar( Rune u, TerminalGlyph* attr, int x, int y ) {
 		 vt100_0[u - 0x41] )
 		utf8decode( vt100_0[u - 0x41], &u, UTF_SIZ );
 
-	if ( TLINE( y )[x].mode & ATTR_WIDE ) {
+	if ( mTerm.line[y][x].mode & ATTR_WIDE ) {
 		if ( x + 1 < mTerm.col ) {
-			TLINE( y )[x + 1].u = ' ';
-			TLINE( y )[x + 1].mode &= ~ATTR_WDUMMY;
+			mTerm.line[y][x + 1].u = ' ';
+			mTerm.line[y][x + 1].mode &= ~ATTR_WDUMMY;
 		}
-	} else if ( TLINE( y )[x].mode & ATTR_WDUMMY ) {
-		TLINE( y )[x - 1].u = ' ';
-		TLINE( y )[x - 1].mode &= ~ATTR_WIDE;
+	} else if ( mTerm.line[y][x].mode & ATTR_WDUMMY ) {
+		mTerm.line[y][x - 1].u = ' ';
+		mTerm.line[y][x - 1].mode &= ~ATTR_WIDE;
 	}
 
 	mTerm.dirty[y] = 1;
-	TLINE( y )[x] = *attr;
-	TLINE( y )[x].u = u;
+	mTerm.line[y][x] = *attr;
+	mTerm.line[y][x].u = u;
 	mDirty = true;
 
 	if ( isboxdraw( u ) )
-		TLINE( y )[x].mode |= ATTR_BOXDRAW;
+		mTerm.line[y][x].mode |= ATTR_BOXDRAW;
 }
 
 void TerminalEmulator::tclearregion( int x1, int y1, int x2, int y2 ) {
@@ -1079,18 +1106,26 @@ void TerminalEmulator::tclearregion( int x1, int y1, int x2, int y2 ) {
 	LIMIT( y1, 0, mTerm.row - 1 );
 	LIMIT( y2, 0, mTerm.row - 1 );
 
+	TerminalGlyph blank;
+	blank.fg = mTerm.c.attr.fg;
+	blank.bg = mTerm.c.attr.bg;
+	blank.u = ' ';
+	bool checksel = mSel.mode != SEL_EMPTY && mSel.ob.x != -1;
+
 	for ( y = y1; y <= y2; y++ ) {
 		mTerm.dirty[y] = 1;
 		mDirty = true;
-		for ( x = x1; x <= x2; x++ ) {
-			gp = &TLINE( y )[x];
-			if ( selected( x, y ) )
-				selclear();
-			gp->fg = mTerm.c.attr.fg;
-			gp->bg = mTerm.c.attr.bg;
-			gp->mode = 0;
-			gp->u = ' ';
+		gp = mTerm.line[y];
+		if ( checksel ) {
+			for ( x = x1; x <= x2; x++ ) {
+				if ( selected( x, y ) ) {
+					selclear();
+					checksel = false;
+					break;
+				}
+			}
 		}
+		std::fill( gp + x1, gp + x2 + 1, blank );
 	}
 }
 
@@ -2252,12 +2287,121 @@ check_control_code:
 	}
 }
 
+/* Length of the run of printable ASCII characters at the start of the buffer */
+static int asciirunlen( const char* buf, int buflen ) {
+	int n = 0;
+
+#ifdef ETERM_SSE2
+	const __m128i low = _mm_set1_epi8( 0x1f );
+	const __m128i high = _mm_set1_epi8( 0x7f );
+
+	for ( ; n + 16 <= buflen; n += 16 ) {
+		__m128i bytes = _mm_loadu_si128( (const __m128i*)( buf + n ) );
+		/* the bytes >= 0x80 are negative, so they fail the first comparison */
+		__m128i printable =
+			_mm_and_si128( _mm_cmpgt_epi8( bytes, low ), _mm_cmplt_epi8( bytes, high ) );
+		unsigned int mask = ~_mm_movemask_epi8( printable ) & 0xFFFF;
+
+		if ( mask ) {
+#if defined( _MSC_VER ) && !defined( __clang__ )
+			unsigned long index;
+			_BitScanForward( &index, mask );
+			return n + (int)index;
+#else
+			return n + __builtin_ctz( mask );
+#endif
+		}
+	}
+#endif
+
+	while ( n < buflen && BETWEEN( (uchar)buf[n], 0x20, 0x7e ) )
+		n++;
+
+	return n;
+}
+
+/* The printable ASCII characters can skip tputc when no sequence is being parsed and the
+ * characters are written as they are: one column each and without any translation. */
+bool TerminalEmulator::tcanputascii() const {
+	return !mTerm.esc && !IS_SET( MODE_PRINT ) && !IS_SET( MODE_INSERT ) &&
+		   mTerm.trantbl[mTerm.charset] != CS_GRAPHIC0;
+}
+
+/* Same as calling tputc for every character, but the line is filled in chunks */
+void TerminalEmulator::tputascii( const char* buf, int len ) {
+	while ( len > 0 ) {
+		if ( mTerm.c.state & CURSOR_WRAPNEXT ) {
+			if ( !IS_SET( MODE_WRAP ) ) {
+				/* every character overwrites the last column, only the last one remains */
+				buf += len - 1;
+				len = 1;
+			} else {
+				mTerm.line[mTerm.c.y][mTerm.c.x].mode |= ATTR_WRAP;
+				tnewline( 1 );
+			}
+		}
+
+		int x = mTerm.c.x;
+		int y = mTerm.c.y;
+		int count = MIN( len, mTerm.col - x );
+		TerminalGlyph* gp = &mTerm.line[y][x];
+
+		if ( mSel.mode != SEL_EMPTY && mSel.ob.x != -1 ) {
+			for ( int i = 0; i < count; i++ ) {
+				if ( selected( x + i, y ) ) {
+					selclear();
+					break;
+				}
+			}
+		}
+
+		/* only the wide characters at the edges of the chunk can be left half overwritten */
+		if ( ( gp[0].mode & ATTR_WDUMMY ) && x > 0 ) {
+			gp[-1].u = ' ';
+			gp[-1].mode &= ~ATTR_WIDE;
+		}
+		if ( ( gp[count - 1].mode & ATTR_WIDE ) && x + count < mTerm.col ) {
+			gp[count].u = ' ';
+			gp[count].mode &= ~ATTR_WDUMMY;
+		}
+
+		TerminalGlyph attr = mTerm.c.attr;
+		for ( int i = 0; i < count; i++ ) {
+			attr.u = (uchar)buf[i];
+			gp[i] = attr;
+		}
+
+		mTerm.dirty[y] = 1;
+		mDirty = true;
+		mTerm.lastc = (uchar)buf[count - 1];
+		buf += count;
+		len -= count;
+
+		if ( x + count < mTerm.col ) {
+			mTerm.c.x = x + count;
+			mTerm.c.state &= ~CURSOR_WRAPNEXT;
+		} else {
+			mTerm.c.x = mTerm.col - 1;
+			mTerm.c.state |= CURSOR_WRAPNEXT;
+		}
+	}
+}
+
 int TerminalEmulator::twrite( const char* buf, int buflen, int show_ctrl ) {
 	size_t charsize;
 	Rune u;
 	int n;
 
 	for ( n = 0; n < buflen; n += charsize ) {
+		if ( !show_ctrl && tcanputascii() ) {
+			int len = asciirunlen( buf + n, buflen - n );
+			if ( len > 0 ) {
+				tputascii( buf + n, len );
+				charsize = len;
+				continue;
+			}
+		}
+
 		if ( IS_SET( MODE_UTF8 ) ) {
 			/* process a complete utf8 char */
 			charsize = utf8decode( buf + n, &u, buflen - n );
@@ -2283,7 +2427,7 @@ int TerminalEmulator::twrite( const char* buf, int buflen, int show_ctrl ) {
 }
 
 void TerminalEmulator::tresize( int col, int row ) {
-	int i, j;
+	int i;
 	int minrow = MIN( row, mTerm.row );
 	int mincol = MIN( col, mTerm.col );
 	int* bp;
@@ -2331,15 +2475,6 @@ void TerminalEmulator::tresize( int col, int row ) {
 		mTerm.alt[i] = (Line)xmalloc( col * sizeof( TerminalGlyph ) );
 	}
 
-	/* add new columns to history */
-	for ( int i = 0; i < mTerm.histcursize; i++ ) {
-		mTerm.hist[i] = (TerminalGlyph*)xrealloc( mTerm.hist[i], col * sizeof( TerminalGlyph ) );
-		for ( j = mincol; j < col; j++ ) {
-			mTerm.hist[i][j] = mTerm.c.attr;
-			mTerm.hist[i][j].u = ' ';
-		}
-	}
-
 	if ( col > mTerm.col ) {
 		bp = mTerm.tabs + mTerm.col;
 
@@ -2670,7 +2805,15 @@ int TerminalEmulator::getExitCode() const {
 }
 
 int TerminalEmulator::getHistorySize() const {
-	return mTerm.histi;
+	return mTerm.hist.size();
+}
+
+const TerminalHistory& TerminalEmulator::getHistory() const {
+	return mTerm.hist;
+}
+
+void TerminalEmulator::setHistoryCompression( bool compression ) {
+	mTerm.hist.setCompression( compression );
 }
 
 int TerminalEmulator::write( const char* buf, size_t buflen ) {
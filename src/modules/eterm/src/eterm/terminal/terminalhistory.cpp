@@ -0,0 +1,399 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <eepp/core/utf.hpp>
+#include <eepp/system/compression.hpp>
+#include <eepp/system/iostreammemory.hpp>
+#include <eepp/system/iostreamstring.hpp>
+#include <eepp/system/log.hpp>
+#include <eterm/terminal/terminalhistory.hpp>
+
+using namespace EE;
+using namespace EE::System;
+
+namespace eterm { namespace Terminal {
+
+static constexpr size_t LINES_PER_PAGE = 256;
+/* The newest pages are never compressed, they are the most accessed */
+static constexpr size_t HOT_PAGES = 2;
+static constexpr size_t CACHE_SIZE = 64;
+
+/* Line: glyphs count, runs count, text size, UTF-8 text, runs, padding attributes */
+static constexpr size_t LINE_HEADER_SIZE = sizeof( Uint16 ) * 2 + sizeof( Uint32 );
+static constexpr size_t RUN_SIZE = sizeof( Uint16 ) + sizeof( ushort ) + sizeof( uint32_t ) * 2;
+static constexpr size_t UTF_SIZE = 4;
+
+template <typename T> static Uint8* writeValue( Uint8* data, const T& value ) {
+	memcpy( data, &value, sizeof( T ) );
+	return data + sizeof( T );
+}
+
+template <typename T> static T readValue( const Uint8*& data ) {
+	T value;
+	memcpy( &value, data, sizeof( T ) );
+	data += sizeof( T );
+	return value;
+}
+
+static Uint8* writeAttr( Uint8* data, const TerminalGlyph& glyph ) {
+	data = writeValue<ushort>( data, glyph.mode );
+	data = writeValue<uint32_t>( data, glyph.fg );
+	return writeValue<uint32_t>( data, glyph.bg );
+}
+
+static void readAttr( const Uint8*& data, TerminalGlyph& glyph ) {
+	glyph.mode = readValue<ushort>( data );
+	glyph.fg = readValue<uint32_t>( data );
+	glyph.bg = readValue<uint32_t>( data );
+}
+
+static bool sameAttr( const TerminalGlyph& a, const TerminalGlyph& b ) {
+	return a.mode == b.mode && a.fg == b.fg && a.bg == b.bg;
+}
+
+TerminalHistory::TerminalHistory() {}
+
+TerminalHistory::TerminalHistory( size_t maxLines ) : mMaxLines( maxLines ) {}
+
+void TerminalHistory::setMaxLines( size_t maxLines ) {
+	mMaxLines = maxLines;
+	while ( mSize > mMaxLines )
+		dropOldest();
+}
+
+size_t TerminalHistory::getMaxLines() const {
+	return mMaxLines;
+}
+
+size_t TerminalHistory::size() const {
+	return mSize;
+}
+
+bool TerminalHistory::empty() const {
+	return mSize == 0;
+}
+
+void TerminalHistory::push( const TerminalGlyph* line, int columns ) {
+	if ( mMaxLines == 0 )
+		return;
+
+	if ( mPages.empty() || mPages.back().offsets.size() >= LINES_PER_PAGE ) {
+		if ( !mPages.empty() )
+			mPages.back().data.shrink_to_fit();
+
+		if ( mCompression && mPages.size() >= HOT_PAGES )
+			compressPage( mPages[mPages.size() - HOT_PAGES] );
+
+		mPages.emplace_back();
+		mPages.back().id = mNextPageId++;
+		mPages.back().data.reserve( 64 * LINES_PER_PAGE );
+	}
+
+	Page& page = mPages.back();
+	std::vector<Uint8>& data = page.data;
+
+	/* The trailing blanks are not stored, they are the padding of the line. The padding keeps
+	 * the colors of the last glyph but not the flags that only belong to it, so a wrapped line
+	 * keeps its last glyph. */
+	int count = eemax( 0, columns );
+	TerminalGlyph pad;
+	if ( count > 0 )
+		pad = line[count - 1];
+	pad.u = ' ';
+	pad.mode &= ~( ATTR_WRAP | ATTR_WIDE | ATTR_WDUMMY | ATTR_BOXDRAW );
+	while ( count > 0 && line[count - 1].u == ' ' && sameAttr( line[count - 1], pad ) )
+		count--;
+
+	Uint16 runs = 0;
+	for ( int i = 0; i < count; i++ )
+		if ( i == 0 || !sameAttr( line[i], line[i - 1] ) )
+			runs++;
+
+	/* The record is written in place, the buffer is shrunk to the UTF-8 text size at the end */
+	size_t start = data.size();
+	page.offsets.push_back( start );
+	data.resize( start + LINE_HEADER_SIZE + count * UTF_SIZE + ( runs + 1 ) * RUN_SIZE );
+
+	Uint8* header = &data[start];
+	Uint8* out = writeValue<Uint16>( header, count );
+	out = writeValue<Uint16>( out, runs ) + sizeof( Uint32 );
+
+	Uint8* text = out;
+	for ( int i = 0; i < count; i++ ) {
+		if ( line[i].u < 0x80 )
+			*out++ = line[i].u;
+		else
+			out = Utf8::encode( line[i].u, out, '?' );
+	}
+	writeValue<Uint32>( header + sizeof( Uint16 ) * 2, out - text );
+
+	for ( int i = 0; i < count; ) {
+		int first = i;
+		while ( i < count && sameAttr( line[i], line[first] ) )
+			i++;
+		out = writeValue<Uint16>( out, i - first );
+		out = writeAttr( out, line[first] );
+	}
+
+	out = writeAttr( out, pad );
+	data.resize( out - data.data() );
+	page.size = data.size();
+
+	mSize++;
+	while ( mSize > mMaxLines )
+		dropOldest();
+}
+
+void TerminalHistory::pop() {
+	if ( mSize == 0 )
+		return;
+
+	Page& page = mPages.back();
+	if ( page.compressed )
+		uncompressPage( page );
+
+	invalidateCache( mDropped + mSize - 1 );
+	page.data.resize( page.offsets.back() );
+	page.offsets.pop_back();
+	page.size = page.data.size();
+	mSize--;
+
+	if ( page.offsets.size() == page.first )
+		mPages.pop_back();
+}
+
+void TerminalHistory::clear() {
+	mPages.clear();
+	mDropped += mSize;
+	mSize = 0;
+	mUncompressedPageId = UINT64_MAX;
+	mUncompressed.clear();
+	mUncompressed.shrink_to_fit();
+}
+
+void TerminalHistory::dropOldest() {
+	Page& page = mPages.front();
+	page.first++;
+	mSize--;
+	mDropped++;
+	if ( page.first == page.offsets.size() )
+		mPages.pop_front();
+}
+
+void TerminalHistory::compressPage( Page& page ) {
+	if ( page.compressed || page.size == 0 )
+		return;
+
+	IOStreamMemory src( (const char*)page.data.data(), page.size );
+	IOStreamString dst;
+
+	if ( Compression::compress( dst, src ) != Compression::OK || (size_t)dst.getSize() >= page.size )
+		return;
+
+	const std::string& stream = dst.getStream();
+	std::vector<Uint8>( stream.begin(), stream.end() ).swap( page.data );
+	page.compressed = true;
+}
+
+void TerminalHistory::uncompressPage( Page& page ) {
+	if ( !page.compressed )
+		return;
+
+	std::vector<Uint8> data;
+	decompressPage( page, data );
+	page.data.swap( data );
+	page.compressed = false;
+
+	if ( mUncompressedPageId == page.id )
+		mUncompressedPageId = UINT64_MAX;
+}
+
+bool TerminalHistory::decompressPage( const Page& page, std::vector<Uint8>& data ) const {
+	data.resize( page.size );
+
+	IOStreamMemory src( (const char*)page.data.data(), page.data.size() );
+	IOStreamMemory dst( (char*)data.data(), data.size() );
+
+	if ( Compression::decompress( dst, src ) == Compression::OK &&
+		 (size_t)dst.tell() == page.size )
+		return true;
+
+	Log::error( "TerminalHistory: couldn't decompress the history page %llu, its lines are lost",
+				(unsigned long long)page.id );
+
+	/* A zeroed record is an empty line with the default padding, and every line record is at
+	 * least that size, so the line offsets are still valid */
+	std::fill( data.begin(), data.end(), 0 );
+
+	return false;
+}
+
+const Uint8* TerminalHistory::getPageData( const Page& page ) const {
+	if ( !page.compressed )
+		return page.data.data();
+
+	if ( mUncompressedPageId != page.id ) {
+		decompressPage( page, mUncompressed );
+		mUncompressedPageId = page.id;
+	}
+
+	return mUncompressed.data();
+}
+
+const Uint8* TerminalHistory::getLineData( size_t index, size_t& size ) const {
+	/* Every page is full except the last one */
+	size_t slot = index + mPages.front().first;
+	const Page& page = mPages[slot / LINES_PER_PAGE];
+	size_t line = slot % LINES_PER_PAGE;
+	size_t start = page.offsets[line];
+	size_t end = line + 1 < page.offsets.size() ? page.offsets[line + 1] : page.size;
+	size = end - start;
+	return getPageData( page ) + start;
+}
+
+void TerminalHistory::invalidateCache( Uint64 line ) {
+	if ( mCache.empty() )
+		return;
+	CachedLine& cached = mCache[line % CACHE_SIZE];
+	if ( cached.line == line )
+		cached.line = UINT64_MAX;
+}
+
+Line TerminalHistory::getLine( size_t index, int columns ) const {
+	if ( mCache.empty() )
+		mCache.resize( CACHE_SIZE );
+
+	Uint64 lineNum = mDropped + index;
+	CachedLine& cached = mCache[lineNum % CACHE_SIZE];
+	columns = eemax( 1, columns );
+
+	if ( cached.line == lineNum && cached.columns == columns )
+		return cached.glyphs.data();
+
+	cached.line = lineNum;
+	cached.columns = columns;
+	cached.glyphs.resize( columns );
+
+	size_t size;
+	const Uint8* data = getLineData( index, size );
+	int count = readValue<Uint16>( data );
+	int runs = readValue<Uint16>( data );
+	Uint32 textSize = readValue<Uint32>( data );
+	const Uint8* text = data;
+	const Uint8* textEnd = text + textSize;
+	const Uint8* attrs = textEnd;
+	TerminalGlyph* glyphs = cached.glyphs.data();
+	int x = 0;
+
+	for ( int r = 0; r < runs; r++ ) {
+		int length = readValue<Uint16>( attrs );
+		TerminalGlyph attr;
+		readAttr( attrs, attr );
+		for ( int i = 0; i < length; i++, x++ ) {
+			Uint32 rune = 0;
+			text = Utf8::decode( text, textEnd, rune );
+			if ( x < columns ) {
+				glyphs[x] = attr;
+				glyphs[x].u = rune;
+			}
+		}
+	}
+
+	TerminalGlyph pad;
+	readAttr( attrs, pad );
+	pad.u = ' ';
+	for ( x = eemin( count, columns ); x < columns; x++ )
+		glyphs[x] = pad;
+
+	return glyphs;
+}
+
+TerminalHistory::SearchResult TerminalHistory::search( const std::string& text, int fromLine,
+													   bool backwards, bool caseSensitive ) const {
+	SearchResult result;
+	if ( text.empty() || mSize == 0 )
+		return result;
+
+	auto compare = [caseSensitive]( char a, char b ) {
+		return caseSensitive ? a == b
+							 : std::tolower( (unsigned char)a ) == std::tolower( (unsigned char)b );
+	};
+
+	/* The text is searched directly in the encoded lines, without decoding them. A wide glyph is
+	 * followed by a dummy glyph stored as a zero byte, those lines are searched without the dummy
+	 * glyphs and every byte keeps the column of its glyph, so the wide text is found and the
+	 * column is counted in cells. */
+	std::string lineText;
+	std::vector<int> byteColumns;
+	Int64 line = eeclamp<Int64>( fromLine, 0, mSize - 1 );
+	for ( ; line >= 0 && line < (Int64)mSize; line += backwards ? -1 : 1 ) {
+		size_t size;
+		const Uint8* data = getLineData( line, size ) + sizeof( Uint16 ) * 2;
+		Uint32 textSize = readValue<Uint32>( data );
+		const char* begin = (const char*)data;
+		const char* end = begin + textSize;
+		bool hasWide = memchr( begin, '\0', textSize ) != NULL;
+
+		if ( hasWide ) {
+			lineText.clear();
+			byteColumns.clear();
+			int column = -1;
+			for ( const char* c = begin; c < end; c++ ) {
+				if ( ( *c & 0xC0 ) != 0x80 )
+					column++;
+				if ( *c == '\0' )
+					continue;
+				lineText += *c;
+				byteColumns.push_back( column );
+			}
+			begin = lineText.data();
+			end = begin + lineText.size();
+		}
+
+		const char* found = std::search( begin, end, text.begin(), text.end(), compare );
+
+		if ( found != end ) {
+			result.line = line;
+			if ( hasWide ) {
+				result.column = byteColumns[found - begin];
+			} else {
+				/* Column of the glyph, counting the UTF-8 lead bytes */
+				for ( const char* c = begin; c < found; c++ )
+					if ( ( *c & 0xC0 ) != 0x80 )
+						result.column++;
+			}
+			return result;
+		}
+	}
+
+	return result;
+}
+
+void TerminalHistory::setCompression( bool compression ) {
+	if ( mCompression == compression )
+		return;
+
+	mCompression = compression;
+
+	for ( size_t i = 0; i < mPages.size(); i++ ) {
+		if ( !compression )
+			uncompressPage( mPages[i] );
+		else if ( i + HOT_PAGES < mPages.size() )
+			compressPage( mPages[i] );
+	}
+}
+
+bool TerminalHistory::getCompression() const {
+	return mCompression;
+}
+
+size_t TerminalHistory::getMemoryUsage() const {
+	size_t usage = mUncompressed.capacity();
+	for ( const auto& page : mPages )
+		usage += page.data.capacity() + page.offsets.capacity() * sizeof( Uint32 );
+	for ( const auto& cached : mCache )
+		usage += cached.glyphs.capacity() * sizeof( TerminalGlyph );
+	return usage;
+}
+
+}} // namespace eterm::Terminal
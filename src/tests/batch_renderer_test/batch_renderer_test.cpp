@@ -0,0 +1,305 @@
+#include <eepp/ee.hpp>
+#include <eepp/graphics/renderer/vertexbufferring.hpp>
+#include <iostream>
+
+// Checks the BatchRenderer batching without a GL context: the draws are recorded by a Renderer
+// that only keeps the vertexs, primitive type and blend mode of every draw call. Checks the flush
+// reasons and statistics, the vertexs of every batch, the growth of the vertex buffer and the
+// streaming buffer slices (wrapping and orphaning).
+// Usage: eepp-batch-renderer-test
+
+static int sFailures = 0;
+
+#define CHECK( cond, msg )                                                   \
+	if ( !( cond ) ) {                                                       \
+		std::cerr << "FAILED: " << msg << " (" << #cond << ")" << std::endl; \
+		sFailures++;                                                         \
+	}
+
+class RecordingRenderer : public Renderer {
+  public:
+	struct DrawCall {
+		unsigned int mode;
+		int count;
+		BlendMode blend;
+		std::vector<VertexData> vertexs;
+		bool streamed{ false };
+		Uint32 size{ 0 };
+		VertexBufferRing::Slice slice;
+	};
+
+	std::vector<DrawCall> draws;
+
+	// With stream enabled the vertexs are sub-allocated from a ring as RendererGL3CP does.
+	explicit RecordingRenderer( bool stream = false, Uint32 ringCapacity = 1024 ) :
+		mStream( stream ), mRing( ringCapacity ) {}
+
+	void setQuadsSupported( bool supported ) { mQuadsSupported = supported; }
+
+	const VertexBufferRing& getRing() const { return mRing; }
+
+	virtual bool streamVertexs( const void* data, unsigned int size, int stride, int, int ) {
+		if ( !mStream )
+			return false;
+
+		setPending( data, size, stride );
+		mPending.streamed = true;
+		mPending.slice = mRing.allocate( size );
+		return true;
+	}
+
+	virtual void vertexPointer( int, unsigned int, int stride, const void* pointer,
+								unsigned int allocate ) {
+		setPending( pointer, allocate, stride );
+	}
+
+	virtual void drawArrays( unsigned int mode, int, int count ) {
+		mPending.mode = mode;
+		mPending.count = count;
+		mPending.blend = BlendMode::getPreBlendFunc();
+		draws.push_back( mPending );
+		mPending = DrawCall();
+	}
+
+	virtual void blendFunc( unsigned int, unsigned int ) {}
+	virtual void disable( unsigned int ) {}
+	virtual void enable( unsigned int ) {}
+	virtual void pointSize( float ) {}
+	virtual float pointSize() { return 1; }
+	virtual void clientActiveTexture( unsigned int ) {}
+	virtual GraphicsLibraryVersion version() { return GLv_3CP; }
+	virtual std::string versionStr() { return "recording"; }
+	virtual void pushMatrix() {}
+	virtual void popMatrix() {}
+	virtual void loadIdentity() {}
+	virtual void translatef( float, float, float ) {}
+	virtual void rotatef( float, float, float, float ) {}
+	virtual void scalef( float, float, float ) {}
+	virtual void matrixMode( unsigned int ) {}
+	virtual void ortho( float, float, float, float, float, float ) {}
+	virtual void lookAt( float, float, float, float, float, float, float, float, float ) {}
+	virtual void perspective( float, float, float, float ) {}
+	virtual void enableClientState( unsigned int ) {}
+	virtual void disableClientState( unsigned int ) {}
+	virtual void colorPointer( int, unsigned int, int, const void*, unsigned int ) {}
+	virtual void texCoordPointer( int, unsigned int, int, const void*, unsigned int ) {}
+	virtual void clip2DPlaneEnable( const Int32&, const Int32&, const Int32&, const Int32& ) {}
+	virtual void clip2DPlaneDisable() {}
+	virtual void multMatrixf( const float* ) {}
+	virtual void clipPlane( unsigned int, const double* ) {}
+	virtual void loadMatrixf( const float* ) {}
+	virtual void frustum( float, float, float, float, float, float ) {}
+	virtual void getCurrentMatrix( unsigned int, float* ) {}
+	virtual unsigned int getCurrentMatrixMode() { return 0; }
+	virtual int project( float, float, float, const float[16], const float[16], const int[4],
+						 float*, float*, float* ) {
+		return 0;
+	}
+	virtual int unProject( float, float, float, const float[16], const float[16], const int[4],
+						   float*, float*, float* ) {
+		return 0;
+	}
+
+  protected:
+	bool mStream;
+	VertexBufferRing mRing;
+	DrawCall mPending;
+
+	void setPending( const void* data, unsigned int size, int stride ) {
+		const VertexData* vertexs = static_cast<const VertexData*>( data );
+		mPending.size = size;
+		mPending.vertexs.assign( vertexs, vertexs + size / stride );
+	}
+};
+
+static bool samePos( const Vector2f& a, const Vector2f& b ) {
+	return eeabs( a.x - b.x ) < 0.001f && eeabs( a.y - b.y ) < 0.001f;
+}
+
+static void testVertexsGrowth() {
+	RecordingRenderer renderer;
+	BatchRenderer* batch = BatchRenderer::New( 4 );
+	BatchRenderer::endFrameStats();
+
+	batch->setTexture( NULL );
+	batch->quadsBegin();
+	for ( int i = 0; i < 100; i++ ) {
+		batch->quadsSetColor( Color( i, 0, 0, 255 ) );
+		batch->batchQuad( i * 10, 0, 10, 10 );
+	}
+	batch->draw();
+
+	CHECK( renderer.draws.size() == 1, "growth: all the quads in one draw" );
+	if ( renderer.draws.size() == 1 ) {
+		const auto& draw = renderer.draws[0];
+		CHECK( draw.mode == PRIMITIVE_QUADS && draw.count == 400, "growth: draw call" );
+		CHECK( draw.vertexs.size() == 400, "growth: uploaded vertexs" );
+		bool sameVertexs = draw.vertexs.size() == 400;
+		for ( int i = 0; sameVertexs && i < 100; i++ ) {
+			const VertexData* quad = &draw.vertexs[i * 4];
+			sameVertexs = samePos( quad[0].pos, Vector2f( i * 10, 0 ) ) &&
+						  samePos( quad[2].pos, Vector2f( i * 10 + 10, 10 ) ) &&
+						  quad[0].color == Color( i, 0, 0, 255 ) &&
+						  quad[3].color == Color( i, 0, 0, 255 );
+		}
+		CHECK( sameVertexs, "growth: vertexs kept when the buffer is reallocated" );
+	}
+
+	const auto& stats = BatchRenderer::getFrameStats();
+	CHECK( stats.flushes == 1 && stats.getFlushes( BatchRenderer::FlushReason::Draw ) == 1,
+		   "growth: flush stats" );
+	CHECK( stats.vertexs == 400, "growth: vertexs stats" );
+
+	eeSAFE_DELETE( batch );
+}
+
+static void testFlushReasons() {
+	RecordingRenderer renderer;
+	BatchRenderer* batch = BatchRenderer::New( 64 );
+	GlobalBatchRenderer* global = GlobalBatchRenderer::instance();
+	BatchRenderer::endFrameStats();
+
+	batch->setTexture( NULL );
+	batch->setBlendMode( BlendMode::Alpha() );
+	batch->quadsBegin();
+	batch->batchQuad( 0, 0, 10, 10 );
+	batch->setBlendMode( BlendMode::Alpha() );
+	batch->batchQuad( 10, 0, 10, 10 );
+	batch->setBlendMode( BlendMode::Add() );
+	CHECK( renderer.draws.size() == 1, "reasons: only a different blend mode flushes" );
+
+	batch->batchQuad( 0, 0, 10, 10 );
+	batch->setTexture( NULL, Texture::CoordinateType::Pixels );
+
+	batch->batchQuad( 0, 0, 10, 10 );
+	batch->linesBegin();
+	batch->batchLine( 0, 0, 10, 10 );
+	batch->batchLine( 10, 10, 20, 0 );
+	batch->quadsBegin();
+
+	batch->setBatchForceRendering( true );
+	batch->batchQuad( 0, 0, 10, 10 );
+	batch->drawOpt();
+	batch->setBatchForceRendering( false );
+	batch->drawOpt();
+
+	global->setTexture( NULL );
+	global->quadsBegin();
+	global->batchQuad( 100, 100, 10, 10 );
+	batch->batchQuad( 0, 0, 10, 10 );
+	batch->draw();
+	batch->draw();
+
+	const auto& draws = renderer.draws;
+	CHECK( draws.size() == 7, "reasons: draw calls" );
+	if ( draws.size() == 7 ) {
+		CHECK( draws[0].count == 8 && draws[0].blend == BlendMode::Alpha(),
+			   "reasons: blend mode batch" );
+		CHECK( draws[1].count == 4 && draws[1].blend == BlendMode::Add(), "reasons: texture batch" );
+		CHECK( draws[2].count == 4 && draws[2].mode == PRIMITIVE_QUADS, "reasons: quads batch" );
+		CHECK( draws[3].count == 4 && draws[3].mode == PRIMITIVE_LINES, "reasons: lines batch" );
+		CHECK( draws[4].count == 4, "reasons: forced batch" );
+		CHECK( draws[5].count == 4 && samePos( draws[5].vertexs[0].pos, Vector2f( 100, 100 ) ),
+			   "reasons: the global batch is rendered first" );
+		CHECK( draws[6].count == 4 && samePos( draws[6].vertexs[0].pos, Vector2f( 0, 0 ) ),
+			   "reasons: batch after the global batch" );
+	}
+
+	const auto& stats = BatchRenderer::getFrameStats();
+	CHECK( stats.flushes == 7, "reasons: flushes" );
+	CHECK( stats.vertexs == 32, "reasons: vertexs" );
+	CHECK( stats.getFlushes( BatchRenderer::FlushReason::BlendMode ) == 1, "reasons: blend mode" );
+	CHECK( stats.getFlushes( BatchRenderer::FlushReason::Texture ) == 1, "reasons: texture" );
+	CHECK( stats.getFlushes( BatchRenderer::FlushReason::DrawMode ) == 2, "reasons: draw mode" );
+	CHECK( stats.getFlushes( BatchRenderer::FlushReason::ForceRendering ) == 1,
+		   "reasons: force rendering" );
+	CHECK( stats.getFlushes( BatchRenderer::FlushReason::Batcher ) == 1, "reasons: batcher" );
+	CHECK( stats.getFlushes( BatchRenderer::FlushReason::Draw ) == 1, "reasons: draw" );
+
+	BatchRenderer::endFrameStats();
+	CHECK( BatchRenderer::getLastFrameStats().flushes == 7 &&
+			   BatchRenderer::getFrameStats().flushes == 0,
+		   "reasons: frame stats closed" );
+
+	eeSAFE_DELETE( batch );
+}
+
+static void testQuadsAsTriangles() {
+	RecordingRenderer renderer;
+	renderer.setQuadsSupported( false );
+	BatchRenderer* batch = BatchRenderer::New( 8 );
+
+	batch->setTexture( NULL );
+	batch->quadsBegin();
+	for ( int i = 0; i < 3; i++ )
+		batch->batchQuad( i * 10, 0, 10, 10 );
+	batch->draw();
+
+	CHECK( renderer.draws.size() == 1 && renderer.draws[0].mode == PRIMITIVE_TRIANGLES &&
+			   renderer.draws[0].count == 18,
+		   "triangles: quads rendered as two triangles" );
+
+	eeSAFE_DELETE( batch );
+}
+
+static void testStreamingRing() {
+	const Uint32 capacity = 1024;
+	const int batches = 40;
+	RecordingRenderer renderer( true, capacity );
+	BatchRenderer* batch = BatchRenderer::New( 64 );
+
+	batch->setTexture( NULL );
+	batch->quadsBegin();
+	for ( int i = 0; i < batches; i++ ) {
+		batch->batchQuad( i, 0, 10, 10 );
+		batch->draw();
+	}
+
+	const auto& draws = renderer.draws;
+	CHECK( (int)draws.size() == batches, "ring: draw calls" );
+
+	Uint32 orphans = 0;
+	Uint32 end = 0;
+	bool validSlices = !draws.empty() && draws[0].slice.orphan && draws[0].slice.offset == 0;
+	for ( const auto& draw : draws ) {
+		validSlices = validSlices && draw.streamed && draw.slice.offset % 16 == 0 &&
+					  draw.slice.offset + draw.size <= capacity &&
+					  ( draw.slice.orphan ? draw.slice.offset == 0 : draw.slice.offset >= end );
+		orphans += draw.slice.orphan ? 1 : 0;
+		end = draw.slice.offset + draw.size;
+	}
+	CHECK( validSlices, "ring: slices don't overlap the previous ones" );
+
+	// The quads fill the buffer and it's orphaned every time the next one doesn't fit.
+	Uint32 quadSize = sizeof( VertexData ) * 4;
+	Uint32 alignedSize = ( ( quadSize + 15 ) / 16 ) * 16;
+	Uint32 perBuffer = ( capacity - quadSize ) / alignedSize + 1;
+	CHECK( orphans == ( batches + perBuffer - 1 ) / perBuffer && orphans > 1,
+		   "ring: wraps when full" );
+	CHECK( renderer.getRing().getOrphanCount() == orphans, "ring: orphan count" );
+
+	// A batch bigger than the buffer grows it.
+	for ( int i = 0; i < 100; i++ )
+		batch->batchQuad( i, 0, 10, 10 );
+	batch->draw();
+	CHECK( (int)draws.size() == batches + 1 && draws.back().slice.orphan &&
+			   draws.back().slice.offset == 0 &&
+			   renderer.getRing().getCapacity() >= draws.back().size &&
+			   draws.back().vertexs.size() == 400,
+		   "ring: grows for big batches" );
+
+	eeSAFE_DELETE( batch );
+}
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	testVertexsGrowth();
+	testFlushReasons();
+	testQuadsAsTriangles();
+	testStreamingRing();
+
+	GlobalBatchRenderer::destroySingleton();
+
+	std::cout << ( sFailures == 0 ? "All tests passed" : "Some tests failed" ) << std::endl;
+
+	return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,199 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+#include <random>
+
+// Checks that the draw reordering of the deferred GlobalBatchRenderer doesn't change the rendered
+// image. Every scene is rasterized by software twice: in the recorded order and in the order of the
+// merged groups, and both images must be identical.
+// Usage: eepp-batch-reorder-test [seed]
+
+static const int CANVAS_WIDTH = 320;
+static const int CANVAS_HEIGHT = 240;
+
+// The textures are solid colors, the texture pointer is only used as the batching key.
+static const Color TEXTURE_COLORS[] = { Color( 255, 255, 255, 255 ), Color( 230, 40, 40, 160 ),
+										Color( 40, 200, 60, 255 ),	 Color( 30, 60, 220, 90 ),
+										Color( 250, 200, 20, 200 ),	 Color( 120, 20, 160, 40 ) };
+static const int TEXTURE_COUNT = eeARRAY_SIZE( TEXTURE_COLORS );
+
+struct DrawList {
+	std::vector<VertexData> vertexs;
+	std::vector<GlobalBatchRenderer::DeferredCommand> commands;
+};
+
+static const Texture* getTexture( int index ) {
+	return index < 0 ? NULL : reinterpret_cast<const Texture*>( &TEXTURE_COLORS[index] );
+}
+
+static void addQuad( DrawList& scene, Float x, Float y, Float w, Float h, int texture,
+					 const BlendMode& blend, const Color& color = Color::White ) {
+	GlobalBatchRenderer::DeferredCommand state;
+	state.texture = getTexture( texture );
+	state.blend = blend;
+
+	// Consecutive quads with the same state are batched in the same command, as the batch
+	// renderer does.
+	if ( scene.commands.empty() || !scene.commands.back().sameState( state ) ) {
+		state.start = scene.vertexs.size();
+		state.bounds = Rectf( x, y, x + w, y + h );
+		scene.commands.push_back( state );
+	} else {
+		scene.commands.back().bounds.expand( Rectf( x, y, x + w, y + h ) );
+	}
+
+	Vector2f points[4] = { { x, y }, { x, y + h }, { x + w, y + h }, { x + w, y } };
+
+	for ( int i = 0; i < 4; i++ ) {
+		VertexData vertex;
+		vertex.pos = points[i];
+		vertex.color = color;
+		scene.vertexs.push_back( vertex );
+	}
+
+	scene.commands.back().numVertex += 4;
+}
+
+static Color getQuadColor( const GlobalBatchRenderer::DeferredCommand& command,
+						   const VertexData& vertex ) {
+	if ( NULL == command.texture )
+		return vertex.color;
+
+	const Color& texel = *reinterpret_cast<const Color*>( command.texture );
+	return Color( texel.r * vertex.color.r / 255, texel.g * vertex.color.g / 255,
+				  texel.b * vertex.color.b / 255, texel.a * vertex.color.a / 255 );
+}
+
+// Fills the pixels whose center is inside the quad, with the half-open ranges of the GL
+// rasterization rules (shared edges are never drawn twice).
+static void rasterizeQuad( std::vector<Color>& canvas, const VertexData* vertexs,
+						   const GlobalBatchRenderer::DeferredCommand& command ) {
+	Rectf rect( vertexs[0].pos.x, vertexs[0].pos.y, vertexs[0].pos.x, vertexs[0].pos.y );
+
+	for ( int i = 1; i < 4; i++ )
+		rect.expand( vertexs[i].pos );
+
+	Color src( getQuadColor( command, vertexs[0] ) );
+	int x0 = eemax( 0, (int)eeceil( rect.Left - 0.5f ) );
+	int x1 = eemin( CANVAS_WIDTH, (int)eeceil( rect.Right - 0.5f ) );
+	int y0 = eemax( 0, (int)eeceil( rect.Top - 0.5f ) );
+	int y1 = eemin( CANVAS_HEIGHT, (int)eeceil( rect.Bottom - 0.5f ) );
+
+	for ( int y = y0; y < y1; y++ ) {
+		for ( int x = x0; x < x1; x++ ) {
+			Color& dst = canvas[y * CANVAS_WIDTH + x];
+
+			if ( command.blend == BlendMode::Add() ) {
+				dst = Color( eemin( 255, dst.r + src.r * src.a / 255 ),
+							 eemin( 255, dst.g + src.g * src.a / 255 ),
+							 eemin( 255, dst.b + src.b * src.a / 255 ), eemin( 255, dst.a + src.a ) );
+			} else {
+				dst = Color( ( src.r * src.a + dst.r * ( 255 - src.a ) ) / 255,
+							 ( src.g * src.a + dst.g * ( 255 - src.a ) ) / 255,
+							 ( src.b * src.a + dst.b * ( 255 - src.a ) ) / 255,
+							 eemin( 255, src.a + dst.a * ( 255 - src.a ) / 255 ) );
+			}
+		}
+	}
+}
+
+static void rasterizeCommand( std::vector<Color>& canvas, const DrawList& scene,
+							  const GlobalBatchRenderer::DeferredCommand& command ) {
+	for ( Uint32 v = 0; v < command.numVertex; v += 4 )
+		rasterizeQuad( canvas, &scene.vertexs[command.start + v], command );
+}
+
+static bool runScene( const std::string& name, const DrawList& scene ) {
+	std::vector<GlobalBatchRenderer::DeferredGroup> groups;
+	std::vector<Color> recorded( CANVAS_WIDTH * CANVAS_HEIGHT, Color::Black );
+	std::vector<Color> reordered( CANVAS_WIDTH * CANVAS_HEIGHT, Color::Black );
+
+	for ( const auto& command : scene.commands )
+		rasterizeCommand( recorded, scene, command );
+
+	GlobalBatchRenderer::groupCommands( scene.commands, groups );
+
+	for ( const auto& group : groups )
+		for ( const auto& index : group.commands )
+			rasterizeCommand( reordered, scene, scene.commands[index] );
+
+	size_t diff = 0;
+	for ( size_t i = 0; i < recorded.size(); i++ )
+		if ( recorded[i] != reordered[i] )
+			diff++;
+
+	std::cout << String::format( "  %-22s %6zu quads | %6zu draws -> %5zu draws | %s", name.c_str(),
+								 scene.vertexs.size() / 4, scene.commands.size(), groups.size(),
+								 diff == 0 ? "identical"
+										   : String::format( "%zu pixels differ", diff ).c_str() )
+			  << std::endl;
+
+	return diff == 0;
+}
+
+// Rows of text over icons and solid backgrounds: the texture changes on every widget.
+static DrawList createUIScene( std::mt19937& rng ) {
+	DrawList scene;
+	std::uniform_int_distribution<int> glyphs( 3, 12 );
+
+	for ( int row = 0; row < 24; row++ ) {
+		for ( int col = 0; col < 4; col++ ) {
+			Float x = col * 80;
+			Float y = row * 10;
+			addQuad( scene, x, y, 80, 10, -1, BlendMode::Alpha(), Color( 40, 40, 40, 255 ) );
+			addQuad( scene, x + 1, y + 1, 8, 8, 2 + ( row + col ) % 2, BlendMode::Alpha() );
+
+			int count = glyphs( rng );
+			for ( int g = 0; g < count; g++ )
+				addQuad( scene, x + 10 + g * 5.5f, y + 1.5f, 5.5f, 7, 0, BlendMode::Alpha() );
+		}
+	}
+
+	return scene;
+}
+
+// Random quads of every size, texture and blend mode, most of them overlapping.
+static DrawList createOverdrawScene( std::mt19937& rng ) {
+	DrawList scene;
+	std::uniform_real_distribution<Float> pos( -20, CANVAS_WIDTH );
+	std::uniform_real_distribution<Float> size( 1, 120 );
+	std::uniform_int_distribution<int> texture( -1, TEXTURE_COUNT - 1 );
+	std::uniform_int_distribution<int> blend( 0, 3 );
+
+	for ( int i = 0; i < 3000; i++ )
+		addQuad( scene, pos( rng ), pos( rng ) * 0.75f, size( rng ), size( rng ), texture( rng ),
+				 blend( rng ) == 0 ? BlendMode::Add() : BlendMode::Alpha(),
+				 Color( 255, 255, 255, 128 + texture( rng ) * 20 ) );
+
+	return scene;
+}
+
+// Small quads on a half pixel grid, many of them sharing edges.
+static DrawList createEdgesScene( std::mt19937& rng ) {
+	DrawList scene;
+	std::uniform_int_distribution<int> cell( 0, 40 );
+	std::uniform_int_distribution<int> texture( 0, TEXTURE_COUNT - 1 );
+
+	for ( int i = 0; i < 4000; i++ )
+		addQuad( scene, cell( rng ) * 7.5f, cell( rng ) * 5.5f, 7.5f, 5.5f, texture( rng ),
+				 BlendMode::Alpha() );
+
+	return scene;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	Uint32 seed = argc > 1 ? std::atoi( argv[1] ) : 1;
+	std::mt19937 rng( seed );
+	bool success = true;
+
+	std::cout << "Batch reordering with seed " << seed << std::endl;
+
+	for ( int i = 0; i < 4; i++ ) {
+		success &= runScene( "ui", createUIScene( rng ) );
+		success &= runScene( "overdraw", createOverdrawScene( rng ) );
+		success &= runScene( "shared edges", createEdgesScene( rng ) );
+	}
+
+	std::cout << ( success ? "OK" : "FAILED" ) << std::endl;
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
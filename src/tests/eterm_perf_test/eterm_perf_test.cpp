@@ -0,0 +1,207 @@
+#include <eepp/ee.hpp>
+#include <eterm/terminal/terminalemulator.hpp>
+#include <iostream>
+#include <random>
+
+using namespace eterm::Terminal;
+
+// Measures the throughput of the terminal emulator input path: the streams are fed through a fake
+// pseudo terminal in chunks of the size of a real tty read, and parsed as the terminal does in
+// every update. The hash of the screen and the scrollback is printed to compare the results of
+// two builds.
+// Usage: eepp-eterm-perf-test [megabytes per stream] [recorded stream files...]
+
+static const int COLUMNS = 120;
+static const int ROWS = 40;
+static const size_t TTY_READ_SIZE = 4096;
+
+class BenchPseudoTerminal : public IPseudoTerminal {
+  public:
+	explicit BenchPseudoTerminal( const std::string& data ) : mData( data ) {}
+
+	virtual int getNumColumns() const { return COLUMNS; }
+
+	virtual int getNumRows() const { return ROWS; }
+
+	virtual bool resize( int, int ) { return true; }
+
+	virtual bool isTTY() const { return true; }
+
+	virtual int write( const char*, size_t n ) { return (int)n; }
+
+	virtual int read( char* buf, size_t n, bool ) {
+		size_t size = eemin( eemin( n, TTY_READ_SIZE ), mData.size() - mPos );
+		memcpy( buf, mData.data() + mPos, size );
+		mPos += size;
+		return (int)size;
+	}
+
+	bool isEmpty() const { return mPos == mData.size(); }
+
+  protected:
+	const std::string& mData;
+	size_t mPos{ 0 };
+};
+
+class BenchProcess : public eterm::System::IProcess {
+  public:
+	virtual void checkExitStatus() {}
+
+	virtual bool hasExited() const { return false; }
+
+	virtual int getExitCode() const { return 0; }
+
+	virtual void terminate() {}
+
+	virtual void waitForExit() {}
+};
+
+class BenchDisplay : public ITerminalDisplay {
+  public:
+	virtual bool drawBegin( Uint32, Uint32 ) { return true; }
+
+	virtual void drawLine( Line line, int x1, int, int x2 ) {
+		for ( int x = x1; x < x2; x++ )
+			mLinesHash = hashGlyph( mLinesHash, line[x] );
+	}
+
+	virtual void drawCursor( int, int, TerminalGlyph, int, int, TerminalGlyph ) {}
+
+	virtual void drawEnd() {}
+
+	static Uint64 hashGlyph( Uint64 hash, const TerminalGlyph& glyph ) {
+		Uint64 values[] = { glyph.u, glyph.mode, glyph.fg, glyph.bg };
+		for ( const auto& value : values )
+			hash = ( hash ^ value ) * 1099511628211ULL;
+		return hash;
+	}
+
+	Uint64 mLinesHash{ 14695981039346656037ULL };
+};
+
+static std::string createLsStream( std::mt19937& rng, size_t size ) {
+	static const char* exts[] = { "cpp", "hpp", "txt", "png", "lua", "md" };
+	std::string data;
+	std::uniform_int_distribution<int> dist( 0, 99999 );
+
+	while ( data.size() < size ) {
+		data += String::format( "\r\n./src/module%d/dir%d:\r\ntotal %d\r\n", dist( rng ) % 50,
+								dist( rng ) % 100, dist( rng ) );
+		for ( int i = 0; i < 20; i++ )
+			data += String::format( "-rw-r--r-- 1 user group %8d Jan %2d 10:%02d file_%d.%s\r\n",
+									dist( rng ), 1 + dist( rng ) % 28, dist( rng ) % 60,
+									dist( rng ), exts[dist( rng ) % eeARRAY_SIZE( exts )] );
+	}
+
+	return data;
+}
+
+static std::string createBuildStream( std::mt19937& rng, size_t size ) {
+	std::string data;
+	std::uniform_int_distribution<int> dist( 0, 99999 );
+
+	while ( data.size() < size ) {
+		int file = dist( rng );
+		data += String::format( "\033[1m[%3d%%]\033[0m \033[32mBuilding CXX object "
+								"src/CMakeFiles/eepp.dir/module/file_%d.cpp.o\033[0m\r\n",
+								dist( rng ) % 100, file );
+		if ( file % 8 == 0 )
+			data += String::format(
+				"\033[1msrc/module/file_%d.cpp:%d:%d: \033[35mwarning: \033[0m\033[1munused "
+				"variable ‘value’ [\033[35m-Wunused-variable\033[0m\033[1m]\033[0m\r\n"
+				"  %d |     int value = 0;\r\n      |         \033[35m^~~~~\033[0m\r\n",
+				file, dist( rng ) % 500, dist( rng ) % 80, dist( rng ) % 500 );
+	}
+
+	return data;
+}
+
+// Cursor movements, scroll regions, erases, the DEC graphics charset, insert mode and wide
+// characters, as the full screen applications and vttest do.
+static std::string createVtStream( std::mt19937& rng, size_t size ) {
+	std::string data;
+	std::uniform_int_distribution<int> dist( 0, 99999 );
+
+	while ( data.size() < size ) {
+		data += String::format( "\033[%d;%dH\033[K", 1 + dist( rng ) % ROWS,
+								1 + dist( rng ) % COLUMNS );
+		switch ( dist( rng ) % 6 ) {
+			case 0:
+				data += "\033(0lqqqqqqqqqqqqqqqqqqqqk\033(B";
+				break;
+			case 1:
+				data += String::format( "\033[%d;%dr\033[%dS\033[r", 1 + dist( rng ) % 10,
+										20 + dist( rng ) % 20, 1 + dist( rng ) % 3 );
+				break;
+			case 2:
+				data += "\033[4hinserted text\033[4l";
+				break;
+			case 3:
+				data += "漢字のテキスト 😀 ñandú";
+				break;
+			case 4:
+				data += String::format( "\033[38;2;%d;%d;%dm\033[48;5;%dm colored \033[0m",
+										dist( rng ) % 256, dist( rng ) % 256, dist( rng ) % 256,
+										dist( rng ) % 256 );
+				break;
+			default:
+				data += "The quick brown fox jumps over the lazy dog\r\n";
+				break;
+		}
+	}
+
+	return data;
+}
+
+static void runStream( const std::string& name, const std::string& data ) {
+	auto display = std::make_shared<BenchDisplay>();
+	auto pty = std::make_unique<BenchPseudoTerminal>( data );
+	BenchPseudoTerminal* ptyPtr = pty.get();
+	auto terminal =
+		TerminalEmulator::create( std::move( pty ), std::make_unique<BenchProcess>(), display );
+
+	Clock clock;
+	while ( !ptyPtr->isEmpty() )
+		terminal->update();
+	double ms = clock.getElapsedTime().asMilliseconds();
+
+	display->mLinesHash = 14695981039346656037ULL;
+	terminal->redraw();
+	Uint64 hash = display->mLinesHash;
+	const TerminalHistory& history = terminal->getHistory();
+	for ( size_t i = 0; i < history.size(); i++ ) {
+		Line line = history.getLine( i, COLUMNS );
+		for ( int x = 0; x < COLUMNS; x++ )
+			hash = BenchDisplay::hashGlyph( hash, line[x] );
+	}
+
+	std::cout << String::format( "  %-16s %8.2f MB %10.2f ms %10.2f MB/s   hash %016llx",
+								 name.c_str(), data.size() / 1048576.0, ms,
+								 data.size() / 1048576.0 / ( ms / 1000.0 ),
+								 (unsigned long long)hash )
+			  << std::endl;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	size_t size = ( argc > 1 ? std::atoi( argv[1] ) : 32 ) * 1024 * 1024;
+	std::mt19937 rng( 1 );
+
+	std::cout << "Terminal input throughput, " << COLUMNS << "x" << ROWS << std::endl;
+
+	if ( argc > 2 ) {
+		for ( int i = 2; i < argc; i++ ) {
+			std::string data;
+			if ( FileSystem::fileGet( argv[i], data ) )
+				runStream( FileSystem::fileNameFromPath( argv[i] ), data );
+			else
+				std::cerr << "Couldn't read " << argv[i] << std::endl;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	runStream( "ls -lR", createLsStream( rng, size ) );
+	runStream( "colorized build", createBuildStream( rng, size ) );
+	runStream( "vttest", createVtStream( rng, size ) );
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <eepp/ee.hpp>
+#include <iostream>
+#include <random>
+
+using namespace EE::UI::Doc;
+
+// Checks LineWidthIndex against a plain vector of widths after random edits: widths changed,
+// lines inserted and lines removed, comparing the widest line and the lines wider than a width.
+// Usage: eepp-line-width-index-test [iterations]
+
+static int sFailures = 0;
+
+#define CHECK( cond, msg )                                                   \
+	if ( !( cond ) ) {                                                       \
+		std::cerr << "FAILED: " << msg << " (" << #cond << ")" << std::endl; \
+		sFailures++;                                                         \
+	}
+
+static bool sameAsBruteForce( const LineWidthIndex& index, const std::vector<Float>& widths ) {
+	if ( index.size() != widths.size() )
+		return false;
+
+	for ( size_t i = 0; i < widths.size(); i++ )
+		if ( index.getWidth( i ) != widths[i] )
+			return false;
+
+	Float maxWidth = widths.empty() ? 0 : *std::max_element( widths.begin(), widths.end() );
+	if ( index.getMaxWidth() != maxWidth )
+		return false;
+
+	Float half = maxWidth / 2;
+	size_t wider = std::count_if( widths.begin(), widths.end(),
+								  [half]( const Float& width ) { return width > half; } );
+	return index.countLinesWiderThan( half ) == wider;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	int iterations = argc > 1 ? std::atoi( argv[1] ) : 20000;
+	std::mt19937 rng( 1234 );
+	LineWidthIndex index;
+	std::vector<Float> widths;
+
+	index.reset( 100 );
+	widths.assign( 100, 0 );
+	CHECK( sameAsBruteForce( index, widths ), "reset to zero width lines" );
+
+	int firstFailure = -1;
+	for ( int i = 0; i < iterations; i++ ) {
+		int op = rng() % 4;
+		Int64 line = widths.empty() ? 0 : rng() % ( widths.size() + 1 );
+		Int64 count = 1 + rng() % 8;
+
+		if ( op <= 1 && line < (Int64)widths.size() ) {
+			/* A few distinct widths so many lines share the same width */
+			Float width = ( rng() % 64 ) * 7.5f;
+			index.setWidth( line, width );
+			widths[line] = width;
+		} else if ( op == 2 || widths.size() < 10 ) {
+			index.insertLines( line, count );
+			widths.insert( widths.begin() + line, count, 0 );
+		} else if ( line < (Int64)widths.size() ) {
+			index.removeLines( line, count );
+			widths.erase( widths.begin() + line,
+						  widths.begin() + std::min<Int64>( line + count, widths.size() ) );
+		}
+
+		if ( firstFailure == -1 && !sameAsBruteForce( index, widths ) )
+			firstFailure = i;
+	}
+	CHECK( firstFailure == -1,
+		   "the index matches the brute force widths (first failure at " << firstFailure << ")" );
+
+	index.removeLines( 0, index.size() );
+	widths.clear();
+	CHECK( sameAsBruteForce( index, widths ) && index.empty(), "all the lines removed" );
+
+	std::cout << ( sFailures == 0 ? "All tests passed" : "Some tests failed" ) << std::endl;
+
+	return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
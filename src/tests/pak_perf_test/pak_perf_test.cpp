@@ -0,0 +1,145 @@
+#include <atomic>
+#include <eepp/ee.hpp>
+#include <iostream>
+#include <thread>
+
+// Benchmarks the concurrent reads from a pak file: extracts and decodes the textures of a pak
+// with 1, 4 and 16 loader threads.
+// Usage: eepp-pak-perf-test [textures count]
+
+static std::vector<std::string> createImages( const std::string& tempPath, size_t count ) {
+	std::vector<std::string> images;
+
+	for ( size_t i = 0; i < count; i++ ) {
+		Image image( 64, 64, 4 );
+
+		for ( Uint32 y = 0; y < 64; y++ )
+			for ( Uint32 x = 0; x < 64; x++ )
+				image.setPixel( x, y, Color( x * 4, y * 4, ( i * 16 ) % 256, 255 ) );
+
+		std::string path( tempPath + String::format( "eepp-pak-perf-test-%zu.png", i ) );
+		image.saveToFile( path, Image::SaveType::SAVE_TYPE_PNG );
+
+		std::string data;
+		FileSystem::fileGet( path, data );
+		FileSystem::fileRemove( path );
+		images.emplace_back( std::move( data ) );
+	}
+
+	return images;
+}
+
+// Pak::addFile rewrites the whole directory for every file added, so the pak is written in one
+// pass.
+static bool createPak( const std::string& path, const std::vector<std::string>& images,
+					   size_t count ) {
+	IOStreamFile file( path, "wb" );
+
+	if ( !file.isOpen() )
+		return false;
+
+	Uint32 dataSize = 0;
+	for ( size_t i = 0; i < count; i++ )
+		dataSize += images[i % images.size()].size();
+
+	Uint32 header[3];
+	memcpy( &header[0], "PACK", 4 );
+	header[1] = 12 + dataSize;
+	header[2] = count * 64;
+	file.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+
+	std::vector<char> entries( count * 64, 0 );
+	Uint32 position = 12;
+
+	for ( size_t i = 0; i < count; i++ ) {
+		const std::string& image = images[i % images.size()];
+		std::string name( String::format( "textures/%zu/texture-%zu.png", i / 1000, i ) );
+		char* entry = &entries[i * 64];
+		Uint32 length = image.size();
+		memcpy( entry, name.c_str(), eemin<size_t>( name.size(), 55 ) );
+		memcpy( entry + 56, &position, 4 );
+		memcpy( entry + 60, &length, 4 );
+		file.write( image.c_str(), image.size() );
+		position += length;
+	}
+
+	file.write( entries.data(), entries.size() );
+
+	return true;
+}
+
+static double runThreads( size_t numThreads, size_t count,
+						  const std::function<void( size_t )>& load ) {
+	std::atomic<size_t> next( 0 );
+	std::vector<std::thread> threads;
+	Clock clock;
+
+	for ( size_t t = 0; t < numThreads; t++ ) {
+		threads.emplace_back( [&] {
+			size_t i;
+			while ( ( i = next.fetch_add( 1 ) ) < count )
+				load( i );
+		} );
+	}
+
+	for ( auto& thread : threads )
+		thread.join();
+
+	return clock.getElapsedTime().asMilliseconds();
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	size_t count = argc > 1 ? std::atoi( argv[1] ) : 10000;
+	std::string pakPath( Sys::getTempPath() + "eepp-pak-perf-test.pak" );
+
+	if ( !createPak( pakPath, createImages( Sys::getTempPath(), 16 ), count ) ) {
+		std::cout << "Couldn't create " << pakPath << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Pak* pak = Pak::New();
+
+	if ( !pak->open( pakPath ) ) {
+		std::cout << "Couldn't open " << pakPath << std::endl;
+		eeSAFE_DELETE( pak );
+		return EXIT_FAILURE;
+	}
+
+	Uint32 viewSize = 0;
+	std::cout << "Loading " << count << " textures from "
+			  << FileSystem::sizeToString( FileSystem::fileSize( pakPath ) ) << " pak. "
+			  << ( NULL != pak->getFileView( "textures/0/texture-0.png", viewSize )
+					   ? "Memory mapped."
+					   : "Positional reads." )
+			  << std::endl;
+
+	for ( size_t numThreads : { 1, 4, 16 } ) {
+		std::atomic<size_t> bytes( 0 );
+		std::atomic<size_t> decoded( 0 );
+
+		double extractMs = runThreads( numThreads, count, [&]( size_t i ) {
+			ScopedBuffer buffer;
+			if ( pak->extractFileToMemory(
+					 String::format( "textures/%zu/texture-%zu.png", i / 1000, i ), buffer ) )
+				bytes += buffer.length();
+		} );
+
+		double decodeMs = runThreads( numThreads, count, [&]( size_t i ) {
+			Image image( pak, String::format( "textures/%zu/texture-%zu.png", i / 1000, i ) );
+			if ( image.getPixelsPtr() != NULL )
+				decoded++;
+		} );
+
+		std::cout << String::format( "  %2zu threads | extract: %8.2f ms (%s) | extract + decode: "
+									 "%8.2f ms (%zu textures)",
+									 numThreads, extractMs,
+									 FileSystem::sizeToString( bytes.load() ).c_str(), decodeMs,
+									 decoded.load() )
+				  << std::endl;
+	}
+
+	eeSAFE_DELETE( pak );
+	FileSystem::fileRemove( pakPath );
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+#include "projectsearchindex.hpp"
+#include <algorithm>
+#include <eepp/ee.hpp>
+#include <iostream>
+
+using namespace ecode;
+
+// Checks the ecode project search index: the candidates of a search after the files are added,
+// modified, renamed and removed while the index is ready (a file that is not indexed yet must
+// always be a candidate), that a cancelled index is not synced anymore and that a persisted index
+// gives the same candidates once loaded.
+// Usage: eepp-project-search-index-test
+
+static int sFailures = 0;
+
+#define CHECK( cond, msg )                                                   \
+	if ( !( cond ) ) {                                                       \
+		std::cerr << "FAILED: " << msg << " (" << #cond << ")" << std::endl; \
+		sFailures++;                                                         \
+	}
+
+static std::string sPath;
+
+static std::string writeFile( const std::string& name, const std::string& data ) {
+	std::string path( sPath + name );
+	FileSystem::makeDir( FileSystem::fileRemoveFileName( path ), true );
+	FileSystem::fileWrite( path, data );
+	return path;
+}
+
+static std::vector<std::string> candidates( const ProjectSearchIndex& index,
+											const std::string& text ) {
+	std::vector<std::string> files;
+	if ( !index.findCandidates( text, true, files ) )
+		return { "<not narrowed>" };
+	std::vector<std::string> names;
+	for ( const auto& file : files )
+		names.emplace_back( file.substr( sPath.size() ) );
+	std::sort( names.begin(), names.end() );
+	return names;
+}
+
+typedef std::vector<std::string> Names;
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	sPath = Sys::getTempPath() + "eepp-project-search-index-test" + FileSystem::getOSSlash();
+	FileSystem::makeDir( sPath, true );
+
+	std::vector<std::string> files{ writeFile( "a.txt", "hello world" ),
+									writeFile( "b.txt", "other content" ) };
+	std::string cachePath( sPath + "cache" + FileSystem::getOSSlash() + "index.idx" );
+
+	{
+		ProjectSearchIndex index( cachePath );
+		CHECK( !index.isReady(), "not ready before the sync" );
+		index.sync( files );
+		CHECK( index.isReady(), "ready after the sync" );
+		CHECK( candidates( index, "hello" ) == Names{ "a.txt" }, "initial candidates" );
+		CHECK( candidates( index, "missing" ) == Names{}, "no candidates" );
+
+		// A new file is a candidate of every search until it's indexed.
+		std::string c( writeFile( "c.txt", "hello again" ) );
+		index.invalidateFile( c );
+		CHECK( candidates( index, "other" ) == ( Names{ "b.txt", "c.txt" } ),
+			   "not indexed file is a candidate" );
+		index.updateFile( c );
+		CHECK( candidates( index, "hello" ) == ( Names{ "a.txt", "c.txt" } ), "new file indexed" );
+		CHECK( candidates( index, "other" ) == Names{ "b.txt" }, "new file discarded" );
+
+		// The files of a new directory.
+		std::string d1( writeFile( "dir/d1.txt", "hello from dir" ) );
+		std::string d2( writeFile( "dir/d2.txt", "nothing" ) );
+		index.invalidateFile( d1 );
+		index.invalidateFile( d2 );
+		CHECK( candidates( index, "content" ) == ( Names{ "b.txt", "dir/d1.txt", "dir/d2.txt" } ),
+			   "new directory files are candidates" );
+		index.updateFile( d1 );
+		index.updateFile( d2 );
+		CHECK( candidates( index, "hello" ) == ( Names{ "a.txt", "c.txt", "dir/d1.txt" } ),
+			   "new directory indexed" );
+
+		// A modified file.
+		writeFile( "a.txt", "goodbye world" );
+		index.invalidateFile( files[0] );
+		CHECK( candidates( index, "goodbye" ) == Names{ "a.txt" }, "modified file is a candidate" );
+		index.updateFile( files[0] );
+		CHECK( candidates( index, "hello" ) == ( Names{ "c.txt", "dir/d1.txt" } ),
+			   "modified file indexed" );
+
+		// Renamed and removed files.
+		FileSystem::fileRemove( c );
+		std::string e( writeFile( "e.txt", "hello again" ) );
+		index.renameFile( c, e );
+		CHECK( candidates( index, "hello" ) == ( Names{ "dir/d1.txt", "e.txt" } ), "renamed file" );
+		index.removeFile( e );
+		CHECK( candidates( index, "hello" ) == Names{ "dir/d1.txt" }, "removed file" );
+		index.removeDirectory( sPath + "dir" + FileSystem::getOSSlash() );
+		CHECK( candidates( index, "hello" ) == Names{}, "removed directory" );
+		CHECK( index.getFilesCount() == 2, "files count" );
+
+		CHECK( index.save(), "index saved" );
+	}
+
+	{
+		ProjectSearchIndex index( cachePath );
+		index.sync( files );
+		CHECK( candidates( index, "goodbye" ) == Names{ "a.txt" }, "loaded candidates" );
+		CHECK( candidates( index, "content" ) == Names{ "b.txt" }, "loaded candidates" );
+		CHECK( !index.isDirty(), "nothing changed since the index was saved" );
+
+		// A cancelled index is not synced again.
+		index.cancel();
+		std::vector<std::string> moreFiles( files );
+		moreFiles.emplace_back( writeFile( "f.txt", "goodbye" ) );
+		index.sync( moreFiles );
+		CHECK( !index.hasFile( moreFiles.back() ), "cancelled index is not synced" );
+	}
+
+	for ( const auto& name : { "a.txt", "b.txt", "e.txt", "f.txt", "dir/d1.txt", "dir/d2.txt", "dir",
+							   "cache/index.idx", "cache", "" } )
+		FileSystem::fileRemove( sPath + name );
+
+	std::cout << ( sFailures == 0 ? "All tests passed" : "Some tests failed" ) << std::endl;
+
+	return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
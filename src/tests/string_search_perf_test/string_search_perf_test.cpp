@@ -0,0 +1,106 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+
+// Benchmarks String::BMH over the source files of a directory tree.
+// Usage: eepp-string-search-perf-test [path] [iterations]
+
+static void loadFiles( std::string path, std::vector<std::string>& files, size_t& totalSize ) {
+	FileSystem::dirAddSlashAtEnd( path );
+	auto list = FileSystem::filesGetInPath( path, false, false, true );
+	for ( const auto& file : list ) {
+		std::string filePath( path + file );
+		if ( FileSystem::isDirectory( filePath ) ) {
+			loadFiles( filePath, files, totalSize );
+		} else {
+			std::string ext( FileSystem::fileExtension( filePath ) );
+			if ( ext != "cpp" && ext != "hpp" && ext != "c" && ext != "h" && ext != "lua" &&
+				 ext != "md" && ext != "xml" && ext != "css" )
+				continue;
+			std::string data;
+			if ( FileSystem::fileGet( filePath, data ) && !data.empty() ) {
+				totalSize += data.size();
+				files.emplace_back( std::move( data ) );
+			}
+		}
+	}
+}
+
+static size_t countMatches( const std::vector<std::string>& files, const std::string& needle,
+							bool caseSensitive ) {
+	const auto occ = caseSensitive ? String::BMH::createOccTable(
+										 (const unsigned char*)needle.c_str(), needle.size() )
+								   : String::BMH::createCaseInsensitiveOccTable(
+										 (const unsigned char*)needle.c_str(), needle.size() );
+	size_t count = 0;
+	for ( const auto& file : files ) {
+		const unsigned char* data = (const unsigned char*)file.c_str();
+		size_t pos = 0;
+		while ( pos < file.size() ) {
+			size_t res =
+				caseSensitive
+					? String::BMH::search( data + pos, file.size() - pos,
+										   (const unsigned char*)needle.c_str(), needle.size(),
+										   occ )
+					: String::BMH::searchCaseInsensitive( data + pos, file.size() - pos,
+														  (const unsigned char*)needle.c_str(),
+														  needle.size(), occ );
+			if ( res == file.size() - pos )
+				break;
+			count++;
+			pos += res + needle.size();
+		}
+	}
+	return count;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	std::string path( argc > 1 ? argv[1] : Sys::getProcessPath() + "../../src" );
+	int iterations = argc > 2 ? std::atoi( argv[2] ) : 5;
+	std::vector<std::string> files;
+	size_t totalSize = 0;
+	loadFiles( path, files, totalSize );
+
+	if ( files.empty() ) {
+		std::cout << "No files found in " << path << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Searching " << files.size() << " files, " << FileSystem::sizeToString( totalSize )
+			  << ". Best kernel: "
+			  << String::BMH::getKernelName( String::BMH::getBestKernel() ) << std::endl;
+
+	const std::vector<std::string> needles = { "if", "String", "return", "nullptr",
+											   "getElapsedTime", "std::vector<std::string>" };
+	const std::vector<String::BMH::Kernel> kernels = {
+		String::BMH::Kernel::Scalar, String::BMH::Kernel::SSE2, String::BMH::Kernel::AVX2 };
+
+	for ( int caseSensitive = 1; caseSensitive >= 0; caseSensitive-- ) {
+		std::cout << std::endl
+				  << ( caseSensitive ? "Case sensitive" : "Case insensitive" ) << std::endl;
+		for ( const auto& needle : needles ) {
+			std::string search( needle );
+			if ( !caseSensitive )
+				String::toLowerInPlace( search );
+			std::cout << "  \"" << search << "\"";
+			size_t expected = 0;
+			for ( const auto& kernel : kernels ) {
+				if ( String::BMH::setKernel( kernel ) != kernel )
+					continue;
+				size_t count = 0;
+				Clock clock;
+				for ( int i = 0; i < iterations; i++ )
+					count = countMatches( files, search, caseSensitive );
+				double ms = clock.getElapsedTime().asMilliseconds() / iterations;
+				if ( kernel == String::BMH::Kernel::Scalar )
+					expected = count;
+				std::cout << String::format( " | %s: %.2f ms (%.0f MiB/s)%s",
+											 String::BMH::getKernelName( kernel ), ms,
+											 totalSize / ( 1024.0 * 1024.0 ) / ( ms / 1000.0 ),
+											 count != expected ? " MISMATCH" : "" );
+			}
+			std::cout << " | " << expected << " matches" << std::endl;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+#include <random>
+
+using namespace EE::UI::Doc;
+
+// Checks that the background tokenization of the SyntaxHighlighter produces the same tokens as
+// the synchronous one: while the document is edited, after the syntax definition changes with a
+// job running, and that it only tokenizes up to the wanted line.
+// Usage: eepp-syntax-highlighter-test [seed]
+
+static int sFailures = 0;
+
+#define CHECK( cond, msg )                                                   \
+	if ( !( cond ) ) {                                                       \
+		std::cerr << "FAILED: " << msg << " (" << #cond << ")" << std::endl; \
+		sFailures++;                                                         \
+	}
+
+class HighlighterClient : public TextDocument::Client {
+  public:
+	HighlighterClient( TextDocument& doc, SyntaxHighlighter& highlighter ) :
+		mDoc( doc ), mHighlighter( highlighter ) {
+		mDoc.registerClient( this );
+	}
+
+	~HighlighterClient() { mDoc.unregisterClient( this ); }
+
+	virtual void onDocumentTextChanged( const DocumentContentChange& change ) {
+		mHighlighter.onDocumentTextChanged( change );
+	}
+	virtual void onDocumentUndoRedo( const TextDocument::UndoRedo& ) {}
+	virtual void onDocumentCursorChange( const TextPosition& ) {}
+	virtual void onDocumentSelectionChange( const TextRange& ) {}
+	virtual void onDocumentLineCountChange( const size_t&, const size_t& ) {}
+	virtual void onDocumentLineChanged( const Int64& ) {}
+	virtual void onDocumentSaved( TextDocument* ) {}
+	virtual void onDocumentClosed( TextDocument* ) {}
+	virtual void onDocumentDirtyOnFileSystem( TextDocument* ) {}
+	virtual void onDocumentMoved( TextDocument* ) {}
+
+  protected:
+	TextDocument& mDoc;
+	SyntaxHighlighter& mHighlighter;
+};
+
+static std::string createSource( std::mt19937& rng, int lines ) {
+	static const char* snippets[] = { "int value = 0; // comment",
+									  "/* a comment that continues",
+									  "   in the next line */ return value;",
+									  "const char* str = \"text \\\" escaped\";",
+									  "#include <vector>",
+									  "for ( auto& it : list ) { it++; }",
+									  "R\"(raw string",
+									  ")\";",
+									  "-- lua comment --[[ block",
+									  "]] local x = 'a'" };
+	std::uniform_int_distribution<int> dist( 0, eeARRAY_SIZE( snippets ) - 1 );
+	std::string data;
+	for ( int i = 0; i < lines; i++ ) {
+		data += snippets[dist( rng )];
+		data += '\n';
+	}
+	return data;
+}
+
+static bool waitTokenized( TextDocument& doc, SyntaxHighlighter& highlighter ) {
+	Clock clock;
+	while ( highlighter.getFirstInvalidLine() < (Int64)doc.linesCount() ) {
+		highlighter.updateDirty();
+		if ( clock.getElapsedTime() > Seconds( 30 ) )
+			return false;
+		Sys::sleep( Milliseconds( 1 ) );
+	}
+	return true;
+}
+
+static bool sameTokens( TextDocument& doc, SyntaxHighlighter& highlighter ) {
+	SyntaxHighlighter reference( &doc );
+	reference.changeDoc( &doc );
+	while ( reference.getFirstInvalidLine() < (Int64)doc.linesCount() )
+		reference.updateDirty( 1000 );
+
+	for ( size_t i = 0; i < doc.linesCount(); i++ ) {
+		const auto& expected = reference.getLine( i );
+		const auto& tokens = highlighter.getLine( i );
+		if ( expected.size() != tokens.size() ) {
+			std::cerr << "  line " << i << ": " << tokens.size() << " tokens, expected "
+					  << expected.size() << std::endl;
+			return false;
+		}
+		for ( size_t t = 0; t < tokens.size(); t++ ) {
+			if ( tokens[t].type != expected[t].type || tokens[t].pos != expected[t].pos ||
+				 tokens[t].len != expected[t].len ) {
+				std::cerr << "  line " << i << ": token " << t << " differs" << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	std::mt19937 rng( argc > 1 ? std::atoi( argv[1] ) : 1 );
+	std::shared_ptr<ThreadPool> pool = ThreadPool::createShared( 2 );
+	const SyntaxDefinition& cpp = SyntaxDefinitionManager::instance()->getByLanguageName( "C++" );
+	const SyntaxDefinition& lua = SyntaxDefinitionManager::instance()->getByLanguageName( "Lua" );
+
+	std::string source( createSource( rng, 20000 ) );
+	TextDocument doc( false );
+	doc.loadFromMemory( (const Uint8*)source.c_str(), source.size() );
+	doc.setSyntaxDefinition( cpp );
+
+	SyntaxHighlighter highlighter( &doc );
+	HighlighterClient client( doc, highlighter );
+	highlighter.setThreadPool( pool );
+	highlighter.changeDoc( &doc );
+
+	CHECK( waitTokenized( doc, highlighter ), "initial tokenization timed out" );
+	CHECK( sameTokens( doc, highlighter ), "initial tokenization" );
+
+	// Edits while the jobs are running, they can open or close comments in the middle of a job.
+	static const char* edits[] = { "/* ", " */", "\"", "R\"(", ")\"", "x" };
+	std::uniform_int_distribution<size_t> dist( 0, SIZE_MAX );
+	for ( int i = 0; i < 50; i++ ) {
+		Int64 line = dist( rng ) % doc.linesCount();
+		doc.insert( 0, { line, 0 }, edits[dist( rng ) % eeARRAY_SIZE( edits )] );
+		if ( i % 5 == 0 )
+			doc.insert( 0, { line, 0 }, "\n\n" );
+		highlighter.updateDirty();
+	}
+	CHECK( waitTokenized( doc, highlighter ), "tokenization after edits timed out" );
+	CHECK( sameTokens( doc, highlighter ), "tokenization after edits" );
+
+	// The syntax changes while a job is running, nothing tokenized with the old definition can
+	// be published.
+	for ( int i = 0; i < 20; i++ ) {
+		doc.setSyntaxDefinition( i % 2 == 0 ? lua : cpp );
+		highlighter.changeDoc( &doc );
+		highlighter.updateDirty();
+		Sys::sleep( Milliseconds( dist( rng ) % 3 ) );
+	}
+	CHECK( waitTokenized( doc, highlighter ), "tokenization after syntax change timed out" );
+	CHECK( sameTokens( doc, highlighter ), "tokenization after syntax change" );
+
+	// Only the lines up to the wanted line are tokenized.
+	SyntaxHighlighter partial( &doc );
+	partial.setThreadPool( pool );
+	partial.getLine( 100 );
+	Clock clock;
+	while ( clock.getElapsedTime() < Milliseconds( 200 ) ) {
+		partial.updateDirty();
+		Sys::sleep( Milliseconds( 1 ) );
+	}
+	CHECK( partial.getFirstInvalidLine() == 101, "tokenization up to the wanted line" );
+
+	std::cout << ( sFailures == 0 ? "All tests passed" : "Some tests failed" ) << std::endl;
+
+	return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,128 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+#include <random>
+
+using namespace EE::UI::Doc;
+
+// Measures the throughput of SyntaxTokenizer::tokenize with every syntax definition registered in
+// the SyntaxDefinitionManager. The corpus is a generated C++ and JSON source (always the same for
+// the same size) or the files passed as arguments, tokenized line by line as the highlighter
+// does. The hash of the tokens is printed to compare the results of two builds.
+// Usage: eepp-syntax-tokenizer-perf-test [megabytes] [files...]
+
+static std::string createCppCorpus( std::mt19937& rng, size_t size ) {
+	std::uniform_int_distribution<int> dist( 0, 99999 );
+	std::string data;
+
+	while ( data.size() < size ) {
+		int id = dist( rng );
+		data += String::format(
+			"#include <eepp/module%d.hpp>\n"
+			"/* Returns the value of the item %d,\n * the value is cached. */\n"
+			"static const std::vector<std::string> sNames%d = { \"name\", \"value\\n\" };\n"
+			"int Module%d::getValue( const size_t& index ) const {\n"
+			"\tif ( index >= mItems.size() ) // out of bounds\n"
+			"\t\treturn -1;\n"
+			"\tfloat scale = %d.%df * 0x%X;\n"
+			"\treturn mItems[index].value + (int)scale + '%c';\n"
+			"}\n\n",
+			id % 50, id, id, id, dist( rng ) % 100, dist( rng ) % 100, dist( rng ),
+			'a' + dist( rng ) % 26 );
+	}
+
+	return data;
+}
+
+static std::string createJsonCorpus( std::mt19937& rng, size_t size ) {
+	std::uniform_int_distribution<int> dist( 0, 99999 );
+	std::string data( "[\n" );
+
+	while ( data.size() < size ) {
+		data += String::format( "  {\n    \"id\": %d,\n    \"name\": \"item \\\"%d\\\"\",\n"
+								"    \"enabled\": %s,\n    \"ratio\": %d.%d,\n"
+								"    \"tags\": [ \"a\", \"b\", null ]\n  },\n",
+								dist( rng ), dist( rng ), dist( rng ) % 2 ? "true" : "false",
+								dist( rng ) % 10, dist( rng ) % 1000 );
+	}
+
+	return data + "  {}\n]\n";
+}
+
+static std::vector<std::string> splitLines( const std::string& data ) {
+	std::vector<std::string> lines;
+	size_t start = 0;
+	while ( start < data.size() ) {
+		size_t end = data.find( '\n', start );
+		end = end == std::string::npos ? data.size() : end + 1;
+		lines.emplace_back( data.substr( start, end - start ) );
+		start = end;
+	}
+	return lines;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	size_t size = ( argc > 1 ? std::atoi( argv[1] ) : 2 ) * 1024 * 1024;
+	std::mt19937 rng( 1 );
+	std::vector<std::pair<std::string, std::vector<std::string>>> corpora;
+
+	if ( argc > 2 ) {
+		for ( int i = 2; i < argc; i++ ) {
+			std::string data;
+			if ( FileSystem::fileGet( argv[i], data ) )
+				corpora.push_back( { FileSystem::fileNameFromPath( argv[i] ), splitLines( data ) } );
+			else
+				std::cerr << "Couldn't read " << argv[i] << std::endl;
+		}
+	} else {
+		corpora.push_back( { "C++", splitLines( createCppCorpus( rng, size / 2 ) ) } );
+		corpora.push_back( { "JSON", splitLines( createJsonCorpus( rng, size / 2 ) ) } );
+	}
+
+	size_t corpusSize = 0;
+	for ( const auto& corpus : corpora )
+		for ( const auto& line : corpus.second )
+			corpusSize += line.size();
+
+	auto* manager = SyntaxDefinitionManager::instance();
+	std::vector<std::string> languages( manager->getLanguageNames() );
+
+	std::cout << "Tokenizing " << FileSystem::sizeToString( corpusSize ) << " with "
+			  << languages.size() << " syntax definitions" << std::endl;
+
+	Uint64 hash = 14695981039346656037ULL;
+	double totalMs = 0;
+
+	for ( const auto& language : languages ) {
+		const SyntaxDefinition& syntax = manager->getByLanguageName( language );
+		size_t tokens = 0;
+		Clock clock;
+
+		for ( const auto& corpus : corpora ) {
+			Uint32 state = SYNTAX_TOKENIZER_STATE_NONE;
+			for ( const auto& line : corpus.second ) {
+				auto res = SyntaxTokenizer::tokenize( syntax, line, state );
+				state = res.second;
+				tokens += res.first.size();
+				for ( const auto& token : res.first ) {
+					Uint64 values[] = { token.type, token.pos, token.len };
+					for ( const auto& value : values )
+						hash = ( hash ^ value ) * 1099511628211ULL;
+				}
+			}
+		}
+
+		double ms = clock.getElapsedTime().asMilliseconds();
+		totalMs += ms;
+		std::cout << String::format( "  %-20s %10.2f ms %10.2f MB/s %10zu tokens",
+									 language.c_str(), ms,
+									 corpusSize / 1048576.0 / ( ms / 1000.0 ), tokens )
+				  << std::endl;
+	}
+
+	std::cout << String::format( "Total: %.2f ms, %.2f MB/s, hash %016llx", totalMs,
+								 corpusSize * languages.size() / 1048576.0 / ( totalMs / 1000.0 ),
+								 (unsigned long long)hash )
+			  << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,52 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+
+using namespace EE::UI::Doc;
+
+// Checks that the tokens returned by SyntaxTokenizer::tokenize reference only the text of their
+// span: the tokens cover the whole text when nothing is skipped, and the subsyntax separators
+// skipped do not end up inside a token merged with the text around them.
+// Usage: eepp-syntax-tokenizer-test
+
+static int sFailures = 0;
+
+#define CHECK( cond, msg )                                                   \
+	if ( !( cond ) ) {                                                       \
+		std::cerr << "FAILED: " << msg << " (" << #cond << ")" << std::endl; \
+		sFailures++;                                                         \
+	}
+
+static std::string tokensText( const std::string& text, const std::vector<SyntaxToken>& tokens ) {
+	std::string str;
+	for ( const auto& token : tokens )
+		str.append( text, token.pos, token.len );
+	return str;
+}
+
+static bool sortedSpans( const std::vector<SyntaxToken>& tokens ) {
+	for ( size_t i = 1; i < tokens.size(); i++ )
+		if ( tokens[i - 1].pos + tokens[i - 1].len > tokens[i].pos )
+			return false;
+	return true;
+}
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	const SyntaxDefinition& markdown =
+		SyntaxDefinitionManager::instance()->getByLanguageName( "Markdown" );
+	std::string text( "Some text ```cpp\nint value = 1;\n``` more text\n" );
+
+	auto res = SyntaxTokenizer::tokenize( markdown, text, SYNTAX_TOKENIZER_STATE_NONE );
+	CHECK( sortedSpans( res.first ), "tokens are sorted and do not overlap" );
+	CHECK( tokensText( text, res.first ) == text, "tokens cover the whole text" );
+
+	res = SyntaxTokenizer::tokenize( markdown, text, SYNTAX_TOKENIZER_STATE_NONE, 0, true );
+	std::string skipped( tokensText( text, res.first ) );
+	CHECK( sortedSpans( res.first ), "tokens skipping separators are sorted and do not overlap" );
+	CHECK( skipped.find( "```" ) == std::string::npos, "skipped separators are not in the tokens" );
+	CHECK( skipped == "Some text \nint value = 1;\n more text\n",
+		   "the text without the separators is kept" );
+
+	std::cout << ( sFailures == 0 ? "All tests passed" : "Some tests failed" ) << std::endl;
+
+	return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,147 @@
+#include <eepp/ee.hpp>
+#include <eterm/terminal/terminalhistory.hpp>
+#include <iostream>
+
+using namespace eterm::Terminal;
+
+// Checks the terminal scrollback encoding: the wrap flag of a wrapped line, the padding of the
+// lines decoded with more columns, the lines of the compressed pages and the search columns with
+// wide glyphs.
+// Usage: eepp-terminal-history-test
+
+static int sFailures = 0;
+
+#define CHECK( cond, msg )                                                   \
+	if ( !( cond ) ) {                                                       \
+		std::cerr << "FAILED: " << msg << " (" << #cond << ")" << std::endl; \
+		sFailures++;                                                         \
+	}
+
+static std::vector<TerminalGlyph> makeLine( const String& text, int columns, uint32_t bg = 0 ) {
+	std::vector<TerminalGlyph> line( columns );
+	int x = 0;
+	for ( size_t i = 0; i < text.size() && x < columns; i++ ) {
+		line[x].u = text[i];
+		line[x].bg = bg;
+		/* The CJK glyphs used by the test are wide, followed by a dummy glyph as the terminal
+		 * emulator writes them */
+		if ( text[i] >= 0x3000 && x + 1 < columns ) {
+			line[x].mode |= ATTR_WIDE;
+			line[++x].u = '\0';
+			line[x].mode = ATTR_WDUMMY;
+			line[x].bg = bg;
+		}
+		x++;
+	}
+	for ( ; x < columns; x++ ) {
+		line[x].u = ' ';
+		line[x].bg = bg;
+	}
+	return line;
+}
+
+static bool sameLine( Line a, const std::vector<TerminalGlyph>& b ) {
+	for ( size_t i = 0; i < b.size(); i++ )
+		if ( a[i].u != b[i].u || a[i].mode != b[i].mode || a[i].fg != b[i].fg ||
+			 a[i].bg != b[i].bg )
+			return false;
+	return true;
+}
+
+static void testWrapAndPadding() {
+	TerminalHistory history( 100 );
+
+	auto wrapped = makeLine( "wrapped line", 80, 5 );
+	wrapped[79].mode |= ATTR_WRAP;
+	history.push( wrapped.data(), 80 );
+
+	Line line = history.getLine( 0, 100 );
+	CHECK( line[0].u == 'w' && line[11].u == 'e', "wrapped line text" );
+	CHECK( ( line[79].mode & ATTR_WRAP ) != 0, "the last glyph keeps the wrap flag" );
+
+	bool padding = true;
+	for ( int x = 80; x < 100; x++ )
+		padding = padding && line[x].u == ' ' && line[x].bg == 5 && line[x].mode == 0;
+	CHECK( padding, "the padding keeps the colors but not the wrap flag" );
+
+	auto plain = makeLine( "plain", 80, 7 );
+	history.push( plain.data(), 80 );
+	line = history.getLine( 1, 100 );
+	padding = true;
+	for ( int x = 5; x < 100; x++ )
+		padding = padding && line[x].u == ' ' && line[x].bg == 7 && line[x].mode == 0;
+	CHECK( padding, "the trailing blanks are restored as padding" );
+
+	line = history.getLine( 1, 3 );
+	CHECK( line[0].u == 'p' && line[2].u == 'a', "a line decoded with less columns is clipped" );
+}
+
+static void testCompression() {
+	TerminalHistory history( 10000 );
+	std::vector<std::vector<TerminalGlyph>> lines;
+
+	for ( int i = 0; i < 2000; i++ ) {
+		lines.push_back( makeLine( String::format( "line %d: 世界 %d", i, i * 7 ), 80, i % 8 ) );
+		history.push( lines.back().data(), 80 );
+	}
+
+	size_t uncompressedUsage = history.getMemoryUsage();
+	history.setCompression( true );
+	CHECK( history.getMemoryUsage() < uncompressedUsage, "compression reduces the memory usage" );
+
+	bool same = true;
+	for ( size_t i = 0; i < lines.size(); i++ )
+		same = same && sameLine( history.getLine( i, 80 ), lines[i] );
+	CHECK( same, "the lines of the compressed pages are the same" );
+
+	for ( int i = 0; i < 600; i++ ) {
+		lines.push_back( makeLine( String::format( "more %d", i ), 80 ) );
+		history.push( lines.back().data(), 80 );
+	}
+	history.pop();
+	lines.pop_back();
+
+	history.setCompression( false );
+	same = history.size() == lines.size();
+	for ( size_t i = 0; same && i < lines.size(); i++ )
+		same = sameLine( history.getLine( i, 80 ), lines[i] );
+	CHECK( same, "the lines are the same after uncompressing the pages" );
+}
+
+static void testSearch() {
+	TerminalHistory history( 100 );
+	std::vector<std::string> texts = { "first line", "Hello world", "你好 world", "a 世界 b 世界",
+									   "last line" };
+	for ( const auto& text : texts ) {
+		auto line = makeLine( String::fromUtf8( text ), 40 );
+		history.push( line.data(), 40 );
+	}
+
+	auto res = history.search( "world", 4 );
+	CHECK( res.line == 2 && res.column == 5, "backwards search after the wide glyphs" );
+
+	res = history.search( "world", 0, false );
+	CHECK( res.line == 1 && res.column == 6, "forward search" );
+
+	res = history.search( "HELLO", 4, true, false );
+	CHECK( res.line == 1 && res.column == 0, "case insensitive search" );
+
+	res = history.search( "你好", 4 );
+	CHECK( res.line == 2 && res.column == 0, "wide text is found" );
+
+	res = history.search( "b 世界", 4 );
+	CHECK( res.line == 3 && res.column == 7, "wide text column is counted in cells" );
+
+	res = history.search( "missing", 4 );
+	CHECK( res.line == -1, "missing text is not found" );
+}
+
+EE_MAIN_FUNC int main( int, char*[] ) {
+	testWrapAndPadding();
+	testCompression();
+	testSearch();
+
+	std::cout << ( sFailures == 0 ? "All tests passed" : "Some tests failed" ) << std::endl;
+
+	return sFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
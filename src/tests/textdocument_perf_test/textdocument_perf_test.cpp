@@ -0,0 +1,105 @@
+#include <eepp/ee.hpp>
+#include <iostream>
+#include <random>
+
+using namespace EE::UI::Doc;
+
+// Measures the TextDocument storage with a big generated file: the load time, the memory used by
+// the lines, the latency of random edits and of pasting a block of lines in the middle of the
+// document (compared with inserting the pasted lines one by one, as it was done before).
+// Usage: eepp-textdocument-perf-test [megabytes] [edits]
+
+static std::string createFile( std::mt19937& rng, size_t size ) {
+	static const char* words[] = { "return", "value", "std::vector<int>", "if", "else", "mSize",
+								   "const", "auto", "nullptr", "for", "while", "getText()" };
+	std::uniform_int_distribution<int> dist( 0, 99999 );
+	std::string data;
+	data.reserve( size + 256 );
+
+	while ( data.size() < size ) {
+		int indent = dist( rng ) % 4;
+		data.append( indent, '\t' );
+		int count = dist( rng ) % 12;
+		for ( int i = 0; i < count; i++ ) {
+			data += words[dist( rng ) % eeARRAY_SIZE( words )];
+			data += ' ';
+		}
+		data += '\n';
+	}
+
+	return data;
+}
+
+static size_t linesMemoryUsage( TextDocument& doc ) {
+	size_t usage = doc.lines().capacity() * sizeof( TextDocumentLine );
+	for ( const auto& line : doc.lines() )
+		usage += line.getText().capacity() * sizeof( String::StringBaseType );
+	return usage;
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	size_t size = ( argc > 1 ? std::atoi( argv[1] ) : 64 ) * 1024 * 1024;
+	int edits = argc > 2 ? std::atoi( argv[2] ) : 1000;
+	std::mt19937 rng( 1 );
+
+	std::string path( Sys::getTempPath() + "eepp-textdocument-perf-test.txt" );
+	std::string data( createFile( rng, size ) );
+	if ( !FileSystem::fileWrite( path, data ) ) {
+		std::cerr << "Couldn't write " << path << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	TextDocument doc;
+	Clock clock;
+	if ( doc.loadFromFile( path ) != TextDocument::LoadStatus::Loaded ) {
+		std::cerr << "Couldn't load " << path << std::endl;
+		FileSystem::fileRemove( path );
+		return EXIT_FAILURE;
+	}
+	double loadMs = clock.getElapsedTime().asMilliseconds();
+	FileSystem::fileRemove( path );
+
+	size_t memory = linesMemoryUsage( doc );
+	std::cout << String::format( "Load: %s, %zu lines, %.2f ms, lines memory %s (%.1fx the file)",
+								 FileSystem::sizeToString( data.size() ).c_str(),
+								 doc.linesCount(), loadMs,
+								 FileSystem::sizeToString( memory ).c_str(),
+								 (double)memory / data.size() )
+			  << std::endl;
+
+	std::uniform_int_distribution<size_t> dist( 0, SIZE_MAX );
+	clock.restart();
+	for ( int i = 0; i < edits; i++ ) {
+		Int64 line = dist( rng ) % doc.linesCount();
+		Int64 column = dist( rng ) % eemax<size_t>( 1, doc.line( line ).size() );
+		doc.insert( 0, { line, column }, "x" );
+	}
+	std::cout << String::format( "Random char inserts: %.4f ms per edit",
+								 clock.getElapsedTime().asMilliseconds() / edits )
+			  << std::endl;
+
+	const int pasteLines = 100;
+	String paste;
+	for ( int i = 0; i < pasteLines; i++ )
+		paste += "pasted line of text\n";
+
+	int pastes = eemax( 1, edits / 100 );
+	clock.restart();
+	for ( int i = 0; i < pastes; i++ )
+		doc.insert( 0, { (Int64)doc.linesCount() / 2, 0 }, paste );
+	std::cout << String::format( "Paste %d lines in the middle: %.4f ms per paste", pasteLines,
+								 clock.getElapsedTime().asMilliseconds() / pastes )
+			  << std::endl;
+
+	// Every line inserted shifts all the lines below it, so it's measured only once.
+	auto& lines = doc.lines();
+	size_t pos = lines.size() / 2;
+	clock.restart();
+	for ( int l = 0; l < pasteLines; l++ )
+		lines.insert( lines.begin() + pos + l, TextDocumentLine( "pasted line of text\n" ) );
+	std::cout << String::format( "  inserting the lines one by one: %.4f ms per paste",
+								 clock.getElapsedTime().asMilliseconds() )
+			  << std::endl;
+
+	return EXIT_SUCCESS;
+}
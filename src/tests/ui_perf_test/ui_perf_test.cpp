@@ -103,6 +103,48 @@ class TestModel : public Model {
 
 EE::Window::Window* win = NULL;
 
+// Reloads the theme on a tree of 10k widgets, matching the styles in the main thread and then in
+// parallel. Press F9 to run it.
+static void themeReloadBenchmark( UISceneNode* uiSceneNode ) {
+	UITheme* theme = uiSceneNode->getUIThemeManager()->getDefaultTheme();
+	if ( NULL == theme )
+		return;
+
+	const size_t widgetsCount = 10000;
+	const size_t rowWidgets = 100;
+	const int iterations = 5;
+	auto* container = UILinearLayout::NewVertical();
+	container->setVisible( false );
+	for ( size_t count = 0; count < widgetsCount; count += rowWidgets ) {
+		auto* row = UILinearLayout::NewHorizontal();
+		row->setParent( container );
+		for ( size_t i = 1; i < rowWidgets; i++ ) {
+			UIWidget* widget = i % 2 ? (UIWidget*)UITextView::New() : UIWidget::New();
+			widget->addClass( i % 3 ? "odd" : "even" );
+			widget->setParent( row );
+		}
+	}
+	SceneManager::instance()->update();
+
+	std::shared_ptr<ThreadPool> prevPool = uiSceneNode->getThreadPool();
+	std::shared_ptr<ThreadPool> pool =
+		ThreadPool::createShared( eemax<int>( 2, Sys::getCPUCount() ) );
+
+	for ( const auto& curPool : { std::shared_ptr<ThreadPool>(), pool } ) {
+		uiSceneNode->setThreadPool( curPool );
+		Clock clock;
+		for ( int i = 0; i < iterations; i++ )
+			uiSceneNode->setStyleSheet( theme->getStyleSheet() );
+		Log::notice( "Theme reload with %zu widgets (%s): %.2f ms", widgetsCount,
+					 curPool ? String::format( "%d threads", curPool->numThreads() ).c_str()
+							 : "main thread",
+					 clock.getElapsedTime().asMilliseconds() / iterations );
+	}
+
+	uiSceneNode->setThreadPool( prevPool );
+	container->close();
+}
+
 void mainLoop() {
 	win->getInput()->update();
 
@@ -125,6 +167,10 @@ void mainLoop() {
 		uiSceneNode->setDrawDebugData( !uiSceneNode->getDrawDebugData() );
 	}
 
+	if ( win->getInput()->isKeyUp( KEY_F9 ) ) {
+		themeReloadBenchmark( uiSceneNode );
+	}
+
 	// Update the UI scene.
 	SceneManager::instance()->update();
 
@@ -400,6 +400,7 @@ void App::loadConfig( const LogLevel& logLevel, const Sizeu& displaySize ) {
 #else
 	Log::create( mConfigPath + "ecode.log", logLevel, true, true );
 #endif
+	Log::instance()->setAsync( true );
 
 	initPluginManager();
 
@@ -1623,6 +1624,7 @@ void App::onCodeEditorCreated( UICodeEditor* editor, TextDocument& doc ) {
 	editor->setAutoCloseXMLTags( config.autoCloseXMLTags );
 	editor->setLineSpacing( config.lineSpacing );
 	editor->setCursorBlinkTime( config.cursorBlinkingTime );
+	editor->setSyntaxHighlighterThreadPool( mThreadPool );
 	doc.setAutoCloseBrackets( !mConfig.editor.autoCloseBrackets.empty() );
 	doc.setAutoCloseBracketsPairs( makeAutoClosePairs( mConfig.editor.autoCloseBrackets ) );
 	doc.setLineEnding( docc.windowsLineEndings ? TextDocument::LineEnding::CRLF
@@ -2259,6 +2261,7 @@ void App::init( const LogLevel& logLevel, std::string file, const Float& pidelDe
 			eemax( mWindow->getScale(), mConfig.windowState.pixelDensity ) );
 
 		mUISceneNode = UISceneNode::New();
+		mUISceneNode->setThreadPool( mThreadPool );
 		mUIColorScheme = mConfig.ui.colorScheme;
 		if ( !colorScheme.empty() ) {
 			mUIColorScheme =
@@ -109,6 +109,8 @@ class App : public UICodeEditorSplitter::Client {
 
 	const std::string& resPath() const { return mResPath; }
 
+	const std::string& getConfigPath() const { return mConfigPath; }
+
 	Font* getTerminalFont() const { return mTerminalFont; }
 
 	Font* getFontMono() const { return mFontMono; }
@@ -66,6 +66,8 @@ void FileSystemListener::handleFileAction( efsw::WatchID, const std::string& dir
 			}
 		}
 		case efsw::Actions::Modified: {
+			if ( action == efsw::Actions::Modified && mDirTree )
+				mDirTree.get()->onChange( ProjectDirectoryTree::Action::Modified, file, "" );
 			if ( file.isLink() )
 				file = FileInfo( file.linksTo() );
 			if ( isFileOpen( file ) )
@@ -426,19 +426,34 @@ void GlobalSearchController::doGlobalSearch( String text, bool caseSensitive, bo
 		if ( escapeSequence )
 			text.unescape();
 		std::string search( text.toUtf8() );
+		// Only one search runs at a time, the previous one is not needed anymore.
+		if ( mSearchCancel )
+			*mSearchCancel = true;
+		ProjectSearch::CancelFlag cancel = std::make_shared<std::atomic<bool>>( false );
+		mSearchCancel = cancel;
+		// The results are displayed while they are found, the model is filled incrementally.
+		auto model = ProjectSearch::asModel( {} );
 		ProjectSearch::find(
-			mApp->getDirTree()->getFiles(), search,
+			mApp->getDirTree()->getSearchCandidates( search, caseSensitive, luaPattern ), search,
 #if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN || defined( __EMSCRIPTEN_PTHREADS__ )
 			mApp->getThreadPool(),
 #endif
-			[&, clock, search, loader, searchReplace,
-			 searchAgain]( const ProjectSearch::Result& res ) {
+			[&, clock, search, loader, searchReplace, searchAgain, model,
+			 cancel]( const ProjectSearch::Result& res ) {
 				Log::info( "Global search for \"%s\" took %.2fms", search.c_str(),
 						   clock->getElapsedTime().asMilliseconds() );
 				eeDelete( clock );
 				mUISceneNode->runOnMainThread( [&, loader, res, search, searchReplace, searchAgain,
-												escapeSequence] {
-					auto model = ProjectSearch::asModel( res );
+												escapeSequence, model, cancel] {
+					if ( *cancel ) {
+						loader->setVisible( false );
+						loader->close();
+						return;
+					}
+
+					if ( model->getResult().size() != res.size() )
+						model->setResult( res );
+
 					auto listBox = mGlobalSearchHistoryList->getListBox();
 
 					if ( !searchAgain ) {
@@ -481,7 +496,25 @@ void GlobalSearchController::doGlobalSearch( String text, bool caseSensitive, bo
 			},
 			caseSensitive, wholeWord,
 			luaPattern ? TextDocument::FindReplaceType::LuaPattern
-					   : TextDocument::FindReplaceType::Normal );
+					   : TextDocument::FindReplaceType::Normal,
+			[&, search, searchReplace, escapeSequence, model,
+			 cancel]( const ProjectSearch::Result& res ) {
+				mUISceneNode->runOnMainThread(
+					[&, res, search, searchReplace, escapeSequence, model, cancel] {
+						if ( *cancel )
+							return;
+						model->addResults( res );
+						if ( mGlobalSearchTree->getModel() != model.get() ) {
+							updateGlobalSearchBarResults( search, model, searchReplace,
+														  escapeSequence );
+						} else {
+							mGlobalSearchLayout->findByClass<UITextView>( "search_total" )
+								->setText( String::format( "%zu matches found.",
+														   model->resultCount() ) );
+						}
+					} );
+			},
+			cancel );
 	}
 }
 
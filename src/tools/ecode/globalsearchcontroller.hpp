@@ -77,6 +77,7 @@ class GlobalSearchController {
 	Uint32 mGlobalSearchHistoryOnItemSelectedCb{ 0 };
 	std::deque<std::pair<std::string, std::shared_ptr<ProjectSearch::ResultModel>>>
 		mGlobalSearchHistory;
+	ProjectSearch::CancelFlag mSearchCancel;
 
 	void onLoadDone( const Variant& lineNum, const Variant& colNum );
 };
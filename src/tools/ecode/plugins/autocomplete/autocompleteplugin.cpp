@@ -6,6 +6,8 @@
 #include <eepp/system/luapattern.hpp>
 #include <eepp/ui/uiscenenode.hpp>
 #include <nlohmann/json.hpp>
+#include <string_view>
+#include <unordered_set>
 using namespace EE::Graphics;
 using namespace EE::System;
 using json = nlohmann::json;
@@ -41,12 +43,17 @@ static AutoCompletePlugin::SymbolsList
 fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& symbolsVec,
 				   const std::string& match, const size_t& max ) {
 	AutoCompletePlugin::SymbolsList matches;
+	std::unordered_set<std::string_view> matched;
+	Uint64 matchMask = AutoCompletePlugin::getCharMask( match );
 	matches.reserve( max );
 	int score;
 	for ( const auto& symbols : symbolsVec ) {
 		for ( const auto& symbol : *symbols ) {
+			// A symbol without all the characters of the match can't match.
+			if ( symbol.charMask && ( symbol.charMask & matchMask ) != matchMask )
+				continue;
 			if ( ( score = String::fuzzyMatch( symbol.text, match ) ) > 0 ) {
-				if ( std::find( matches.begin(), matches.end(), symbol ) == matches.end() ) {
+				if ( matched.insert( symbol.text ).second ) {
 					symbol.setScore( score );
 					matches.push_back( symbol );
 				}
@@ -66,6 +73,16 @@ fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& sy
 	return matches;
 }
 
+Uint64 AutoCompletePlugin::getCharMask( const std::string& text ) {
+	Uint64 mask = 0;
+	for ( const char& ch : text ) {
+		int lower = std::tolower( static_cast<unsigned char>( ch ) );
+		if ( lower != ' ' )
+			mask |= 1ULL << ( lower % 64 );
+	}
+	return mask;
+}
+
 UICodeEditorPlugin* AutoCompletePlugin::New( PluginManager* pluginManager ) {
 	return eeNew( AutoCompletePlugin, ( pluginManager ) );
 }
@@ -92,6 +109,8 @@ AutoCompletePlugin::~AutoCompletePlugin() {
 			editor.first->removeEventListener( listener );
 		editor.first->unregisterPlugin( this );
 	}
+	for ( const auto& docCache : mDocCache )
+		docCache.second.index->detach();
 }
 
 void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
@@ -109,7 +128,7 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 			const DocEvent* docEvent = static_cast<const DocEvent*>( event );
 			TextDocument* doc = docEvent->getDoc();
 			mDocs.erase( doc );
-			mDocCache.erase( doc );
+			removeDocCache( doc );
 			mDirty = true;
 		} ) );
 
@@ -119,7 +138,7 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 			TextDocument* newDoc = editor->getDocumentRef().get();
 			Lock l( mDocMutex );
 			mDocs.erase( oldDoc );
-			mDocCache.erase( oldDoc );
+			removeDocCache( oldDoc );
 			mEditorDocs[editor] = newDoc;
 			mDirty = true;
 		} ) );
@@ -178,7 +197,7 @@ void AutoCompletePlugin::onUnregister( UICodeEditor* editor ) {
 		if ( editor.second == doc )
 			return;
 	mDocs.erase( doc );
-	mDocCache.erase( doc );
+	removeDocCache( doc );
 	mDirty = true;
 }
 
@@ -389,56 +408,96 @@ void AutoCompletePlugin::updateDocCache( TextDocument* doc ) {
 		mDocsUpdating[doc] = true;
 	}
 	Clock clock;
-	std::unordered_map<TextDocument*, DocCache>::iterator docCache;
+	std::shared_ptr<DocumentSymbolIndex> index;
+	std::string langName;
 	{
 		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
-		if ( docCache == mDocCache.end() || mClosing )
-			return;
+		auto docCache = mDocCache.find( doc );
+		if ( docCache != mDocCache.end() && !mClosing ) {
+			index = docCache->second.index;
+			langName = docCache->second.langName;
+		}
 	}
 
-	auto changeId = doc->getCurrentChangeId();
-	auto symbols = getDocumentSymbols( doc );
+	if ( index ) {
+		std::vector<std::string> added;
+		std::vector<std::string> removed;
+		index->update( mSymbolPattern, added, removed, mClosing );
+
+		if ( !added.empty() || !removed.empty() ) {
+			Lock l( mLangSymbolsMutex );
+			auto& lang = mLangCache[langName];
+			for ( const auto& symbol : added )
+				lang.docsCount[symbol]++;
+			removeLangSymbols( lang, removed );
+			updateLangSymbols( lang );
+		}
 
-	{
-		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
-		if ( docCache == mDocCache.end() || mClosing )
-			return;
-		auto& cache = docCache->second;
-		cache.changeId = changeId;
-		cache.symbols = std::move( symbols );
+		Log::debug( "Dictionary for %s updated in: %.2fms", doc->getFilename().c_str(),
+					clock.getElapsedTime().asMilliseconds() );
 	}
 
-	std::string langName( doc->getSyntaxDefinition().getLanguageName() );
-	{
-		Lock l( mLangSymbolsMutex );
-		auto& lang = mLangCache[langName];
-		lang.clear();
-		Lock l2( mDocMutex );
-		for ( const auto& d : mDocCache ) {
-			if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-				lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
-		}
-	}
-	Log::debug( "Dictionary for %s updated in: %.2fms", doc->getFilename().c_str(),
-				clock.getElapsedTime().asMilliseconds() );
 	{
 		Lock lu( mDocsUpdatingMutex );
 		mDocsUpdating[doc] = false;
 	}
 }
 
+void AutoCompletePlugin::removeDocCache( TextDocument* doc ) {
+	auto docCache = mDocCache.find( doc );
+	if ( docCache == mDocCache.end() )
+		return;
+	std::vector<std::string> symbols( docCache->second.index->getSymbols() );
+	std::string langName( docCache->second.langName );
+	docCache->second.index->detach();
+	mDocCache.erase( docCache );
+
+	Lock l( mLangSymbolsMutex );
+	auto lang = mLangCache.find( langName );
+	if ( lang != mLangCache.end() && !symbols.empty() ) {
+		removeLangSymbols( lang->second, symbols );
+		updateLangSymbols( lang->second );
+	}
+}
+
+void AutoCompletePlugin::removeLangSymbols( LangCache& lang,
+											const std::vector<std::string>& symbols ) {
+	for ( const auto& symbol : symbols ) {
+		auto it = lang.docsCount.find( symbol );
+		if ( it != lang.docsCount.end() && --it->second == 0 )
+			lang.docsCount.erase( it );
+	}
+}
+
+void AutoCompletePlugin::updateLangSymbols( LangCache& lang ) {
+	auto symbols = std::make_shared<SymbolsList>();
+	symbols->reserve( lang.docsCount.size() );
+	for ( const auto& symbol : lang.docsCount ) {
+		symbols->emplace_back( symbol.first );
+		symbols->back().charMask = getCharMask( symbol.first );
+	}
+	lang.symbols = symbols;
+}
+
 void AutoCompletePlugin::updateLangCache( const std::string& langName ) {
 	Clock clock;
+	std::vector<std::shared_ptr<DocumentSymbolIndex>> indexes;
+	{
+		Lock l( mDocMutex );
+		for ( auto& d : mDocCache ) {
+			if ( d.first->getSyntaxDefinition().getLanguageName() == langName ) {
+				d.second.langName = langName;
+				indexes.push_back( d.second.index );
+			}
+		}
+	}
 	Lock l( mLangSymbolsMutex );
-	Lock l2( mDocMutex );
 	auto& lang = mLangCache[langName];
-	lang.clear();
-	for ( const auto& d : mDocCache ) {
-		if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-			lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
-	}
+	lang.docsCount.clear();
+	for ( const auto& index : indexes )
+		for ( const auto& symbol : index->getSymbols() )
+			lang.docsCount[symbol]++;
+	updateLangSymbols( lang );
 	Log::debug( "Lang dictionary for %s updated in: %.2fms", langName.c_str(),
 				clock.getElapsedTime().asMilliseconds() );
 }
@@ -478,23 +537,19 @@ AutoCompletePlugin::processCodeCompletion( const LSPCompletionList& completion )
 		return {};
 	std::string symbol( getPartialSymbol( editor->getDocumentRef().get() ) );
 	const std::string& lang = editor->getDocument().getSyntaxDefinition().getLanguageName();
-	bool hasLangSuggestions = false;
+	std::shared_ptr<const SymbolsList> symbols;
 	{
 		Lock l2( mLangSymbolsMutex );
 		auto langSuggestions = mLangCache.find( lang );
-		hasLangSuggestions = langSuggestions != mLangCache.end();
+		if ( langSuggestions != mLangCache.end() )
+			symbols = langSuggestions->second.symbols;
 	}
-	if ( symbol.empty() || !hasLangSuggestions ) {
+	if ( symbol.empty() || !symbols ) {
 		Lock l( mSuggestionsMutex );
 		mSuggestions = suggestions;
 	} else {
-		SymbolsList fuzzySuggestions;
-		{
-			Lock l2( mLangSymbolsMutex );
-			auto& symbols = mLangCache[lang];
-			fuzzySuggestions = fuzzyMatchSymbols( { &suggestions, &symbols }, symbol,
-												  eemax<size_t>( 100UL, suggestions.size() ) );
-		}
+		SymbolsList fuzzySuggestions = fuzzyMatchSymbols(
+			{ &suggestions, symbols.get() }, symbol, eemax<size_t>( 100UL, suggestions.size() ) );
 		Lock l( mSuggestionsMutex );
 		mSuggestions = fuzzySuggestions;
 	}
@@ -580,7 +635,14 @@ void AutoCompletePlugin::update( UICodeEditor* ) {
 		mDirty = false;
 		Lock l( mDocMutex );
 		for ( auto& doc : mDocs ) {
-			if ( !doc->isLoading() && mDocCache[doc].changeId != doc->getCurrentChangeId() ) {
+			if ( doc->isLoading() )
+				continue;
+			auto& docCache = mDocCache[doc];
+			if ( !docCache.index ) {
+				docCache.index = std::make_shared<DocumentSymbolIndex>( doc );
+				docCache.langName = doc->getSyntaxDefinition().getLanguageName();
+			}
+			if ( docCache.index->isDirty() ) {
 				{
 					Lock lu( mDocsUpdatingMutex );
 					auto du = mDocsUpdating.find( doc );
@@ -925,35 +987,9 @@ void AutoCompletePlugin::resetSignatureHelp() {
 	mSignatureHelpEditor = nullptr;
 }
 
-AutoCompletePlugin::SymbolsList AutoCompletePlugin::getDocumentSymbols( TextDocument* doc ) {
-	LuaPattern pattern( mSymbolPattern );
-	AutoCompletePlugin::SymbolsList symbols;
-	Int64 lc = doc->linesCount();
-	if ( lc == 0 || lc > 50000 || mClosing )
-		return symbols;
-	std::string current( getPartialSymbol( doc ) );
-	TextPosition end = doc->getSelection().end();
-	for ( Int64 i = 0; i < lc; i++ ) {
-		const auto& string = doc->line( i ).getText().toUtf8();
-		for ( auto& match : pattern.gmatch( string ) ) {
-			std::string matchStr( match[0] );
-			// Ignore the symbol if is actually the current symbol being written
-			if ( matchStr.size() < 3 || ( end.line() == i && current == matchStr ) )
-				continue;
-			if ( std::none_of( symbols.begin(), symbols.end(),
-							   [matchStr]( const Suggestion& suggestion ) {
-								   return suggestion.text == matchStr;
-							   } ) )
-				symbols.push_back( std::move( matchStr ) );
-		}
-		if ( mClosing )
-			break;
-	}
-	return symbols;
-}
-
 void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
-											   const SymbolsList& symbols, UICodeEditor* editor ) {
+											   const std::shared_ptr<const SymbolsList>& symbols,
+											   UICodeEditor* editor ) {
 	{
 		{
 			Lock l( mSuggestionsEditorMutex );
@@ -963,20 +999,24 @@ void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
 			requestCodeCompletion( editor );
 		if ( symbol.empty() )
 			return;
-		Lock l( mLangSymbolsMutex );
-		Lock l2( mSuggestionsMutex );
-		mSuggestions = fuzzyMatchSymbols( { &symbols }, symbol, mSuggestionsMaxVisible );
+		SymbolsList suggestions =
+			fuzzyMatchSymbols( { symbols.get() }, symbol, mSuggestionsMaxVisible );
+		Lock l( mSuggestionsMutex );
+		mSuggestions = std::move( suggestions );
 	}
 	editor->runOnMainThread( [editor] { editor->invalidateDraw(); } );
 }
 
 void AutoCompletePlugin::updateSuggestions( const std::string& symbol, UICodeEditor* editor ) {
 	const std::string& lang = editor->getDocument().getSyntaxDefinition().getLanguageName();
-	Lock l( mLangSymbolsMutex );
-	auto langSuggestions = mLangCache.find( lang );
-	if ( langSuggestions == mLangCache.end() )
-		return;
-	auto& symbols = langSuggestions->second;
+	std::shared_ptr<const SymbolsList> symbols;
+	{
+		Lock l( mLangSymbolsMutex );
+		auto langSuggestions = mLangCache.find( lang );
+		if ( langSuggestions == mLangCache.end() || !langSuggestions->second.symbols )
+			return;
+		symbols = langSuggestions->second.symbols;
+	}
 	{
 #if AUTO_COMPLETE_THREADED
 		mPool->run(
@@ -3,6 +3,7 @@
 
 #include "../lsp/lspprotocol.hpp"
 #include "../pluginmanager.hpp"
+#include "documentsymbolindex.hpp"
 #include <eepp/config.hpp>
 #include <eepp/system/clock.hpp>
 #include <eepp/system/mutex.hpp>
@@ -26,6 +27,8 @@ class AutoCompletePlugin : public UICodeEditorPlugin {
 		std::string sortText;
 		TextRange range;
 		double score{ 0 };
+		/** Characters present in the text (see getCharMask), 0 if unknown. */
+		Uint64 charMask{ 0 };
 
 		void setScore( const double& score ) const {
 			const_cast<Suggestion*>( this )->score = score;
@@ -51,6 +54,10 @@ class AutoCompletePlugin : public UICodeEditorPlugin {
 	};
 	typedef std::vector<Suggestion> SymbolsList;
 
+	/** @return A bit set of the characters of the text (case insensitive), a symbol can only match
+	 * a pattern if it contains all the bits of the pattern mask. */
+	static Uint64 getCharMask( const std::string& text );
+
 	static PluginDefinition Definition() {
 		return { "autocomplete",
 				 "Auto Complete",
@@ -122,12 +129,18 @@ class AutoCompletePlugin : public UICodeEditorPlugin {
 	bool mReplacing{ false };
 	bool mSignatureHelpVisible{ false };
 	struct DocCache {
-		Uint64 changeId{ static_cast<Uint64>( -1 ) };
-		SymbolsList symbols;
+		std::shared_ptr<DocumentSymbolIndex> index;
+		/** Language where the document symbols were counted. */
+		std::string langName;
 	};
 	std::unordered_map<TextDocument*, DocCache> mDocCache;
-	std::unordered_map<std::string, SymbolsList> mLangCache;
-	SymbolsList mLangDirty;
+	struct LangCache {
+		/** Number of documents that contain each symbol. */
+		std::unordered_map<std::string, Uint32> docsCount;
+		/** The symbols of all the documents, rebuilt when the set of symbols changes. */
+		std::shared_ptr<const SymbolsList> symbols;
+	};
+	std::unordered_map<std::string, LangCache> mLangCache;
 
 	std::vector<Suggestion> mSuggestions;
 	Mutex mSuggestionsEditorMutex;
@@ -157,13 +170,18 @@ class AutoCompletePlugin : public UICodeEditorPlugin {
 
 	void updateSuggestions( const std::string& symbol, UICodeEditor* editor );
 
-	SymbolsList getDocumentSymbols( TextDocument* );
-
 	void updateDocCache( TextDocument* doc );
 
+	void removeDocCache( TextDocument* doc );
+
+	void removeLangSymbols( LangCache& lang, const std::vector<std::string>& symbols );
+
+	void updateLangSymbols( LangCache& lang );
+
 	std::string getPartialSymbol( TextDocument* doc );
 
-	void runUpdateSuggestions( const std::string& symbol, const SymbolsList& symbols,
+	void runUpdateSuggestions( const std::string& symbol,
+							   const std::shared_ptr<const SymbolsList>& symbols,
 							   UICodeEditor* editor );
 
 	void updateLangCache( const std::string& langName );
@@ -0,0 +1,239 @@
+#include "documentsymbolindex.hpp"
+#include <algorithm>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/luapattern.hpp>
+
+namespace ecode {
+
+// Number of lines scanned between two locks of the index.
+static constexpr size_t LINES_PER_SCAN = 256;
+
+DocumentSymbolIndex::DocumentSymbolIndex( TextDocument* doc ) : mDoc( doc ) {
+	invalidate();
+	mDoc->registerClient( this );
+}
+
+DocumentSymbolIndex::~DocumentSymbolIndex() {
+	detach();
+}
+
+void DocumentSymbolIndex::detach() {
+	TextDocument* doc = nullptr;
+	{
+		Lock l( mMutex );
+		doc = mDoc;
+		mDoc = nullptr;
+	}
+	if ( doc )
+		doc->unregisterClient( this );
+}
+
+void DocumentSymbolIndex::invalidate() {
+	Lock l( mMutex );
+	for ( auto& line : mLines )
+		releaseLine( line );
+	mLines.clear();
+	mLines.resize( mDoc ? mDoc->linesCount() : 0 );
+	mDirtyCount = mLines.size();
+	mLinesVersion++;
+	mSkippedLine = -1;
+}
+
+void DocumentSymbolIndex::setDirty( LineSymbols& line ) {
+	if ( !line.dirty ) {
+		line.dirty = true;
+		mDirtyCount++;
+	}
+}
+
+void DocumentSymbolIndex::releaseLine( LineSymbols& line ) {
+	mReleased.insert( mReleased.end(), line.symbols.begin(), line.symbols.end() );
+	line.symbols.clear();
+}
+
+bool DocumentSymbolIndex::isDirty() const {
+	Lock l( mMutex );
+	return mDirtyCount > 0 || !mReleased.empty();
+}
+
+std::vector<std::string> DocumentSymbolIndex::getSymbols() const {
+	Lock l( mMutex );
+	std::vector<std::string> symbols;
+	symbols.reserve( mSymbols.size() );
+	for ( const auto& symbol : mSymbols )
+		symbols.push_back( symbol.first );
+	return symbols;
+}
+
+bool DocumentSymbolIndex::update( const std::string& symbolPattern,
+								  std::vector<std::string>& added,
+								  std::vector<std::string>& removed, const bool& stop ) {
+	{
+		Lock l( mMutex );
+		if ( symbolPattern != mSymbolPattern ) {
+			mSymbolPattern = symbolPattern;
+			invalidate();
+		}
+	}
+
+	LuaPattern pattern( symbolPattern );
+	std::vector<std::pair<Int64, std::string>> lines;
+	std::vector<std::vector<std::string>> lineSymbols;
+	std::vector<const std::string*> released;
+	Int64 skippedLine = -1;
+	Int64 next = 0;
+
+	while ( !stop ) {
+		Uint64 linesVersion;
+		TextPosition cursor;
+		std::string current;
+		lines.clear();
+
+		{
+			Lock l( mMutex );
+			if ( nullptr == mDoc || mDirtyCount == 0 )
+				break;
+
+			Int64 first = next;
+			linesVersion = mLinesVersion;
+			cursor = mDoc->getSelection().end();
+			current = mDoc->getText( { mDoc->startOfWord( cursor ), cursor } ).toUtf8();
+
+			for ( ; next < (Int64)mLines.size() && lines.size() < LINES_PER_SCAN; next++ )
+				if ( mLines[next].dirty )
+					lines.emplace_back( next, mDoc->line( next ).getText().toUtf8() );
+
+			if ( lines.empty() ) {
+				if ( first == 0 ) {
+					mDirtyCount = 0;
+					break;
+				}
+				// Lines made dirty behind the scan position.
+				next = 0;
+				continue;
+			}
+		}
+
+		lineSymbols.resize( lines.size() );
+
+		for ( size_t i = 0; i < lines.size(); i++ ) {
+			lineSymbols[i].clear();
+			for ( auto& match : pattern.gmatch( lines[i].second ) ) {
+				std::string matchStr( match[0] );
+				// Ignore the symbol if is actually the current symbol being written
+				if ( matchStr.size() < 3 ) {
+					continue;
+				} else if ( cursor.line() == lines[i].first && current == matchStr ) {
+					skippedLine = cursor.line();
+					continue;
+				}
+				lineSymbols[i].emplace_back( std::move( matchStr ) );
+			}
+		}
+
+		Lock l( mMutex );
+		// The lines moved while scanning, the lines are still dirty so they are scanned again.
+		if ( linesVersion != mLinesVersion ) {
+			next = 0;
+			continue;
+		}
+
+		for ( size_t i = 0; i < lines.size(); i++ ) {
+			LineSymbols& line = mLines[lines[i].first];
+			releaseLine( line );
+
+			for ( auto& symbol : lineSymbols[i] ) {
+				auto res = mSymbols.emplace( std::move( symbol ), 0 );
+				if ( res.second )
+					added.push_back( res.first->first );
+				res.first->second++;
+				line.symbols.push_back( &res.first->first );
+			}
+
+			if ( line.dirty ) {
+				line.dirty = false;
+				mDirtyCount--;
+			}
+		}
+
+		if ( skippedLine != -1 )
+			mSkippedLine = skippedLine;
+	}
+
+	Lock l( mMutex );
+	released.swap( mReleased );
+
+	// The symbols can be released several times, and moved from one line to another.
+	for ( const auto& symbol : released )
+		mSymbols[*symbol]--;
+	std::sort( released.begin(), released.end() );
+	released.erase( std::unique( released.begin(), released.end() ), released.end() );
+
+	for ( const auto& symbol : released ) {
+		auto it = mSymbols.find( *symbol );
+		if ( it->second == 0 ) {
+			removed.push_back( it->first );
+			mSymbols.erase( it );
+		}
+	}
+
+	return mDirtyCount == 0;
+}
+
+void DocumentSymbolIndex::onDocumentLoaded( TextDocument* ) {
+	invalidate();
+}
+
+void DocumentSymbolIndex::onDocumentReloaded( TextDocument* ) {
+	invalidate();
+}
+
+void DocumentSymbolIndex::onDocumentClosed( TextDocument* ) {
+	Lock l( mMutex );
+	mDoc = nullptr;
+}
+
+void DocumentSymbolIndex::onDocumentTextChanged( const DocumentContentChange& change ) {
+	Lock l( mMutex );
+	if ( nullptr == mDoc )
+		return;
+
+	// The lines of the range are replaced by the lines of the text.
+	TextRange range( change.range.normalized() );
+	Int64 start = range.start().line();
+	Int64 end = eemin<Int64>( range.end().line(), mLines.size() - 1 );
+	Int64 newLines = std::count( change.text.begin(), change.text.end(), '\n' );
+
+	if ( start < 0 || start >= (Int64)mLines.size() ) {
+		invalidate();
+		return;
+	}
+
+	setDirty( mLines[start] );
+
+	if ( end > start || newLines > 0 ) {
+		for ( Int64 i = start + 1; i <= end; i++ ) {
+			releaseLine( mLines[i] );
+			if ( mLines[i].dirty )
+				mDirtyCount--;
+		}
+		mLines.erase( mLines.begin() + start + 1, mLines.begin() + end + 1 );
+		mLines.insert( mLines.begin() + start + 1, newLines, LineSymbols() );
+		mDirtyCount += newLines;
+		mLinesVersion++;
+	}
+
+	if ( mLines.size() != mDoc->linesCount() )
+		invalidate();
+}
+
+void DocumentSymbolIndex::onDocumentCursorChange( const TextPosition& ) {
+	Lock l( mMutex );
+	// The symbol ignored while it was being written must be indexed when it's done.
+	if ( mSkippedLine >= 0 && mSkippedLine < (Int64)mLines.size() ) {
+		setDirty( mLines[mSkippedLine] );
+		mSkippedLine = -1;
+	}
+}
+
+} // namespace ecode
@@ -0,0 +1,84 @@
+#ifndef ECODE_DOCUMENTSYMBOLINDEX_HPP
+#define ECODE_DOCUMENTSYMBOLINDEX_HPP
+
+#include <eepp/system/mutex.hpp>
+#include <eepp/ui/doc/textdocument.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace EE;
+using namespace EE::System;
+using namespace EE::UI::Doc;
+
+namespace ecode {
+
+/** Keeps the symbols of a document indexed by line. The index listens to the document changes, so
+ * an update only scans again the lines touched since the previous one. */
+class DocumentSymbolIndex : public TextDocument::Client {
+  public:
+	DocumentSymbolIndex( TextDocument* doc );
+
+	~DocumentSymbolIndex();
+
+	/** Scans the dirty lines.
+	 * @param added Receives the symbols that weren't in the document before the update.
+	 * @param removed Receives the symbols that aren't in the document anymore.
+	 * @param stop Interrupts the update when set, the lines not scanned stay dirty.
+	 * @return True if the index is up to date. */
+	bool update( const std::string& symbolPattern, std::vector<std::string>& added,
+				 std::vector<std::string>& removed, const bool& stop );
+
+	/** @return If there are lines to scan. */
+	bool isDirty() const;
+
+	/** @return All the symbols of the document. */
+	std::vector<std::string> getSymbols() const;
+
+	/** Stops listening the document, the index won't be updated anymore. */
+	void detach();
+
+	virtual void onDocumentLoaded( TextDocument* );
+	virtual void onDocumentTextChanged( const DocumentContentChange& change );
+	virtual void onDocumentUndoRedo( const TextDocument::UndoRedo& ) {}
+	virtual void onDocumentCursorChange( const TextPosition& );
+	virtual void onDocumentSelectionChange( const TextRange& ) {}
+	virtual void onDocumentLineCountChange( const size_t&, const size_t& ) {}
+	virtual void onDocumentLineChanged( const Int64& ) {}
+	virtual void onDocumentSaved( TextDocument* ) {}
+	virtual void onDocumentClosed( TextDocument* );
+	virtual void onDocumentDirtyOnFileSystem( TextDocument* ) {}
+	virtual void onDocumentMoved( TextDocument* ) {}
+	virtual void onDocumentReloaded( TextDocument* );
+
+  protected:
+	struct LineSymbols {
+		/** Keys of mSymbols, the nodes of an unordered_map never move. */
+		std::vector<const std::string*> symbols;
+		bool dirty{ true };
+	};
+
+	TextDocument* mDoc{ nullptr };
+	mutable Mutex mMutex;
+	std::string mSymbolPattern;
+	/** Number of occurrences of each symbol in the document. */
+	std::unordered_map<std::string, Uint32> mSymbols;
+	std::vector<LineSymbols> mLines;
+	/** Symbols of the removed lines, released in the next update. */
+	std::vector<const std::string*> mReleased;
+	Uint64 mDirtyCount{ 0 };
+	/** Incremented every time the lines are moved. */
+	Uint64 mLinesVersion{ 0 };
+	/** Line where the symbol being written was ignored. */
+	Int64 mSkippedLine{ -1 };
+
+	void invalidate();
+
+	void setDirty( LineSymbols& line );
+
+	void releaseLine( LineSymbols& line );
+};
+
+} // namespace ecode
+
+#endif // ECODE_DOCUMENTSYMBOLINDEX_HPP
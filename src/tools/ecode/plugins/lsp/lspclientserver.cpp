@@ -138,6 +138,102 @@ static json toJson( const std::vector<DocumentContentChange>& changes ) {
 	return result;
 }
 
+static void appendJsonString( std::string& buffer, const std::string& str ) {
+	static const char* hex = "0123456789abcdef";
+	buffer += '"';
+	for ( const char& ch : str ) {
+		switch ( ch ) {
+			case '"':
+				buffer += "\\\"";
+				break;
+			case '\\':
+				buffer += "\\\\";
+				break;
+			case '\n':
+				buffer += "\\n";
+				break;
+			case '\r':
+				buffer += "\\r";
+				break;
+			case '\t':
+				buffer += "\\t";
+				break;
+			default:
+				if ( static_cast<unsigned char>( ch ) < 0x20 ) {
+					buffer += "\\u00";
+					buffer += hex[( ch >> 4 ) & 0xF];
+					buffer += hex[ch & 0xF];
+				} else {
+					buffer += ch;
+				}
+		}
+	}
+	buffer += '"';
+}
+
+static void appendJsonPosition( std::string& buffer, const TextPosition& pos ) {
+	buffer += "{\"line\":";
+	buffer += std::to_string( pos.line() );
+	buffer += ",\"character\":";
+	buffer += std::to_string( pos.column() );
+	buffer += '}';
+}
+
+static bool hasNewLine( const String& text ) {
+	return text.find( '\n' ) != String::InvalidPos;
+}
+
+// Appends the change to the list, merging it with the last change when both are part of the same
+// typing or deleting sequence (all the ranges are relative to the document before the merged
+// change).
+static void appendContentChange( std::vector<DocumentContentChange>& changes,
+								 const DocumentContentChange& change ) {
+	if ( !changes.empty() ) {
+		DocumentContentChange& last = changes.back();
+		TextRange lastRange( last.range.normalized() );
+		TextRange range( change.range.normalized() );
+		TextPosition lastTextEnd( lastRange.start().line(),
+								  lastRange.start().column() + last.text.size() );
+
+		if ( !range.hasSelection() ) {
+			// Typing after the last inserted or replaced text, or over a deleted selection.
+			if ( !hasNewLine( last.text ) && range.start() == lastTextEnd ) {
+				last.range = lastRange;
+				last.text += change.text;
+				return;
+			}
+		} else if ( change.text.empty() ) {
+			if ( last.text.empty() ) {
+				// Backspace before the last deleted range.
+				if ( range.end() == lastRange.start() ) {
+					last.range = TextRange( range.start(), lastRange.end() );
+					return;
+				}
+
+				// Delete after the last deleted range.
+				if ( range.start() == lastRange.start() &&
+					 range.start().line() == range.end().line() ) {
+					last.range = TextRange(
+						lastRange.start(),
+						TextPosition( lastRange.end().line(),
+									  lastRange.end().column() + range.end().column() -
+										  range.start().column() ) );
+					return;
+				}
+			} else if ( !hasNewLine( last.text ) && range.end() == lastTextEnd &&
+						range.start().line() == lastRange.start().line() &&
+						range.start().column() >= lastRange.start().column() ) {
+				// Backspace over the last inserted text.
+				last.range = lastRange;
+				last.text.resize( range.start().column() - lastRange.start().column() );
+				return;
+			}
+		}
+	}
+
+	changes.push_back( change );
+}
+
 static TextPosition parsePosition( const json& m ) {
 	auto line = m[MEMBER_LINE].get<int>();
 	auto column = m[MEMBER_CHARACTER].get<int>();
@@ -1035,6 +1131,9 @@ LSPClientServer::LSPRequestHandle LSPClientServer::didSave( TextDocument* doc )
 LSPClientServer::LSPRequestHandle
 LSPClientServer::didChange( const URI& document, int version, const std::string& text,
 							const std::vector<DocumentContentChange>& change ) {
+	if ( text.empty() && mReady )
+		return writeDidChange( document, version, change );
+
 	auto params = textDocumentParams( document, version );
 	params["contentChanges"] = !text.empty() ? json{ json{ MEMBER_TEXT, text } } : toJson( change );
 	return send( newRequest( "textDocument/didChange", params ) );
@@ -1050,19 +1149,98 @@ LSPClientServer::didChange( TextDocument* doc, const std::vector<DocumentContent
 	return LSPRequestHandle();
 }
 
-void LSPClientServer::queueDidChange( const URI& document, int version, const std::string&,
+bool LSPClientServer::queueDidChange( const URI& document, int version, const std::string&,
 									  const std::vector<DocumentContentChange>& change ) {
 	Lock l( mDidChangeMutex );
-	mDidChangeQueue.push( { document, version, change } );
+	mDidChangeQueue.push_back( { document, version, change } );
+	bool schedule = !mDidChangeScheduled;
+	mDidChangeScheduled = true;
+	return schedule;
 }
 
 void LSPClientServer::processDidChangeQueue() {
-	Lock l( mDidChangeMutex );
-	while ( !mDidChangeQueue.empty() ) {
-		auto& change = mDidChangeQueue.front();
-		didChange( change.uri, change.version, "", change.change );
-		mDidChangeQueue.pop();
+	// Keeps the notifications in order if two processing runs overlap.
+	Lock sl( mDidChangeSendMutex );
+	std::vector<DidChangeQueue> queue;
+
+	{
+		Lock l( mDidChangeMutex );
+		queue.swap( mDidChangeQueue );
+		mDidChangeScheduled = false;
+	}
+
+	// The changes of each document are merged in a single notification with the last version.
+	std::vector<bool> sent( queue.size(), false );
+
+	for ( size_t i = 0; i < queue.size(); i++ ) {
+		if ( sent[i] )
+			continue;
+
+		DidChangeQueue merged{ queue[i].uri, queue[i].version, {} };
+
+		for ( size_t j = i; j < queue.size(); j++ ) {
+			if ( sent[j] || queue[j].uri != merged.uri )
+				continue;
+
+			for ( const auto& change : queue[j].change )
+				appendContentChange( merged.change, change );
+
+			merged.version = queue[j].version;
+			sent[j] = true;
+		}
+
+		didChange( merged.uri, merged.version, "", merged.change );
+	}
+}
+
+LSPClientServer::LSPRequestHandle
+LSPClientServer::writeDidChange( const URI& document, int version,
+								 const std::vector<DocumentContentChange>& changes ) {
+	LSPRequestHandle ret;
+	ret.server = this;
+
+	if ( !mProcess.isAlive() )
+		return ret;
+
+	// The notification is serialized directly, it's sent on every document change.
+	Lock l( mDidChangeSendMutex );
+	std::string& body = mDidChangeBody;
+	body.clear();
+	body += "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\",\"params\":{"
+			"\"textDocument\":{\"uri\":";
+	appendJsonString( body, document.toString() );
+	if ( version >= 0 ) {
+		body += ",\"version\":";
+		body += std::to_string( version );
+	}
+	body += "},\"contentChanges\":[";
+	for ( size_t i = 0; i < changes.size(); i++ ) {
+		if ( i > 0 )
+			body += ',';
+		TextRange range( changes[i].range.normalized() );
+		body += "{\"range\":{\"start\":";
+		appendJsonPosition( body, range.start() );
+		body += ",\"end\":";
+		appendJsonPosition( body, range.end() );
+		body += "},\"text\":";
+		appendJsonString( body, changes[i].text.toUtf8() );
+		body += '}';
 	}
+	body += "]}}";
+
+	std::string& message = mDidChangeMessage;
+	message.clear();
+	message += "Content-Length: ";
+	message += std::to_string( body.size() );
+	message += "\r\n\r\n";
+	message += body;
+
+	Log::info( "LSPClientServer server %s calling textDocument/didChange", mLSP.name.c_str() );
+	Log::debug( "LSPClientServer server %s sending message:\n%s", mLSP.name.c_str(),
+				message.c_str() );
+	mProcess.write( message );
+
+	return ret;
 }
 
 bool LSPClientServer::hasDocument( TextDocument* doc ) const {
@@ -1234,49 +1412,71 @@ void LSPClientServer::processRequest( const json& msg ) {
 void LSPClientServer::readStdOut( const char* bytes, size_t n ) {
 	mReceive.append( bytes, n );
 
+	// The received data is consumed by moving mReceiveOffset, mReceiveScan is where the search of
+	// the end of the headers continues and mReceiveLength the length of the payload once the
+	// headers were parsed (-1 while parsing them).
 	std::string& buffer = mReceive;
 
 	while ( true ) {
-		auto index = buffer.find( CONTENT_LENGTH_HEADER );
-		if ( index == std::string::npos ) {
-			if ( buffer.size() > ( 1 << 20 ) )
-				buffer.clear();
-			break;
-		}
+		if ( mReceiveLength < 0 ) {
+			auto msgstart = buffer.find( "\r\n\r\n", mReceiveScan );
+			if ( msgstart == std::string::npos ) {
+				// The separator could be split between two reads.
+				mReceiveScan = eemax( mReceiveOffset, buffer.size() >= 3 ? buffer.size() - 3 : 0 );
+				if ( buffer.size() - mReceiveOffset > ( 1 << 20 ) ) {
+					buffer.clear();
+					mReceiveOffset = mReceiveScan = 0;
+				}
+				break;
+			}
 
-		index += strlen( CONTENT_LENGTH_HEADER );
-		auto endindex = buffer.find( "\r\n", index );
-		auto msgstart = buffer.find( "\r\n\r\n", index );
-		if ( endindex == std::string::npos || msgstart == std::string::npos )
-			break;
+			auto index = buffer.find( CONTENT_LENGTH_HEADER, mReceiveOffset );
+			msgstart += 4;
 
-		msgstart += 4;
-		int length = 0;
-		bool ok = String::fromString( length, buffer.substr( index, endindex - index ) );
-		// FIXME perhaps detect if no reply for some time
-		// then again possibly better left to user to restart in such case
-		if ( !ok ) {
-			Log::debug( "LSPClientServer::readStdOut server %s invalid " CONTENT_LENGTH,
-						mLSP.name.c_str() );
-			// flush and try to carry on to some next header
-			buffer.erase( 0, msgstart );
-			continue;
-		}
-		// sanity check to avoid extensive buffering
-		if ( length > ( 1 << 29 ) ) {
-			Log::debug( "LSPClientServer::readStdOut server %s excessive size", mLSP.name.c_str() );
-			buffer.clear();
-			continue;
+			if ( index == std::string::npos || index >= msgstart ) {
+				Log::debug( "LSPClientServer::readStdOut server %s missing " CONTENT_LENGTH,
+							mLSP.name.c_str() );
+				mReceiveOffset = mReceiveScan = msgstart;
+				continue;
+			}
+
+			index += strlen( CONTENT_LENGTH_HEADER );
+			auto endindex = buffer.find( "\r\n", index );
+			Int64 length = 0;
+			bool ok = String::fromString( length, buffer.substr( index, endindex - index ) );
+			// FIXME perhaps detect if no reply for some time
+			// then again possibly better left to user to restart in such case
+			if ( !ok ) {
+				Log::debug( "LSPClientServer::readStdOut server %s invalid " CONTENT_LENGTH,
+							mLSP.name.c_str() );
+				// flush and try to carry on to some next header
+				mReceiveOffset = mReceiveScan = msgstart;
+				continue;
+			}
+			// sanity check to avoid extensive buffering
+			if ( length > ( 1 << 29 ) || length < 0 ) {
+				Log::debug( "LSPClientServer::readStdOut server %s excessive size",
+							mLSP.name.c_str() );
+				buffer.clear();
+				mReceiveOffset = mReceiveScan = 0;
+				continue;
+			}
+
+			mReceiveLength = length;
+			mReceiveOffset = msgstart;
 		}
-		if ( msgstart + length > buffer.length() ) {
+
+		if ( mReceiveOffset + mReceiveLength > buffer.size() )
 			break;
-		}
 
-		// now onto payload
-		auto payload = buffer.substr( msgstart, length );
-		buffer.erase( 0, msgstart + length );
+		// now onto payload, parsed in place
+		const char* payload = buffer.data() + mReceiveOffset;
+		size_t length = mReceiveLength;
+		mReceiveOffset += length;
+		mReceiveScan = mReceiveOffset;
+		mReceiveLength = -1;
 
-		if ( payload.empty() ) {
+		if ( length == 0 ) {
 			Log::debug( "LSPClientServer::readStdOut server %s empty payload", mLSP.name.c_str() );
 			continue;
 		}
@@ -1284,7 +1484,7 @@ void LSPClientServer::readStdOut( const char* bytes, size_t n ) {
 #ifndef EE_DEBUG
 		try {
 #endif
-			auto res = json::parse( payload );
+			auto res = json::parse( payload, payload + length );
 
 			PluginIDType msgid;
 			if ( res.contains( MEMBER_ID ) ) {
@@ -1334,6 +1534,16 @@ void LSPClientServer::readStdOut( const char* bytes, size_t n ) {
 		}
 #endif
 	}
+
+	// Drops the consumed data, only when it's worth moving the pending data.
+	if ( mReceiveOffset == buffer.size() ) {
+		buffer.clear();
+		mReceiveScan = mReceiveOffset = 0;
+	} else if ( mReceiveOffset > ( 1 << 16 ) && mReceiveOffset > buffer.size() / 2 ) {
+		buffer.erase( 0, mReceiveOffset );
+		mReceiveScan -= mReceiveOffset;
+		mReceiveOffset = 0;
+	}
 }
 
 void LSPClientServer::readStdErr( const char* bytes, size_t n ) {
@@ -12,7 +12,6 @@
 #include <eepp/ui/uipopupmenu.hpp>
 #include <memory>
 #include <nlohmann/json.hpp>
-#include <queue>
 
 using json = nlohmann::json;
 
@@ -98,9 +97,12 @@ class LSPClientServer {
 	LSPRequestHandle didChange( TextDocument* doc,
 								const std::vector<DocumentContentChange>& change = {} );
 
-	void queueDidChange( const URI& document, int version, const std::string& text,
+	/** Queues the changes of a document to be sent by processDidChangeQueue.
+	 * @return True if a processDidChangeQueue call must be scheduled (there isn't one pending). */
+	bool queueDidChange( const URI& document, int version, const std::string& text,
 						 const std::vector<DocumentContentChange>& change = {} );
 
+	/** Sends all the queued changes, with a single didChange notification per document. */
 	void processDidChangeQueue();
 
 	LSPRequestHandle documentDefinition( const URI& document, const TextPosition& pos );
@@ -212,8 +214,15 @@ class LSPClientServer {
 		IdType version;
 		std::vector<DocumentContentChange> change;
 	};
-	std::queue<DidChangeQueue> mDidChangeQueue;
+	std::vector<DidChangeQueue> mDidChangeQueue;
 	Mutex mDidChangeMutex;
+	bool mDidChangeScheduled{ false };
+	Mutex mDidChangeSendMutex;
+	std::string mDidChangeBody;
+	std::string mDidChangeMessage;
+	size_t mReceiveOffset{ 0 };
+	size_t mReceiveScan{ 0 };
+	Int64 mReceiveLength{ -1 };
 
 	int mLastMsgId{ 0 };
 
@@ -224,6 +233,9 @@ class LSPClientServer {
 	LSPRequestHandle write( const json& msg, const JsonReplyHandler& h = nullptr,
 							const JsonReplyHandler& eh = nullptr, const int id = 0 );
 
+	LSPRequestHandle writeDidChange( const URI& document, int version,
+									 const std::vector<DocumentContentChange>& changes );
+
 	void initialize();
 
 	void sendQueuedMessages();
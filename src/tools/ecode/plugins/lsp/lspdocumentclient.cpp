@@ -20,8 +20,11 @@ void LSPDocumentClient::onDocumentTextChanged( const DocumentContentChange& chan
 	++mVersion;
 	// If several change event are being fired, the thread pool can't guaranteed that it will be
 	// executed in FIFO. Se we accumulate the events in a queue and fire them in correct order.
-	mServer->queueDidChange( mDoc->getURI(), mVersion, "", { change } );
-	mServer->getThreadPool()->run( [&, change]() { mServer->processDidChangeQueue(); } );
+	// Only one queue processing is scheduled at a time, the changes queued meanwhile are sent
+	// together.
+	LSPClientServer* server = mServer;
+	if ( server->queueDidChange( mDoc->getURI(), mVersion, "", { change } ) )
+		server->getThreadPool()->run( [server]() { server->processDidChangeQueue(); } );
 }
 
 void LSPDocumentClient::onDocumentUndoRedo( const TextDocument::UndoRedo& /*eventType*/ ) {}
@@ -2,6 +2,7 @@
 #include "ecode.hpp"
 #include <algorithm>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/md5.hpp>
 #include <limits>
 
 namespace ecode {
@@ -16,10 +17,23 @@ ProjectDirectoryTree::ProjectDirectoryTree( const std::string& path,
 	mIgnoreMatcher( path ),
 	mApp( app ) {
 	FileSystem::dirAddSlashAtEnd( mPath );
+	mSearchIndex = std::make_shared<ProjectSearchIndex>(
+		mApp->getConfigPath().empty()
+			? ""
+			: mApp->getConfigPath() + "projects" + FileSystem::getOSSlash() +
+				  MD5::fromString( mPath ).toHexString() + ".idx" );
 }
 
 ProjectDirectoryTree::~ProjectDirectoryTree() {
 	mApp->getPluginManager()->unsubscribeMessages( "ProjectDirectoryTree" );
+	mSearchIndex->cancel();
+#if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN || defined( __EMSCRIPTEN_PTHREADS__ )
+	// The index is saved in the background, closing a big project must not block the UI.
+	if ( mSearchIndex->isReady() && mSearchIndex->isDirty() ) {
+		std::shared_ptr<ProjectSearchIndex> index( mSearchIndex );
+		mPool->run( [index] { index->save(); } );
+	}
+#endif
 	Lock rl( mMatchingMutex );
 	if ( mRunning ) {
 		mRunning = false;
@@ -66,8 +80,10 @@ void ProjectDirectoryTree::scan( const ProjectDirectoryTree::ScanCompleteEvent&
 				std::set<std::string> info;
 				getDirectoryFiles( mFiles, mNames, mPath, info, ignoreHidden, mIgnoreMatcher );
 			}
+			mFilesVersion++;
 			mIsReady = true;
 			mRunning = false;
+			syncSearchIndex();
 			mApp->getPluginManager()->subscribeMessages(
 				"ProjectDirectoryTree", [&]( const PluginMessage& msg ) -> PluginRequestHandle {
 					return processMessage( msg );
@@ -108,23 +124,183 @@ ProjectDirectoryTree::fuzzyMatchTree( const std::vector<std::string>& matches,
 	return std::make_shared<FileListModel>( files, names );
 }
 
+static inline unsigned char fuzzyToLower( unsigned char c ) {
+	return c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c;
+}
+
+static Uint64 fuzzyMatchMask( const std::string& str ) {
+	Uint64 mask = 0;
+	for ( unsigned char c : str ) {
+		c = fuzzyToLower( c );
+		if ( c >= 'a' && c <= 'z' ) {
+			mask |= Uint64( 1 ) << ( c - 'a' );
+		} else if ( c >= '0' && c <= '9' ) {
+			mask |= Uint64( 1 ) << ( 26 + c - '0' );
+		} else if ( c != ' ' ) {
+			mask |= Uint64( 1 ) << ( 36 + c % 28 );
+		}
+	}
+	return mask;
+}
+
+/** Same scoring as String::fuzzyMatch (without uneven matches), with ASCII case folding. */
+static int fuzzyMatchScore( const std::string& string, const std::string& pattern ) {
+	const char* str = string.c_str();
+	const char* ptn = pattern.c_str();
+	int score = 0;
+	int run = 0;
+	while ( *str && *ptn ) {
+		while ( *str == ' ' )
+			str++;
+		while ( *ptn == ' ' )
+			ptn++;
+		if ( !*str || !*ptn )
+			break;
+		if ( fuzzyToLower( *str ) == fuzzyToLower( *ptn ) ) {
+			score += run * 10 - ( *str != *ptn );
+			run++;
+			ptn++;
+		} else {
+			score -= 10;
+			run = 0;
+		}
+		str++;
+	}
+	if ( *ptn )
+		return std::numeric_limits<int>::min();
+	return score - strlen( str );
+}
+
+namespace {
+
+struct FuzzyMatchResult {
+	int score;
+	Uint32 index;
+
+	/** Best score first, same score results keep the files order. */
+	bool operator<( const FuzzyMatchResult& other ) const {
+		return score != other.score ? score > other.score : index < other.index;
+	}
+};
+
+struct FuzzyMatchJob {
+	const std::vector<std::string>* files;
+	const std::vector<std::string>* names;
+	std::vector<Uint64>* masks;
+	/** Files to score, all the files if null. */
+	const std::vector<Uint32>* candidates;
+	bool updateMasks;
+	std::string match;
+	Uint64 matchMask;
+	size_t max;
+	size_t count;
+	size_t chunksCount;
+	std::vector<std::vector<FuzzyMatchResult>> results;
+	std::vector<std::vector<Uint32>> matched;
+
+	void processChunk( size_t chunk ) {
+		std::vector<FuzzyMatchResult>& heap = results[chunk];
+		std::vector<Uint32>& chunkMatched = matched[chunk];
+		size_t end = std::min( ( chunk + 1 ) * ProjectDirectoryTree::FuzzyMatchChunkSize, count );
+		for ( size_t i = chunk * ProjectDirectoryTree::FuzzyMatchChunkSize; i < end; i++ ) {
+			Uint32 index = candidates ? ( *candidates )[i] : i;
+			if ( updateMasks )
+				( *masks )[index] = fuzzyMatchMask( ( *files )[index] );
+			if ( ( ( *masks )[index] & matchMask ) != matchMask )
+				continue;
+			// The name is a suffix of the path, if the path does not match the name can't match.
+			int score = fuzzyMatchScore( ( *files )[index], match );
+			if ( score == std::numeric_limits<int>::min() )
+				continue;
+			score = std::max( score, fuzzyMatchScore( ( *names )[index], match ) );
+			chunkMatched.push_back( index );
+			// Bounded heap with the worst kept result on top.
+			FuzzyMatchResult res{ score, index };
+			if ( heap.size() < max ) {
+				heap.push_back( res );
+				std::push_heap( heap.begin(), heap.end() );
+			} else if ( res < heap.front() ) {
+				std::pop_heap( heap.begin(), heap.end() );
+				heap.back() = res;
+				std::push_heap( heap.begin(), heap.end() );
+			}
+		}
+	}
+};
+
+} // namespace
+
 std::shared_ptr<FileListModel> ProjectDirectoryTree::fuzzyMatchTree( const std::string& match,
 																	 const size_t& max ) const {
 	Lock rl( mMatchingMutex );
-	std::multimap<int, int, std::greater<int>> matchesMap;
 	std::vector<std::string> files;
 	std::vector<std::string> names;
-	for ( size_t i = 0; i < mNames.size(); i++ ) {
-		int matchName = String::fuzzyMatch( mNames[i], match );
-		int matchPath = String::fuzzyMatch( mFiles[i], match );
-		matchesMap.insert( { std::max( matchName, matchPath ), i } );
+	if ( max == 0 )
+		return std::make_shared<FileListModel>( files, names );
+
+	Uint64 filesVersion = mFilesVersion;
+	FuzzyMatchJob job;
+	job.files = &mFiles;
+	job.names = &mNames;
+	job.masks = &mFileMasks;
+	job.updateMasks = mFileMasksVersion != filesVersion;
+	if ( job.updateMasks )
+		mFileMasks.resize( mFiles.size() );
+	// If the query extends the previous query, only the files that matched can match again.
+	bool reuse = !job.updateMasks && mFuzzyMatchCache.valid &&
+				 mFuzzyMatchCache.filesVersion == filesVersion &&
+				 String::startsWith( match, mFuzzyMatchCache.match );
+	job.candidates = reuse ? &mFuzzyMatchCache.candidates : nullptr;
+	job.match = match;
+	job.matchMask = fuzzyMatchMask( match );
+	job.max = max;
+	job.count = reuse ? mFuzzyMatchCache.candidates.size() : mFiles.size();
+	job.chunksCount = ( job.count + FuzzyMatchChunkSize - 1 ) / FuzzyMatchChunkSize;
+	job.results.resize( job.chunksCount );
+	job.matched.resize( job.chunksCount );
+
+	if ( mPool ) {
+		mPool->parallelFor( job.chunksCount,
+							[&job]( size_t chunk ) { job.processChunk( chunk ); } );
+	} else {
+		for ( size_t chunk = 0; chunk < job.chunksCount; chunk++ )
+			job.processChunk( chunk );
 	}
-	for ( auto& res : matchesMap ) {
-		if ( names.size() < max ) {
-			names.emplace_back( mNames[res.second] );
-			files.emplace_back( mFiles[res.second] );
+
+	if ( job.updateMasks )
+		mFileMasksVersion = filesVersion;
+
+	std::vector<FuzzyMatchResult> results;
+	std::vector<Uint32> matched;
+	for ( size_t i = 0; i < job.chunksCount; i++ ) {
+		results.insert( results.end(), job.results[i].begin(), job.results[i].end() );
+		matched.insert( matched.end(), job.matched[i].begin(), job.matched[i].end() );
+	}
+	std::sort( results.begin(), results.end() );
+	if ( results.size() > max )
+		results.resize( max );
+
+	for ( const auto& res : results ) {
+		files.emplace_back( mFiles[res.index] );
+		names.emplace_back( mNames[res.index] );
+	}
+
+	// Keep the previous behavior: when not enough files match, the list is completed with the
+	// files that did not match, in their original order.
+	for ( size_t i = 0, m = 0; i < mFiles.size() && files.size() < max; i++ ) {
+		if ( m < matched.size() && matched[m] == i ) {
+			m++;
+			continue;
 		}
+		files.emplace_back( mFiles[i] );
+		names.emplace_back( mNames[i] );
 	}
+
+	mFuzzyMatchCache.match = match;
+	mFuzzyMatchCache.filesVersion = filesVersion;
+	mFuzzyMatchCache.candidates = std::move( matched );
+	mFuzzyMatchCache.valid = true;
+
 	return std::make_shared<FileListModel>( files, names );
 }
 
@@ -254,10 +430,39 @@ void ProjectDirectoryTree::onChange( const ProjectDirectoryTree::Action& action,
 			moveFile( file, oldFilename );
 			break;
 		case ProjectDirectoryTree::Action::Modified:
+			if ( mSearchIndex->hasFile( file.getFilepath() ) )
+				updateSearchIndex( file.getFilepath() );
 			break;
 	}
 }
 
+void ProjectDirectoryTree::syncSearchIndex() {
+#if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN || defined( __EMSCRIPTEN_PTHREADS__ )
+	Lock l( mFilesMutex );
+	std::shared_ptr<ProjectSearchIndex> index( mSearchIndex );
+	std::vector<std::string> files( mFiles );
+	mPool->run( [index, files] { index->sync( files ); } );
+#endif
+}
+
+void ProjectDirectoryTree::updateSearchIndex( const std::string& path ) {
+#if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN || defined( __EMSCRIPTEN_PTHREADS__ )
+	// The file is a candidate for every search until it's indexed again.
+	mSearchIndex->invalidateFile( path );
+	std::shared_ptr<ProjectSearchIndex> index( mSearchIndex );
+	mPool->run( [index, path] { index->updateFile( path ); } );
+#endif
+}
+
+std::vector<std::string> ProjectDirectoryTree::getSearchCandidates( const std::string& text,
+																	bool caseSensitive,
+																	bool isPattern ) const {
+	std::vector<std::string> candidates;
+	if ( !isPattern && mSearchIndex->findCandidates( text, caseSensitive, candidates ) )
+		return candidates;
+	return mFiles;
+}
+
 void ProjectDirectoryTree::tryAddFile( const FileInfo& file ) {
 	IgnoreMatcherManager matcher( getIgnoreMatcherFromPath( file.getFilepath() ) );
 	if ( !matcher.foundMatch() || !matcher.match( file.getDirectoryPath(), file.getFilepath() ) ) {
@@ -272,6 +477,8 @@ void ProjectDirectoryTree::tryAddFile( const FileInfo& file ) {
 			Lock l( mFilesMutex );
 			mFiles.emplace_back( file.getFilepath() );
 			mNames.emplace_back( file.getFileName() );
+			mFilesVersion++;
+			updateSearchIndex( file.getFilepath() );
 		}
 	}
 }
@@ -285,6 +492,7 @@ void ProjectDirectoryTree::addFile( const FileInfo& file ) {
 		std::vector<std::string> names;
 		std::vector<LuaPattern> patterns;
 		std::set<std::string> info;
+		size_t prevFilesCount = mFiles.size();
 		if ( !mAcceptedPatterns.empty() ) {
 			getDirectoryFiles( files, names, mPath, info, false, mIgnoreMatcher );
 			size_t namesCount = names.size();
@@ -305,6 +513,11 @@ void ProjectDirectoryTree::addFile( const FileInfo& file ) {
 		} else {
 			getDirectoryFiles( mFiles, mNames, mPath, info, false, mIgnoreMatcher );
 		}
+		mFilesVersion++;
+		// The new files are added to the index right away as not indexed, so they are candidates
+		// of every search until they are read.
+		for ( size_t i = prevFilesCount; i < mFiles.size(); i++ )
+			updateSearchIndex( mFiles[i] );
 	} else {
 		tryAddFile( file );
 	}
@@ -337,6 +550,7 @@ void ProjectDirectoryTree::moveFile( const FileInfo& file, const std::string& ol
 		auto wasDirIt = std::find( mDirectories.begin(), mDirectories.end(), oldDir );
 		if ( wasDirIt != mDirectories.end() )
 			mDirectories.erase( wasDirIt );
+		mSearchIndex->renameDirectory( oldDir, dir );
 		mDirectories.emplace_back( std::move( dir ) );
 	} else {
 		std::string dir( file.getDirectoryPath() );
@@ -345,10 +559,12 @@ void ProjectDirectoryTree::moveFile( const FileInfo& file, const std::string& ol
 		if ( index != std::string::npos ) {
 			mFiles[index] = file.getFilepath();
 			mNames[index] = file.getFileName();
+			mSearchIndex->renameFile( dir + oldFilename, file.getFilepath() );
 		} else {
 			tryAddFile( file );
 		}
 	}
+	mFilesVersion++;
 }
 
 void ProjectDirectoryTree::removeFile( const FileInfo& file ) {
@@ -368,13 +584,16 @@ void ProjectDirectoryTree::removeFile( const FileInfo& file ) {
 		mFiles = files;
 		mNames = names;
 		mDirectories.erase( wasDirIt );
+		mSearchIndex->removeDirectory( removedDir );
 	} else {
 		size_t index = findFileIndex( file.getFilepath() );
 		if ( index != std::string::npos ) {
 			mFiles.erase( mFiles.begin() + index );
 			mNames.erase( mNames.begin() + index );
 		}
+		mSearchIndex->removeFile( file.getFilepath() );
 	}
+	mFilesVersion++;
 }
 
 IgnoreMatcherManager ProjectDirectoryTree::getIgnoreMatcherFromPath( const std::string& path ) {
@@ -3,6 +3,7 @@
 
 #include "ignorematcher.hpp"
 #include "plugins/pluginmanager.hpp"
+#include "projectsearchindex.hpp"
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/system/luapattern.hpp>
 #include <eepp/system/mutex.hpp>
@@ -10,7 +11,9 @@
 #include <eepp/ui/models/model.hpp>
 #include <eepp/ui/uiiconthememanager.hpp>
 #include <eepp/ui/uiscenenode.hpp>
+#include <atomic>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -105,6 +108,9 @@ class ProjectDirectoryTree {
 	std::shared_ptr<FileListModel> fuzzyMatchTree( const std::vector<std::string>& matches,
 												   const size_t& max ) const;
 
+	/** Fuzzy matches the file names and paths against the query. The files are scored in
+	 * parallel using the thread pool and only the best max results are kept. When the query
+	 * extends the previous query only the files that matched the previous query are scored. */
 	std::shared_ptr<FileListModel> fuzzyMatchTree( const std::string& match,
 												   const size_t& max ) const;
 
@@ -131,11 +137,35 @@ class ProjectDirectoryTree {
 
 	const std::string& getPath() const { return mPath; }
 
+	/** @return The files that may contain the text. If the search index can't narrow the search
+	 * (it's not ready yet or the text is a pattern) all the project files are returned. */
+	std::vector<std::string> getSearchCandidates( const std::string& text, bool caseSensitive,
+												  bool isPattern ) const;
+
+	const std::shared_ptr<ProjectSearchIndex>& getSearchIndex() const { return mSearchIndex; }
+
+	/** Number of files scored by each fuzzy match task. */
+	static constexpr size_t FuzzyMatchChunkSize = 4096;
+
   protected:
+	struct FuzzyMatchCache {
+		std::string match;
+		Uint64 filesVersion{ 0 };
+		/** Indexes of the files that matched the query, in ascending order. */
+		std::vector<Uint32> candidates;
+		bool valid{ false };
+	};
+
 	std::string mPath;
 	std::shared_ptr<ThreadPool> mPool;
 	std::vector<std::string> mFiles;
 	std::vector<std::string> mNames;
+	/** Incremented every time the files list is modified. */
+	std::atomic<Uint64> mFilesVersion{ 0 };
+	/** Characters present in every file path, used to discard the files that can't match. */
+	mutable std::vector<Uint64> mFileMasks;
+	mutable Uint64 mFileMasksVersion{ std::numeric_limits<Uint64>::max() };
+	mutable FuzzyMatchCache mFuzzyMatchCache;
 	std::vector<std::string> mDirectories;
 	std::vector<LuaPattern> mAcceptedPatterns;
 	bool mRunning;
@@ -145,6 +175,7 @@ class ProjectDirectoryTree {
 	mutable Mutex mMatchingMutex;
 	IgnoreMatcherManager mIgnoreMatcher;
 	App* mApp{ nullptr };
+	std::shared_ptr<ProjectSearchIndex> mSearchIndex;
 
 	void getDirectoryFiles( std::vector<std::string>& files, std::vector<std::string>& names,
 							std::string directory, std::set<std::string> currentDirs,
@@ -158,6 +189,10 @@ class ProjectDirectoryTree {
 
 	void removeFile( const FileInfo& file );
 
+	void syncSearchIndex();
+
+	void updateSearchIndex( const std::string& path );
+
 	IgnoreMatcherManager getIgnoreMatcherFromPath( const std::string& path );
 
 	size_t findFileIndex( const std::string& path );
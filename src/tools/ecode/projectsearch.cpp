@@ -1,139 +1,199 @@
 #include "projectsearch.hpp"
-#include <eepp/system/filesystem.hpp>
+#include <cctype>
+#include <cstring>
+#include <eepp/system/clock.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
 #include <eepp/system/luapattern.hpp>
 
 namespace ecode {
 
-static int countNewLines( const std::string& text, const size_t& start, const size_t& end ) {
-	const char* startPtr = text.c_str() + start;
-	const char* endPtr = text.c_str() + end;
-	size_t count = 0;
-	if ( startPtr != endPtr ) {
-		count = *startPtr == '\n' ? 1 : 0;
-		while ( ++startPtr && startPtr != endPtr ) {
-			if ( '\n' == *startPtr )
-				count++;
-		};
+/** Keeps track of the current line while the file is searched forward, so the new lines are only
+ * counted once. */
+struct LineTracker {
+	const char* data;
+	size_t pos{ 0 };
+	size_t line{ 0 };
+	size_t lineStart{ 0 };
+
+	LineTracker( const char* data ) : data( data ) {}
+
+	void advance( size_t to ) {
+		if ( to <= pos )
+			return;
+		const char* ptr = data + pos;
+		const char* end = data + to;
+		while ( ptr < end &&
+				( ptr = static_cast<const char*>( std::memchr( ptr, '\n', end - ptr ) ) ) ) {
+			line++;
+			lineStart = ptr - data + 1;
+			ptr++;
+		}
+		pos = to;
 	}
-	return count;
+};
+
+static size_t utf8Length( const char* start, const char* end ) {
+	size_t len = 0;
+	for ( ; start < end; ++start )
+		if ( ( *start & 0xC0 ) != 0x80 )
+			++len;
+	return len;
 }
 
-static String textLine( const std::string& fileText, const size_t& fromPos, size_t& relCol ) {
-	const char* stringStartPtr = fileText.c_str();
-	const char* startPtr = fileText.c_str() + fromPos;
-	const char* endPtr = startPtr;
-	const char* nlStartPtr = startPtr;
-	while ( nlStartPtr != stringStartPtr && *nlStartPtr != '\n' )
-		--nlStartPtr;
-	if ( *nlStartPtr == '\n' )
-		nlStartPtr++;
-	while ( ++endPtr && *endPtr != '\0' && *endPtr != '\n' ) {
-	}
-	relCol = String::utf8Length(
-		fileText.substr( nlStartPtr - stringStartPtr, startPtr - nlStartPtr ) );
+static String textLine( const char* data, const size_t& size, const size_t& lineStart,
+						const size_t& fromPos, size_t& relCol ) {
+	const char* lineEnd =
+		static_cast<const char*>( std::memchr( data + fromPos, '\n', size - fromPos ) );
+	size_t lineLength = ( lineEnd ? lineEnd - data : size ) - lineStart;
+	relCol = utf8Length( data + lineStart, data + fromPos );
 	// if the line to substract is massive we only get the fist kilobyte of that line, since the
 	// line is only shared for visual aid.
-	return fileText.substr( nlStartPtr - stringStartPtr,
-							endPtr - nlStartPtr > EE_1KB ? EE_1KB : endPtr - nlStartPtr );
+	lineLength = lineLength > EE_1KB ? EE_1KB : lineLength;
+	return String::fromUtf8( data + lineStart, data + lineStart + lineLength );
+}
+
+static bool isWholeWord( const char* data, const size_t& size, const size_t& pos,
+						 const size_t& len ) {
+	return ( 0 == pos || !std::isalnum( (unsigned char)data[pos - 1] ) ) &&
+		   ( pos + len >= size || !std::isalnum( (unsigned char)data[pos + len] ) );
+}
+
+static bool isCancelled( const ProjectSearch::CancelFlag& cancel ) {
+	return cancel && cancel->load( std::memory_order_relaxed );
 }
 
 static std::vector<ProjectSearch::ResultData::Result>
 searchInFileHorspool( const std::string& file, const std::string& text, const bool& caseSensitive,
-					  const bool& wholeWord, const String::BMH::OccTable& occ ) {
+					  const bool& wholeWord, const String::BMH::OccTable& occ,
+					  const ProjectSearch::CancelFlag& cancel ) {
 	std::vector<ProjectSearch::ResultData::Result> res;
-	std::string fileText;
-	Int64 lSearchRes = 0;
-	Int64 searchRes = 0;
-	size_t totNl = 0;
-	FileSystem::fileGet( file, fileText );
-	std::string fileTextOriginal;
+	IOStreamMappedFile stream( file );
+	if ( !stream.isOpen() || stream.getLength() == 0 || text.empty() )
+		return res;
 
-	if ( !caseSensitive ) {
-		fileTextOriginal = fileText;
-		String::toLowerInPlace( fileText );
-	}
+	const char* data = stream.getData();
+	const size_t size = stream.getLength();
+	const unsigned char* needle = reinterpret_cast<const unsigned char*>( text.data() );
+	const size_t textLength = String::utf8Length( text );
+	LineTracker lines( data );
+	size_t searchRes = 0;
 
-	do {
-		searchRes = String::BMH::find( fileText, text, searchRes, occ );
-		if ( searchRes != -1 ) {
-			if ( wholeWord && !String::isWholeWord( fileText, text, searchRes ) ) {
-				lSearchRes = searchRes;
-				searchRes += text.size();
-				continue;
-			}
-			size_t relCol;
-			totNl += countNewLines( fileText, lSearchRes, searchRes );
-			String str(
-				textLine( caseSensitive ? fileText : fileTextOriginal, searchRes, relCol ) );
-			res.push_back(
-				{ str,
-				  { { (Int64)totNl, (Int64)relCol },
-					{ (Int64)totNl, (Int64)( relCol + String::utf8Length( text ) ) } },
-				  searchRes,
-				  static_cast<Int64>( searchRes + text.size() ) } );
-			lSearchRes = searchRes;
+	while ( searchRes < size && !isCancelled( cancel ) ) {
+		const unsigned char* haystack = reinterpret_cast<const unsigned char*>( data ) + searchRes;
+		size_t found =
+			caseSensitive
+				? String::BMH::search( haystack, size - searchRes, needle, text.size(), occ )
+				: String::BMH::searchCaseInsensitive( haystack, size - searchRes, needle,
+													  text.size(), occ );
+		if ( found == size - searchRes )
+			break;
+		searchRes += found;
+		if ( wholeWord && !isWholeWord( data, size, searchRes, text.size() ) ) {
 			searchRes += text.size();
+			continue;
 		}
-	} while ( searchRes != -1 );
+		size_t relCol;
+		lines.advance( searchRes );
+		String str( textLine( data, size, lines.lineStart, searchRes, relCol ) );
+		res.push_back( { str,
+						 { { (Int64)lines.line, (Int64)relCol },
+						   { (Int64)lines.line, (Int64)( relCol + textLength ) } },
+						 (Int64)searchRes,
+						 static_cast<Int64>( searchRes + text.size() ) } );
+		searchRes += text.size();
+	}
 
 	return res;
 }
 
 static std::vector<ProjectSearch::ResultData::Result>
 searchInFileLuaPattern( const std::string& file, const std::string& text, const bool& caseSensitive,
-						const bool& wholeWord ) {
-	std::string fileText;
-	FileSystem::fileGet( file, fileText );
-	LuaPattern pattern( text );
+						const bool& wholeWord, const ProjectSearch::CancelFlag& cancel ) {
 	std::vector<ProjectSearch::ResultData::Result> res;
-	size_t totNl = 0;
-	bool matched = false;
-	Int64 searchRes = 0;
-	std::string fileTextOriginal;
+	IOStreamMappedFile stream( file );
+	if ( !stream.isOpen() || stream.getLength() == 0 )
+		return res;
 
+	// Patterns can't fold the case, so the case insensitive search still needs a lowercase copy
+	// to match against. The results are always extracted from the original text.
+	const char* data = stream.getData();
+	const size_t size = stream.getLength();
+	std::string lowerText;
 	if ( !caseSensitive ) {
-		fileTextOriginal = fileText;
-		String::toLowerInPlace( fileText );
+		lowerText.assign( data, size );
+		String::toLowerInPlace( lowerText );
 	}
+	const char* matchData = caseSensitive ? data : lowerText.data();
+
+	LuaPattern pattern( text );
+	LineTracker lines( data );
+	bool matched = false;
+	int searchRes = 0;
 
 	do {
 		int start, end = 0;
-		if ( ( matched = pattern.find( fileText, start, end, searchRes ) ) ) {
-			if ( wholeWord &&
-				 !String::isWholeWord( fileText, fileText.substr( start, end - start ), start ) ) {
+		if ( ( matched = pattern.find( matchData, start, end, searchRes, size ) ) ) {
+			if ( end <= searchRes && start == end ) {
+				// Empty match, move forward to avoid an infinite loop.
+				searchRes++;
+				continue;
+			}
+			if ( wholeWord && !isWholeWord( matchData, size, start, end - start ) ) {
 				searchRes = end;
 				continue;
 			}
 			size_t relCol;
-			totNl += countNewLines( fileText, searchRes, start );
-			String str( textLine( caseSensitive ? fileText : fileTextOriginal, start, relCol ) );
+			lines.advance( start );
+			String str( textLine( data, size, lines.lineStart, start, relCol ) );
 			int len = end - start;
-			res.push_back(
-				{ str,
-				  { { (Int64)totNl, (Int64)relCol }, { (Int64)totNl, (Int64)( relCol + len ) } },
-				  start,
-				  end } );
+			res.push_back( { str,
+							 { { (Int64)lines.line, (Int64)relCol },
+							   { (Int64)lines.line, (Int64)( relCol + len ) } },
+							 start,
+							 end } );
 			searchRes = end;
 		}
-	} while ( matched );
+	} while ( matched && searchRes < (int)size && !isCancelled( cancel ) );
 
 	return res;
 }
 
-void ProjectSearch::find( const std::vector<std::string> files, const std::string& string,
+static std::vector<ProjectSearch::ResultData::Result>
+searchInFile( const std::string& file, const std::string& text, const bool& caseSensitive,
+			  const bool& wholeWord, const TextDocument::FindReplaceType& type,
+			  const String::BMH::OccTable& occ, const ProjectSearch::CancelFlag& cancel ) {
+	return type == TextDocument::FindReplaceType::Normal
+			   ? searchInFileHorspool( file, text, caseSensitive, wholeWord, occ, cancel )
+			   : searchInFileLuaPattern( file, text, caseSensitive, wholeWord, cancel );
+}
+
+static String::BMH::OccTable createOccTable( const std::string& text, const bool& caseSensitive,
+											 const TextDocument::FindReplaceType& type ) {
+	if ( type != TextDocument::FindReplaceType::Normal )
+		return {};
+	return caseSensitive ? String::BMH::createOccTable(
+							   (const unsigned char*)text.c_str(), text.size() )
+						 : String::BMH::createCaseInsensitiveOccTable(
+							   (const unsigned char*)text.c_str(), text.size() );
+}
+
+void ProjectSearch::find( const std::vector<std::string> files, std::string string,
 						  ResultCb result, bool caseSensitive, bool wholeWord,
-						  const TextDocument::FindReplaceType& type ) {
+						  const TextDocument::FindReplaceType& type, ResultCb partialResult,
+						  CancelFlag cancel ) {
 	Result res;
-	const auto occ =
-		type == TextDocument::FindReplaceType::Normal
-			? String::BMH::createOccTable( (const unsigned char*)string.c_str(), string.size() )
-			: std::vector<size_t>();
+	if ( !caseSensitive )
+		String::toLowerInPlace( string );
+	const auto occ = createOccTable( string, caseSensitive, type );
 	for ( auto& file : files ) {
-		auto fileRes = type == TextDocument::FindReplaceType::Normal
-						   ? searchInFileHorspool( file, string, caseSensitive, wholeWord, occ )
-						   : searchInFileLuaPattern( file, string, caseSensitive, wholeWord );
-		if ( !fileRes.empty() )
+		if ( isCancelled( cancel ) )
+			break;
+		auto fileRes = searchInFile( file, string, caseSensitive, wholeWord, type, occ, cancel );
+		if ( !fileRes.empty() ) {
 			res.push_back( { file, fileRes } );
+			if ( partialResult )
+				partialResult( { res.back() } );
+		}
 	}
 	result( res );
 }
@@ -143,31 +203,50 @@ struct FindData {
 	Mutex countMutex;
 	int resCount{ 0 };
 	ProjectSearch::Result res;
+	size_t streamedCount{ 0 };
+	Clock lastStream;
 };
 
 void ProjectSearch::find( const std::vector<std::string> files, std::string string,
 						  std::shared_ptr<ThreadPool> pool, ResultCb result, bool caseSensitive,
-						  bool wholeWord, const TextDocument::FindReplaceType& type ) {
-	if ( files.empty() )
+						  bool wholeWord, const TextDocument::FindReplaceType& type,
+						  ResultCb partialResult, CancelFlag cancel ) {
+	if ( files.empty() ) {
 		result( {} );
+		return;
+	}
 	FindData* findData = eeNew( FindData, () );
 	findData->resCount = files.size();
 	if ( !caseSensitive )
 		String::toLowerInPlace( string );
-	const auto occ =
-		type == TextDocument::FindReplaceType::Normal
-			? String::BMH::createOccTable( (const unsigned char*)string.c_str(), string.size() )
-			: std::vector<size_t>();
+	const auto occ = createOccTable( string, caseSensitive, type );
 	for ( auto& file : files ) {
 		pool->run(
-			[findData, file, string, caseSensitive, wholeWord, occ, type] {
+			[findData, file, string, caseSensitive, wholeWord, occ, type, partialResult,
+			 cancel] {
+				if ( isCancelled( cancel ) )
+					return;
 				auto fileRes =
-					type == TextDocument::FindReplaceType::Normal
-						? searchInFileHorspool( file, string, caseSensitive, wholeWord, occ )
-						: searchInFileLuaPattern( file, string, caseSensitive, wholeWord );
-				if ( !fileRes.empty() ) {
+					searchInFile( file, string, caseSensitive, wholeWord, type, occ, cancel );
+				if ( fileRes.empty() || isCancelled( cancel ) )
+					return;
+				Result stream;
+				{
 					Lock l( findData->resMutex );
 					findData->res.push_back( { file, fileRes } );
+					// The first results are delivered immediately, then they are sent in batches
+					// to avoid flooding the receiver.
+					if ( partialResult && ( findData->streamedCount == 0 ||
+											findData->lastStream.getElapsedTime().asMilliseconds() >
+												100 ) ) {
+						stream.assign( findData->res.begin() + findData->streamedCount,
+									   findData->res.end() );
+						findData->streamedCount = findData->res.size();
+						findData->lastStream.restart();
+						// The partial results must be received in order, so they are delivered
+						// while the lock is held.
+						partialResult( stream );
+					}
 				}
 			},
 			[result, findData] {
@@ -1,6 +1,7 @@
 #ifndef ECODE_PROJECTSEARCH_HPP
 #define ECODE_PROJECTSEARCH_HPP
 
+#include <atomic>
 #include <eepp/core/string.hpp>
 #include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
@@ -57,6 +58,8 @@ class ProjectSearch {
 
 	typedef std::vector<ResultData> Result;
 	typedef std::function<void( const Result& )> ResultCb;
+	/** Shared flag used to cancel a running search. */
+	typedef std::shared_ptr<std::atomic<bool>> CancelFlag;
 
 	class ResultModel : public Model {
 	  public:
@@ -185,6 +188,17 @@ class ProjectSearch {
 
 		const Result& getResult() const { return mResult; }
 
+		void setResult( const Result& result ) {
+			mResult = result;
+			onModelUpdate();
+		}
+
+		/** Appends the results of more files (used to stream the results of a running search). */
+		void addResults( const Result& result ) {
+			mResult.insert( mResult.end(), result.begin(), result.end() );
+			onModelUpdate( UpdateFlag::RowsAppended );
+		}
+
 	  protected:
 		Result mResult;
 	};
@@ -193,16 +207,24 @@ class ProjectSearch {
 		return std::make_shared<ResultModel>( result );
 	}
 
+	/** Searches the string in the files.
+	 * @param result Called once the search finished (or it was cancelled) with all the results.
+	 * @param partialResult Optional, called with the results of the files searched since the
+	 * last call while the search is running. The results are streamed in the same order they are
+	 * reported later to the result callback.
+	 * @param cancel Optional, setting it to true aborts the search as soon as possible. */
 	static void
-	find( const std::vector<std::string> files, const std::string& string, ResultCb result,
+	find( const std::vector<std::string> files, std::string string, ResultCb result,
 		  bool caseSensitive, bool wholeWord = false,
-		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal );
+		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal,
+		  ResultCb partialResult = nullptr, CancelFlag cancel = nullptr );
 
 	static void
 	find( const std::vector<std::string> files, std::string string,
 		  std::shared_ptr<ThreadPool> pool, ResultCb result, bool caseSensitive,
 		  bool wholeWord = false,
-		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal );
+		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal,
+		  ResultCb partialResult = nullptr, CancelFlag cancel = nullptr );
 };
 
 } // namespace ecode
@@ -0,0 +1,510 @@
+#include "projectsearchindex.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <eepp/core/string.hpp>
+#include <eepp/system/fileinfo.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/log.hpp>
+#include <unordered_set>
+
+namespace ecode {
+
+static constexpr Uint32 INDEX_MAGIC = ( 'E' << 0 ) | ( 'C' << 8 ) | ( 'T' << 16 ) | ( 'I' << 24 );
+static constexpr Uint32 INDEX_VERSION = 1;
+static constexpr Uint32 TRIGRAMS_COUNT = 1 << 24;
+
+static inline unsigned char asciiLower( unsigned char c ) {
+	return c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c;
+}
+
+static inline Uint32 makeTrigram( unsigned char a, unsigned char b, unsigned char c ) {
+	return ( (Uint32)asciiLower( a ) << 16 ) | ( (Uint32)asciiLower( b ) << 8 ) | asciiLower( c );
+}
+
+/** Collects the unique trigrams of the data. The bit set is used to discard the repeated
+ * trigrams, and it's left cleared on return so it can be reused. */
+static void extractTrigrams( const char* data, size_t size, std::vector<Uint64>& seen,
+							 std::vector<Uint32>& trigrams ) {
+	trigrams.clear();
+	if ( size < 3 )
+		return;
+	if ( seen.size() != TRIGRAMS_COUNT / 64 )
+		seen.assign( TRIGRAMS_COUNT / 64, 0 );
+	const unsigned char* ptr = reinterpret_cast<const unsigned char*>( data );
+	Uint32 trigram = ( (Uint32)asciiLower( ptr[0] ) << 8 ) | asciiLower( ptr[1] );
+	for ( size_t i = 2; i < size; ++i ) {
+		trigram = ( ( trigram << 8 ) | asciiLower( ptr[i] ) ) & ( TRIGRAMS_COUNT - 1 );
+		Uint64& word = seen[trigram >> 6];
+		Uint64 bit = (Uint64)1 << ( trigram & 63 );
+		if ( !( word & bit ) ) {
+			word |= bit;
+			trigrams.push_back( trigram );
+		}
+	}
+	for ( const auto& t : trigrams )
+		seen[t >> 6] = 0;
+	std::sort( trigrams.begin(), trigrams.end() );
+}
+
+static void writeU32( std::string& out, Uint32 val ) {
+	out.append( reinterpret_cast<const char*>( &val ), sizeof( val ) );
+}
+
+static void writeU64( std::string& out, Uint64 val ) {
+	out.append( reinterpret_cast<const char*>( &val ), sizeof( val ) );
+}
+
+static void writeVarint( std::string& out, Uint32 val ) {
+	while ( val >= 0x80 ) {
+		out.push_back( static_cast<char>( ( val & 0x7F ) | 0x80 ) );
+		val >>= 7;
+	}
+	out.push_back( static_cast<char>( val ) );
+}
+
+namespace {
+
+struct IndexReader {
+	const char* ptr;
+	const char* end;
+	bool ok{ true };
+
+	template <typename T> T read() {
+		T val{};
+		if ( end - ptr < (ptrdiff_t)sizeof( T ) ) {
+			ok = false;
+			return val;
+		}
+		memcpy( &val, ptr, sizeof( T ) );
+		ptr += sizeof( T );
+		return val;
+	}
+
+	Uint32 readVarint() {
+		Uint32 val = 0;
+		for ( int shift = 0; shift < 35; shift += 7 ) {
+			if ( ptr >= end ) {
+				ok = false;
+				return 0;
+			}
+			unsigned char byte = *ptr++;
+			val |= (Uint32)( byte & 0x7F ) << shift;
+			if ( !( byte & 0x80 ) )
+				return val;
+		}
+		ok = false;
+		return 0;
+	}
+
+	std::string readString() {
+		Uint32 len = readVarint();
+		if ( !ok || end - ptr < (ptrdiff_t)len ) {
+			ok = false;
+			return {};
+		}
+		std::string str( ptr, len );
+		ptr += len;
+		return str;
+	}
+};
+
+} // namespace
+
+ProjectSearchIndex::ProjectSearchIndex( const std::string& cachePath ) : mCachePath( cachePath ) {}
+
+void ProjectSearchIndex::sync( const std::vector<std::string>& files ) {
+	// The syncs are serialized, a second sync must not load the persisted index over the files
+	// added by the first one.
+	Lock sl( mSyncMutex );
+
+	if ( mCancelled )
+		return;
+
+	if ( !mLoaded ) {
+		load();
+		mLoaded = true;
+	}
+
+	// First pass only compares the file stats, so a persisted index is ready to be used almost
+	// immediately. Files that changed are kept as non-indexed (always candidates) until they are
+	// read in the second pass.
+	// Only the files known before the sync can be removed, files added meanwhile by the file
+	// system watcher must be kept.
+	std::vector<std::string> knownFiles;
+	{
+		Lock l( mMutex );
+		knownFiles.reserve( mFileIds.size() );
+		for ( const auto& file : mFileIds )
+			knownFiles.emplace_back( file.first );
+	}
+
+	std::vector<std::string> pending;
+	for ( const auto& path : files ) {
+		if ( mCancelled )
+			return;
+		FileInfo info( path );
+		Lock l( mMutex );
+		auto it = mFileIds.find( path );
+		if ( it != mFileIds.end() ) {
+			FileEntry& entry = mFiles[it->second];
+			if ( entry.indexed && entry.modificationTime == info.getModificationTime() &&
+				 entry.size == info.getSize() )
+				continue;
+			entry.indexed = false;
+		} else {
+			addFile( path, 0, 0, false, {} );
+		}
+		pending.emplace_back( path );
+	}
+
+	{
+		std::unordered_set<std::string> present( files.begin(), files.end() );
+		Lock l( mMutex );
+		for ( const auto& path : knownFiles )
+			if ( present.find( path ) == present.end() )
+				killFile( path );
+	}
+
+	mReady = true;
+
+	for ( const auto& path : pending ) {
+		if ( mCancelled )
+			return;
+		updateFile( path );
+	}
+
+	{
+		Lock l( mMutex );
+		compact();
+	}
+
+	if ( isDirty() )
+		save();
+}
+
+void ProjectSearchIndex::updateFile( const std::string& path ) {
+	FileInfo info( path );
+	if ( !info.exists() ) {
+		removeFile( path );
+		return;
+	}
+
+	std::vector<Uint32> trigrams;
+	bool indexed = false;
+	if ( info.getSize() <= MaxIndexedFileSize ) {
+		IOStreamMappedFile file( path );
+		if ( file.isOpen() ) {
+			static thread_local std::vector<Uint64> seen;
+			extractTrigrams( file.getData(), file.getLength(), seen, trigrams );
+			indexed = true;
+		}
+	}
+
+	Lock l( mMutex );
+	addFile( path, info.getModificationTime(), info.getSize(), indexed, trigrams );
+}
+
+void ProjectSearchIndex::invalidateFile( const std::string& path ) {
+	Lock l( mMutex );
+	auto it = mFileIds.find( path );
+	if ( it != mFileIds.end() ) {
+		mFiles[it->second].indexed = false;
+		mDirty = true;
+	} else {
+		addFile( path, 0, 0, false, {} );
+	}
+}
+
+void ProjectSearchIndex::removeFile( const std::string& path ) {
+	Lock l( mMutex );
+	killFile( path );
+}
+
+bool ProjectSearchIndex::hasFile( const std::string& path ) const {
+	Lock l( mMutex );
+	return mFileIds.find( path ) != mFileIds.end();
+}
+
+void ProjectSearchIndex::renameFile( const std::string& oldPath, const std::string& newPath ) {
+	Lock l( mMutex );
+	auto it = mFileIds.find( oldPath );
+	if ( it == mFileIds.end() )
+		return;
+	Uint32 id = it->second;
+	mFileIds.erase( it );
+	killFile( newPath );
+	mFiles[id].path = newPath;
+	mFileIds[newPath] = id;
+	mDirty = true;
+}
+
+void ProjectSearchIndex::removeDirectory( const std::string& dirPath ) {
+	Lock l( mMutex );
+	std::vector<std::string> paths;
+	for ( const auto& file : mFileIds )
+		if ( String::startsWith( file.first, dirPath ) )
+			paths.emplace_back( file.first );
+	for ( const auto& path : paths )
+		killFile( path );
+}
+
+void ProjectSearchIndex::renameDirectory( const std::string& oldDirPath,
+										  const std::string& newDirPath ) {
+	std::vector<std::string> paths;
+	{
+		Lock l( mMutex );
+		for ( const auto& file : mFileIds )
+			if ( String::startsWith( file.first, oldDirPath ) )
+				paths.emplace_back( file.first );
+	}
+	for ( const auto& path : paths )
+		renameFile( path, newDirPath + path.substr( oldDirPath.size() ) );
+}
+
+bool ProjectSearchIndex::findCandidates( const std::string& text, bool caseSensitive,
+										 std::vector<std::string>& candidates ) const {
+	if ( !mReady || text.size() < 3 )
+		return false;
+
+	std::vector<Uint32> trigrams;
+	const unsigned char* ptr = reinterpret_cast<const unsigned char*>( text.data() );
+	for ( size_t i = 0; i + 2 < text.size(); ++i ) {
+		// Non-ASCII characters can have a different case folding, only ASCII trigrams are used
+		// in case insensitive searches.
+		if ( !caseSensitive && ( ptr[i] >= 0x80 || ptr[i + 1] >= 0x80 || ptr[i + 2] >= 0x80 ) )
+			continue;
+		trigrams.push_back( makeTrigram( ptr[i], ptr[i + 1], ptr[i + 2] ) );
+	}
+	std::sort( trigrams.begin(), trigrams.end() );
+	trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+	if ( trigrams.empty() )
+		return false;
+
+	Lock l( mMutex );
+	std::vector<const std::vector<Uint32>*> lists;
+	bool missing = false;
+	for ( const auto& trigram : trigrams ) {
+		auto it = mPostings.find( trigram );
+		if ( it == mPostings.end() ) {
+			missing = true;
+			break;
+		}
+		lists.push_back( &it->second );
+	}
+
+	std::vector<Uint32> ids;
+	if ( !missing ) {
+		std::sort( lists.begin(), lists.end(),
+				   []( const auto* a, const auto* b ) { return a->size() < b->size(); } );
+		ids = *lists[0];
+		std::vector<Uint32> tmp;
+		for ( size_t i = 1; i < lists.size() && !ids.empty(); ++i ) {
+			tmp.clear();
+			std::set_intersection( ids.begin(), ids.end(), lists[i]->begin(), lists[i]->end(),
+								   std::back_inserter( tmp ) );
+			ids.swap( tmp );
+		}
+	}
+
+	candidates.clear();
+	for ( const auto& id : ids ) {
+		const FileEntry& entry = mFiles[id];
+		if ( entry.alive && entry.indexed )
+			candidates.emplace_back( entry.path );
+	}
+	for ( const auto& entry : mFiles ) {
+		if ( entry.alive && !entry.indexed )
+			candidates.emplace_back( entry.path );
+	}
+	return true;
+}
+
+bool ProjectSearchIndex::isReady() const {
+	return mReady;
+}
+
+void ProjectSearchIndex::cancel() {
+	mCancelled = true;
+}
+
+bool ProjectSearchIndex::isDirty() const {
+	Lock l( mMutex );
+	return mDirty;
+}
+
+size_t ProjectSearchIndex::getFilesCount() const {
+	Lock l( mMutex );
+	return mFiles.size() - mDeadFiles;
+}
+
+void ProjectSearchIndex::killFile( const std::string& path ) {
+	auto it = mFileIds.find( path );
+	if ( it == mFileIds.end() )
+		return;
+	FileEntry& entry = mFiles[it->second];
+	if ( entry.alive ) {
+		entry.alive = false;
+		mDeadFiles++;
+	}
+	mFileIds.erase( it );
+	mDirty = true;
+}
+
+void ProjectSearchIndex::addFile( const std::string& path, Uint64 modificationTime, Uint64 size,
+								  bool indexed, const std::vector<Uint32>& trigrams ) {
+	killFile( path );
+	Uint32 id = static_cast<Uint32>( mFiles.size() );
+	mFiles.push_back( { path, modificationTime, size, true, indexed } );
+	mFileIds[path] = id;
+	// Ids are always increasing, so the posting lists are kept sorted.
+	for ( const auto& trigram : trigrams )
+		mPostings[trigram].push_back( id );
+	mDirty = true;
+	if ( mDeadFiles > 1024 && mDeadFiles > mFiles.size() / 2 )
+		compact();
+}
+
+void ProjectSearchIndex::compact() {
+	if ( mDeadFiles == 0 )
+		return;
+	std::vector<Uint32> remap( mFiles.size(), 0 );
+	std::vector<FileEntry> files;
+	files.reserve( mFiles.size() - mDeadFiles );
+	for ( size_t i = 0; i < mFiles.size(); ++i ) {
+		if ( mFiles[i].alive ) {
+			remap[i] = static_cast<Uint32>( files.size() );
+			files.emplace_back( std::move( mFiles[i] ) );
+		}
+	}
+	for ( auto it = mPostings.begin(); it != mPostings.end(); ) {
+		std::vector<Uint32>& ids = it->second;
+		size_t count = 0;
+		for ( const auto& id : ids )
+			if ( mFiles[id].alive )
+				ids[count++] = remap[id];
+		ids.resize( count );
+		if ( ids.empty() ) {
+			it = mPostings.erase( it );
+		} else {
+			ids.shrink_to_fit();
+			++it;
+		}
+	}
+	mFiles = std::move( files );
+	mFileIds.clear();
+	for ( size_t i = 0; i < mFiles.size(); ++i )
+		mFileIds[mFiles[i].path] = static_cast<Uint32>( i );
+	mDeadFiles = 0;
+}
+
+bool ProjectSearchIndex::load() {
+	if ( mCachePath.empty() || !FileSystem::fileExists( mCachePath ) )
+		return false;
+
+	std::string data;
+	if ( !FileSystem::fileGet( mCachePath, data ) )
+		return false;
+
+	IndexReader reader{ data.data(), data.data() + data.size() };
+	if ( reader.read<Uint32>() != INDEX_MAGIC || reader.read<Uint32>() != INDEX_VERSION )
+		return false;
+
+	std::vector<FileEntry> files( reader.read<Uint32>() );
+	for ( auto& file : files ) {
+		if ( !reader.ok )
+			break;
+		file.path = reader.readString();
+		file.modificationTime = reader.read<Uint64>();
+		file.size = reader.read<Uint64>();
+		file.indexed = reader.read<Uint8>() != 0;
+		file.alive = true;
+	}
+
+	std::unordered_map<Uint32, std::vector<Uint32>> postings;
+	Uint32 postingsCount = reader.read<Uint32>();
+	for ( Uint32 i = 0; i < postingsCount && reader.ok; ++i ) {
+		Uint32 trigram = reader.read<Uint32>();
+		Uint32 count = reader.readVarint();
+		if ( !reader.ok || count > files.size() ) {
+			reader.ok = false;
+			break;
+		}
+		std::vector<Uint32>& ids = postings[trigram];
+		ids.reserve( count );
+		Uint32 id = 0;
+		for ( Uint32 c = 0; c < count; ++c ) {
+			id += reader.readVarint();
+			if ( id >= files.size() ) {
+				reader.ok = false;
+				break;
+			}
+			ids.push_back( id );
+		}
+	}
+
+	if ( !reader.ok ) {
+		Log::warning( "ProjectSearchIndex: invalid index cache %s", mCachePath.c_str() );
+		return false;
+	}
+
+	Lock l( mMutex );
+	mFiles = std::move( files );
+	mPostings = std::move( postings );
+	mFileIds.clear();
+	for ( size_t i = 0; i < mFiles.size(); ++i )
+		mFileIds[mFiles[i].path] = static_cast<Uint32>( i );
+	mDeadFiles = 0;
+	mDirty = false;
+	return true;
+}
+
+bool ProjectSearchIndex::save() {
+	if ( mCachePath.empty() )
+		return false;
+
+	// The index can be saved from the sync and from its owner at the same time, both write the
+	// same temporary file.
+	Lock sl( mSaveMutex );
+
+	std::string data;
+	{
+		Lock l( mMutex );
+		compact();
+		writeU32( data, INDEX_MAGIC );
+		writeU32( data, INDEX_VERSION );
+		writeU32( data, static_cast<Uint32>( mFiles.size() ) );
+		for ( const auto& file : mFiles ) {
+			writeVarint( data, static_cast<Uint32>( file.path.size() ) );
+			data.append( file.path );
+			writeU64( data, file.modificationTime );
+			writeU64( data, file.size );
+			data.push_back( file.indexed ? 1 : 0 );
+		}
+		writeU32( data, static_cast<Uint32>( mPostings.size() ) );
+		for ( const auto& posting : mPostings ) {
+			writeU32( data, posting.first );
+			writeVarint( data, static_cast<Uint32>( posting.second.size() ) );
+			Uint32 prev = 0;
+			for ( const auto& id : posting.second ) {
+				writeVarint( data, id - prev );
+				prev = id;
+			}
+		}
+		mDirty = false;
+	}
+
+	std::string dir( FileSystem::fileRemoveFileName( mCachePath ) );
+	if ( !dir.empty() && !FileSystem::fileExists( dir ) )
+		FileSystem::makeDir( dir, true );
+
+	std::string tmpPath( mCachePath + ".tmp" );
+	if ( !FileSystem::fileWrite( tmpPath, data ) )
+		return false;
+	FileSystem::fileRemove( mCachePath );
+	return std::rename( tmpPath.c_str(), mCachePath.c_str() ) == 0;
+}
+
+} // namespace ecode
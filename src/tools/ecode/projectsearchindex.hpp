@@ -0,0 +1,105 @@
+#ifndef ECODE_PROJECTSEARCHINDEX_HPP
+#define ECODE_PROJECTSEARCHINDEX_HPP
+
+#include <atomic>
+#include <eepp/config.hpp>
+#include <eepp/system/mutex.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace EE;
+using namespace EE::System;
+
+namespace ecode {
+
+/** @brief Trigram index of the project files contents.
+**	Every file is decomposed in the set of trigrams (three consecutive bytes, ASCII lowercased)
+**	that it contains, and the index keeps, for each trigram, the sorted list of the files that
+**	contain it. A search for a literal string only needs to verify the files that contain all the
+**	trigrams of the string. The index can be persisted, and after a reload only the files that
+**	changed since it was saved need to be read again. */
+class ProjectSearchIndex {
+  public:
+	/** Files bigger than this size are not indexed, they are always considered candidates. */
+	static constexpr Uint64 MaxIndexedFileSize = 8 * EE_1MB;
+
+	ProjectSearchIndex( const std::string& cachePath = "" );
+
+	/** Synchronizes the index with the project files: new and modified files are indexed and
+	 * the files that are not part of the project anymore are removed. The persisted index is
+	 * loaded first if the index is empty. */
+	void sync( const std::vector<std::string>& files );
+
+	/** Reads and indexes the file again. */
+	void updateFile( const std::string& path );
+
+	/** Marks the file as not indexed, so it's considered a candidate until it's updated. */
+	void invalidateFile( const std::string& path );
+
+	void removeFile( const std::string& path );
+
+	bool hasFile( const std::string& path ) const;
+
+	void renameFile( const std::string& oldPath, const std::string& newPath );
+
+	/** Removes all the files inside the directory. */
+	void removeDirectory( const std::string& dirPath );
+
+	/** Renames all the files inside the directory. */
+	void renameDirectory( const std::string& oldDirPath, const std::string& newDirPath );
+
+	/** @return True if the index is able to narrow the search and the candidates were filled.
+	 * The candidates are the files that may contain the text, they must still be verified. */
+	bool findCandidates( const std::string& text, bool caseSensitive,
+						 std::vector<std::string>& candidates ) const;
+
+	bool isReady() const;
+
+	/** Stops the running sync as soon as possible. The index is not synced anymore after being
+	 * cancelled, it's meant to be called when the project is closed. */
+	void cancel();
+
+	bool load();
+
+	bool save();
+
+	/** @return True if the index changed since it was loaded or saved. */
+	bool isDirty() const;
+
+	size_t getFilesCount() const;
+
+  protected:
+	struct FileEntry {
+		std::string path;
+		Uint64 modificationTime{ 0 };
+		Uint64 size{ 0 };
+		bool alive{ false };
+		bool indexed{ false };
+	};
+
+	std::string mCachePath;
+	mutable Mutex mMutex;
+	Mutex mSyncMutex;
+	Mutex mSaveMutex;
+	std::vector<FileEntry> mFiles;
+	std::unordered_map<std::string, Uint32> mFileIds;
+	std::unordered_map<Uint32, std::vector<Uint32>> mPostings;
+	size_t mDeadFiles{ 0 };
+	std::atomic<bool> mReady{ false };
+	std::atomic<bool> mCancelled{ false };
+	bool mDirty{ false };
+	std::atomic<bool> mLoaded{ false };
+
+	/** Removes the file from the index, the posting lists are cleaned on the next compaction. */
+	void killFile( const std::string& path );
+
+	void addFile( const std::string& path, Uint64 modificationTime, Uint64 size, bool indexed,
+				  const std::vector<Uint32>& trigrams );
+
+	void compact();
+};
+
+} // namespace ecode
+
+#endif // ECODE_PROJECTSEARCHINDEX_HPP
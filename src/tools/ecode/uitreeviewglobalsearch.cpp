@@ -160,7 +160,7 @@ UIPushButton* UITreeViewCellGlobalSearch::updateText( const std::string& text )
 
 		size_t start = to;
 		for ( auto& token : tokens ) {
-			size_t strSize = String::fromUtf8( token.text ).size();
+			size_t strSize = String::utf8Length( text.substr( token.pos, token.len ) );
 			mTextBox->setFontFillColor( pp->getColorScheme().getSyntaxStyle( token.type ).color,
 										start, start + strSize );
 			start += strSize;